@@ -34,4 +34,7 @@ struct unexpectedEngineReply  : public std::runtime_error
 ///Engines need some time between closing and starting to avoid problems with shared memory
 #define ENGINE_COOLDOWN 50
 
+///How many milliseconds between two runs of EngineSync::process if nothing wakes it up earlier?
+#define ENGINE_WATCHDOG_INTERVAL 250
+
 #endif // ENGINEDEFINITIONS_H
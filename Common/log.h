@@ -38,6 +38,7 @@ public:
 	static std::string	whereStr() { return logTypeToString(_where); }
 
 	static bool			toCout() { return _where == logType::cout; }
+	static bool			isActive() { return _where != logType::null; }	///< False when everything goes to the null stream, check this before formatting anything expensive for the log
 
 private:
 						Log() { }
@@ -54,6 +54,7 @@ public:
 	static std::string	createTmpFolder();
 
 	static std::string	sessionDirName() { return _sessionDirName; }
+	static long			sessionId()		 { return _sessionId; }
 	static stringvec	retrieveList(int id = -1);
 
 	static void			deleteList(const stringvec &files);
@@ -81,6 +81,14 @@ void Column::dbLoadIndex(int index, bool getValues)
 	dbLoad(_id, getValues);
 }
 
+void Column::dbLoadValues()
+{
+	JASPTIMER_SCOPE(Column::dbLoadValues);
+
+	db().columnGetValues(_id, _ints, _dbls);
+	labelsTempReset();
+}
+
 void Column::dbDelete(bool cleanUpRest)
 {
 	assert(_id != -1);
@@ -510,6 +518,100 @@ columnType Column::setValues(const stringvec & values, const stringvec & labels,
 	
 	dbUpdateValues(false);
 	
+	return _suggestColumnType(onlyInts, onlyDoubles, ints, thresholdScale);
+}
+
+columnType Column::setValues(const doublevec & dbls, const intvec & labelIndices, const stringvec & labelDictionary, bool onlyInts, int thresholdScale, bool * aChange)
+{
+	JASPTIMER_SCOPE(Column::setValues typed);
+
+	assert(dbls.size() == labelIndices.size());
+
+	if(aChange && _dbls.size() != dbls.size())
+		(*aChange) = true;
+
+	_dbls.resize(dbls.size());
+	_ints.resize(dbls.size());
+
+	//This does the same as setValue(row, value, label) would do on a fresh column, but without going through the strings:
+	//a double is stored as is and every other value gets a label, that is created the first time it is encountered.
+	intvec		labelIdForIndex(labelDictionary.size(), Label::DOUBLE_LABEL_VALUE);
+	doublevec	labelDblForIndex(labelDictionary.size(), EmptyValues::missingValueDouble); //A label for a number keeps that number in _dbls, like setValue does
+	intset		ints;
+	int		tmpInt;
+
+	for(size_t row=0; row<dbls.size(); row++)
+	{
+		int		newInt = Label::DOUBLE_LABEL_VALUE;
+		double	newDbl = dbls[row];
+
+		if(labelIndices[row] >= 0)
+		{
+			int & labelId = labelIdForIndex[labelIndices[row]];
+
+			if(labelId == Label::DOUBLE_LABEL_VALUE)
+			{
+				const std::string & value	= labelDictionary[labelIndices[row]];
+				Label			  * label	= labelByValue(value);
+				labelId						= label ? label->intsId() : labelsAdd(value, "", value);
+
+				if(label && label->originalValue().isDouble())
+					labelDblForIndex[labelIndices[row]] = label->originalValue().asDouble();
+			}
+
+			newInt = labelId;
+			newDbl = labelDblForIndex[labelIndices[row]];
+		}
+		else if(onlyInts && ints.size() <= thresholdScale && !std::isnan(newDbl) && ColumnUtils::getIntValue(newDbl, tmpInt))
+			ints.insert(tmpInt);
+
+		if(aChange && (_ints[row] != newInt || !Utils::isEqual(_dbls[row], newDbl)))
+			(*aChange) = true;
+
+		_ints[row] = newInt;
+		_dbls[row] = newDbl;
+	}
+
+	labelsTempReset();
+
+	if(labelsRemoveOrphans() && aChange)
+		(*aChange) = true;
+
+	dbUpdateValues(false);
+
+	return _suggestColumnType(onlyInts, labelDictionary.empty(), ints, thresholdScale);
+}
+
+void Column::setValuesFrom(size_t firstRow, const stringvec & values)
+{
+	JASPTIMER_SCOPE(Column::setValuesFrom);
+
+	if(firstRow + values.size() > _dbls.size())
+		throw std::runtime_error("Column::setValuesFrom got more values than the column has rows");
+
+	//What setValue makes of a string only depends on the labels and not on what was in the row before, and any label it adds is found by the next lookup
+	std::unordered_map<std::string, size_t> rowForValue;
+
+	for(size_t i=0; i<values.size(); i++)
+	{
+		const size_t	row		= firstRow + i;
+		auto			found	= rowForValue.find(values[i]);
+
+		if(found != rowForValue.end())
+		{
+			_ints[row] = _ints[found->second];
+			_dbls[row] = _dbls[found->second];
+		}
+		else
+		{
+			setValue(row, values[i], "", false);
+			rowForValue[values[i]] = row;
+		}
+	}
+}
+
+columnType Column::_suggestColumnType(bool onlyInts, bool onlyDoubles, const intset & ints, int thresholdScale) const
+{
 	//Now determine what the most logical columntype would be given the current values AND empty values!
 	if(onlyInts && ints.size() <= thresholdScale && ints.size() > 0)
 	{
@@ -621,7 +723,91 @@ bool Column::overwriteDataAndType(stringvec data, columnType colType)
 	return changes;
 }
 
-void Column::_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease)
+bool Column::overwriteDataAndType(doublevec dbls, intvec levelIndices, const stringvec & levels, columnType colType)
+{
+	JASPTIMER_SCOPE(Column::overwriteDataAndType typed);
+
+	if(levelIndices.size() != dbls.size())
+		levelIndices.assign(dbls.size(), -1);
+
+	if(dbls.size() != _data->rowCount())
+	{
+		if(dbls.size() == _data->filter()->filteredRowCount())
+		{
+			const boolvec	&	filtered = _data->filter()->filtered();
+			doublevec			newDbls(filtered.size(), EmptyValues::missingValueDouble);
+			intvec				newIndices(filtered.size(), -1);
+
+			for(size_t iFilter=0, iData=0; iFilter < filtered.size() && iData < dbls.size(); iFilter++)
+				if(filtered[iFilter])
+				{
+					newDbls[iFilter]	= dbls[iData];
+					newIndices[iFilter]	= levelIndices[iData++];
+				}
+
+			dbls			= std::move(newDbls);
+			levelIndices	= std::move(newIndices);
+		}
+		else
+		{
+			dbls		 .resize(_data->rowCount(), EmptyValues::missingValueDouble);
+			levelIndices .resize(_data->rowCount(), -1);
+		}
+	}
+
+	//The strings version would turn a level that looks like a number into that number, and an empty one into a missing value
+	doublevec	levelAsDouble(levels.size(), EmptyValues::missingValueDouble);
+	boolvec		levelIsDouble(levels.size(), false);
+
+	for(size_t level=0; level<levels.size(); level++)
+		levelIsDouble[level] = levels[level] == "" || ColumnUtils::getDoubleValue(levels[level], levelAsDouble[level]);
+
+	stringvec						dictionary	= levels;
+	std::map<double, int>			labelledDoubles;
+	const bool						hasLabels	= _labels.size() > 0;
+
+	for(size_t row=0; row<dbls.size(); row++)
+	{
+		int & index = levelIndices[row];
+
+		if(index >= 0 && levelIsDouble[index])
+		{
+			dbls[row]	= levelAsDouble[index];
+			index		= -1;
+		}
+
+		//A value that already has a label keeps it, just like the strings version does, but only the columns that have labels pay for this
+		if(index < 0 && hasLabels && !std::isnan(dbls[row]))
+		{
+			auto labelled = labelledDoubles.find(dbls[row]);
+
+			if(labelled == labelledDoubles.end())
+			{
+				const std::string	asString	= ColumnUtils::doubleToString(dbls[row]);
+				Label			*	label		= labelByValue(asString);
+
+				if(label)
+					dictionary.push_back(asString);
+
+				labelled = labelledDoubles.insert({dbls[row], label ? int(dictionary.size() - 1) : -1}).first;
+			}
+
+			index = labelled->second;
+		}
+	}
+
+	bool changes = _type != colType;
+
+	beginBatchedLabelsDB();
+	setValues(dbls, levelIndices, dictionary, false, 0, &changes);
+	endBatchedLabelsDB();
+
+	setType(colType);
+
+	return changes;
+}
+
+void Column::_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease, bool labelsTempCanBeMaintained)
 {
 	JASPTIMER_SCOPE(Column::_dbUpdateLabelOrder);
 	
@@ -647,7 +833,7 @@ void Column::_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease)
 
 	db().labelsSetOrder(orderPerDbIds);
 	
-	incRevision(false);
+	incRevision(labelsTempCanBeMaintained && !_autoSortByValue);
 }
 
 void Column::_sortLabelsByOrder()
@@ -659,8 +845,7 @@ void Column::labelsClear(bool doIncRevision)
 {
 	db().labelsClear(_id);
 	_labels.clear();
-	_labelByIntsIdMap.clear();
-	_labelByValDis.clear();
+	_labelIndex.clear();
 	_highestIntsId = 0;
 	
 	if(doIncRevision)
@@ -725,20 +910,24 @@ int Column::labelsAdd(int value, const std::string & display, bool filterAllows,
 {
 	JASPTIMER_SCOPE(Column::labelsAdd lotsa arg);
 
-	auto valDisplay = std::make_pair(Label::originalValueAsString(this, originalValue), display);
+	Label * existing = _labelIndex.byValueAndDisplay(Label::originalValueAsString(this, originalValue), display);
+
+	if(existing)
+		return existing->intsId();
 
-	if(_labelByValDis.count(valDisplay))
-		return _labelByValDis.at(valDisplay)->intsId();
+	//A new label simply goes at the end of the labels and the labelsTemp, unless there are entries for doubles there already or the labels are about to get sorted:
+	bool labelsTempCanBeMaintained = _labelsTempRevision == _revision && _labelsTemp.size() == _labelsTempLabels.size() && !_autoSortByValue;
 
 	Label * label = new Label(this, display, value, filterAllows, description, originalValue, order, id);
 	_labels.push_back(label);
-	
-	_labelByIntsIdMap[label->intsId()]	= label;
-	_labelByValDis[valDisplay]			= label;
+	_labelIndex.add(label);
+
+	if(labelsTempCanBeMaintained)
+		_labelsTempAdd(label);
 
 	_highestIntsId = std::max(_highestIntsId, label->intsId());
 
-	_dbUpdateLabelOrder(true);
+	_dbUpdateLabelOrder(true, labelsTempCanBeMaintained);
 	return label->intsId();
 }
 
@@ -753,13 +942,9 @@ void Column::labelsRemoveByIntsId(std::set<int> valuesToRemove, bool updateOrder
 			_labels.begin(),
 			_labels.end(),
 			[&](Label * label) {
-				if(std::find(valuesToRemove.begin(), valuesToRemove.end(), label->intsId()) != valuesToRemove.end())
+				if(valuesToRemove.count(label->intsId()))
 				{
-					_labelByIntsIdMap.erase(label->intsId());
-					
-					auto valDis = std::make_pair(label->originalValueAsString(), label->labelDisplay());
-					if(_labelByValDis.count(valDis) && _labelByValDis.at(valDis) == label)
-						_labelByValDis.erase(valDis);
+					_labelIndex.remove(label);
 						
 					label->dbDelete();
 					delete label;
@@ -781,7 +966,6 @@ strintmap Column::labelsResetValues(int & maxValue)
 
 	strintmap result;
 	int labelValue = 0;
-	_labelByIntsIdMap.clear();
 
 	for (Label * label : _labels)
 	{
@@ -790,11 +974,11 @@ strintmap Column::labelsResetValues(int & maxValue)
 
 		result[label->label()] = labelValue;
 
-		_labelByIntsIdMap[labelValue] = label;
-
 		labelValue++;
 	}
 
+	_labelIndex.rebuild(_labels);
+
 	maxValue = labelValue;
 
 	_highestIntsId = maxValue;
@@ -822,8 +1006,8 @@ void Column::labelsTempReset()
 	_labelsTempRevision			= -1;
 	_labelsTempMaxWidth			= 0;
 	_labelsTempNumerics			= 0;
-	_labelByNonEmptyIndex		.clear();
-	_labelNonEmptyIndexByLabel	.clear();
+	_labelsTempLabels			.clear();
+	_labelsTempIndexByLabel		.clear();
 	
 	nonFilteredCountersReset();
 }
@@ -834,24 +1018,14 @@ int Column::labelsTempCount()
 	{
 		//first collect the labels that are actually Label
 		labelsTempReset();
-		_labelsTemp			. reserve(_labels.size());
-		_labelsTempDbls		. reserve(_labels.size());
+		_labelsTemp				. reserve(_labels.size());
+		_labelsTempDbls			. reserve(_labels.size());
+		_labelsTempLabels		. reserve(_labels.size());
+		_labelsTempToIndex		. reserve(_labels.size());
+		_labelsTempIndexByLabel	. reserve(_labels.size());
 		
-		size_t nonEmptyIndex = 0;
-		for(size_t r=0; r<_labels.size(); r++)
-			if(!_labels[r]->isEmptyValue())
-			{
-				_labelsTemp												. push_back(_labels[r]->label());
-				_labelsTempDbls											. push_back(_labels[r]->originalValue().isDouble() ? _labels[r]->originalValue().asDouble() : EmptyValues::missingValueDouble);
-				_labelsTempToIndex[_labelsTemp[_labelsTemp.size()-1]]	= _labelsTemp.size()-1; //We store the index in _labelsTemp in a map.
-				_labelByNonEmptyIndex[nonEmptyIndex]					= _labels[r];
-				_labelNonEmptyIndexByLabel[_labels[r]]					= nonEmptyIndex;
-				
-				if(!isEmptyValue(*_labelsTempDbls.rbegin()))
-					_labelsTempNumerics++;
-				
-				nonEmptyIndex++;
-			}
+		for(Label * label : _labels)
+			_labelsTempAdd(label);
 		
 		doubleset dblset;
 		
@@ -887,47 +1061,32 @@ int Column::labelsTempCount()
 	return _labelsTemp.size();
 }
 
-int Column::nonFilteredNumericsCount()
+const ColumnStatistics & Column::statistics()
 {
-	if (_nonFilteredNumericsCount == -1)
-	{
-		doubleset numerics;
+	if(!_statistics || !_statistics->upToDate(this))
+		_statistics.reset(new ColumnStatistics(this));
 
-		for(size_t r=0; r<_data->rowCount(); r++)
-			if(_data->filter()->filtered()[r] && !isEmptyValue(_dbls[r]))
-					numerics.insert(_dbls[r]);
-
-		_nonFilteredNumericsCount = numerics.size();
-	}
-
-	return _nonFilteredNumericsCount;
+	return *_statistics;
 }
 
-stringset Column::nonFilteredLevels()
+void Column::nonFilteredCountersReset()
 {
-	if (_nonFilteredLevels.empty())
-	{
-		for(size_t r=0; r<_data->rowCount(); r++)
-			if(_data->filter()->filtered()[r])
-			{
-				if(_ints[r] != Label::DOUBLE_LABEL_VALUE)
-				{
-					Label * label = labelByIntsId(_ints[r]);
-					if(label && !label->isEmptyValue())
-						_nonFilteredLevels.insert(label->label());
-				}
-				else if(!isEmptyValue(_dbls[r]))
-					_nonFilteredLevels.insert(ColumnUtils::doubleToString(_dbls[r]));
-			}
-	}
-
-	return _nonFilteredLevels;
+	_statistics.reset();
 }
 
-void Column::nonFilteredCountersReset()
+void Column::_labelsTempAdd(Label * label)
 {
-	_nonFilteredLevels.clear();
-	_nonFilteredNumericsCount = -1;
+	if(label->isEmptyValue())
+		return;
+	
+	_labelsTemp								. push_back(label->label());
+	_labelsTempDbls							. push_back(label->originalValue().isDouble() ? label->originalValue().asDouble() : EmptyValues::missingValueDouble);
+	_labelsTempToIndex[label->label()]		= _labelsTemp.size()-1; //We store the index in _labelsTemp in a map.
+	_labelsTempIndexByLabel[label]			= _labelsTempLabels.size();
+	_labelsTempLabels						. push_back(label);
+	
+	if(!isEmptyValue(*_labelsTempDbls.rbegin()))
+		_labelsTempNumerics++;
 }
 
 int Column::labelsTempNumerics()
@@ -954,12 +1113,13 @@ std::string Column::labelsTempDisplay(size_t tempLabelIndex)
 
 int Column::labelIndexNonEmpty(Label *label) const
 {			
-	return !_labelNonEmptyIndexByLabel.count(label) ? -1 : _labelNonEmptyIndexByLabel.at(label);
+	auto found = _labelsTempIndexByLabel.find(label);
+	return found == _labelsTempIndexByLabel.end() ? -1 : found->second;
 }
 
 Label * Column::labelByIndexNotEmpty(int index) const
 {
-	return !_labelByNonEmptyIndex.count(index) ? nullptr : _labelByNonEmptyIndex.at(index);
+	return index < 0 || size_t(index) >= _labelsTempLabels.size() ? nullptr : _labelsTempLabels[index];
 }
 
 size_t Column::labelCountNotEmpty() const
@@ -1012,14 +1172,7 @@ int Column::labelsDoubleValueIsTempLabelRow(double dbl)
 
 void Column::_resetLabelValueMap()
 {
-	_labelByIntsIdMap.clear();
-	_labelByValDis.clear();
-
-	for(Label * label : _labels)
-	{
-		_labelByIntsIdMap[label->intsId()]														= label;
-		_labelByValDis[std::make_pair(label->originalValueAsString(), label->labelDisplay())]	= label;
-	}
+	_labelIndex.rebuild(_labels);
 	
 	labelsTempReset();
 }
@@ -1029,11 +1182,13 @@ std::string Column::_getLabelDisplayStringByValue(int key, bool ignoreEmptyValue
 	if (key == EmptyValues::missingValueInteger)
 		return EmptyValues::displayString();
 	
-	if(_labelByIntsIdMap.count(key))
+	Label * label = _labelIndex.byIntsId(key);
+	
+	if(label)
 	{
 		return	ignoreEmptyValue 
-			?	_labelByIntsIdMap.at(key)->labelIgnoreEmpty()
-			:	_labelByIntsIdMap.at(key)->labelDisplay();
+			?	label->labelIgnoreEmpty()
+			:	label->labelDisplay();
 	}
 
 	return std::to_string(key);
@@ -1353,15 +1508,15 @@ bool Column::replaceDoubleLabelFromRowWithDouble(size_t row, double dbl)
 void Column::labelValueChanged(Label *label, double aDouble, const Json::Value & previousOriginal)
 {
 	auto oldValDis	= std::make_pair(Label::originalValueAsString(this, previousOriginal), label->labelDisplay());
-	bool merged		= _labelByValDis.count(label->origValDisplay()) != 0;
+	bool merged		= _labelIndex.byValueAndDisplay(label->originalValueAsString(), label->labelDisplay()) != nullptr;
+	
+	//Make sure it was registered before:
+	assert(_labelIndex.byValueAndDisplay(oldValDis.first, oldValDis.second) == label);
 	
 	if(merged)
 		labelsMergeDuplicateInto(label);
-	
-	//Make sure it was registered before:
-	assert(_labelByValDis[oldValDis] == label);
-	//And that its new location is free:
-	assert(_labelByValDis.count(label->origValDisplay()) == 0 || _labelByValDis.at(label->origValDisplay()) == label);
+
+	_labelIndex.update(label);
 
 	//Lets assume that all occurences of a label in _dbls are the same.
 	//So when we encounter one that is the same as what is passed here we can return immediately
@@ -1375,9 +1530,6 @@ void Column::labelValueChanged(Label *label, double aDouble, const Json::Value &
 		}
 	
 
-	_labelByValDis.erase(oldValDis);
-	_labelByValDis[label->origValDisplay()] = label;
-
 	if(merged)
 		_dbUpdateLabelOrder();
 	
@@ -1393,19 +1545,15 @@ void Column::labelsHandleAutoSort(bool doDbUpdateEtc)
 void Column::labelDisplayChanged(Label *label, const std::string & previousDisplay)
 {
 	auto oldValDis = std::make_pair(label->originalValueAsString(), previousDisplay);
-	bool merged		= _labelByValDis.count(label->origValDisplay()) != 0;
+	bool merged		= _labelIndex.byValueAndDisplay(label->originalValueAsString(), label->labelDisplay()) != nullptr;
+	
+	//Make sure it was registered before:
+	assert(_labelIndex.byValueAndDisplay(oldValDis.first, oldValDis.second) == label);
 	
 	if(merged)
 		labelsMergeDuplicateInto(label);
-	
 
-	//Make sure it was registered before:
-	assert(_labelByValDis[oldValDis] == label);
-	//And that its new location is free:
-	assert(_labelByValDis.count(label->origValDisplay()) == 0 || _labelByValDis.at(label->origValDisplay()) == label);
-
-	_labelByValDis.erase(oldValDis);
-	_labelByValDis[label->origValDisplay()] = label;
+	_labelIndex.update(label);
 	
 	if(merged)
 		_dbUpdateLabelOrder();
@@ -1585,7 +1733,7 @@ Label *Column::labelByIntsId(int value) const
 {
 	JASPTIMER_SCOPE(Column::labelByValue);
 
-	return value != EmptyValues::missingValueInteger && _labelByIntsIdMap.count(value) ? _labelByIntsIdMap.at(value) : nullptr;
+	return value != EmptyValues::missingValueInteger ? _labelIndex.byIntsId(value) : nullptr;
 }
 
 Label * Column::labelByDisplay(const std::string & display) const
@@ -1598,13 +1746,7 @@ Labelset Column::labelsByDisplay(const std::string & display) const
 {
 	JASPTIMER_SCOPE(Column::labelByDisplay);
 
-	Labels found;
-	std::copy_if(_labels.begin(), _labels.end(), std::back_inserter(found), [&display](Label * label)
-	{
-		return label->label() == display;
-	});
-	
-	return Labelset(found.begin(), found.end());
+	return _labelIndex.byDisplay(display);
 }
 
 Label * Column::labelByValue(const std::string & value) const
@@ -1617,13 +1759,7 @@ Labelset Column::labelsByValue(const std::string & value) const
 {
 	JASPTIMER_SCOPE(Column::labelByValue);
 
-	Labels found;
-	std::copy_if(_labels.begin(), _labels.end(), std::back_inserter(found), [&value](Label * label)
-	{
-		return label->originalValueAsString() == value;
-	});
-	
-	return Labelset(found.begin(), found.end());
+	return _labelIndex.byValue(value);
 }
 
 
@@ -1632,8 +1768,7 @@ Label * Column::labelByValueAndDisplay(const std::string &value, const std::stri
 {
 	JASPTIMER_SCOPE(Column::labelsByValueAndDisplay);
 
-	auto valDis = std::make_pair(value, labelText);
-	return _labelByValDis.count(valDis) == 0 ? nullptr : _labelByValDis.at(valDis);
+	return _labelIndex.byValueAndDisplay(value, labelText);
 }
 
 void Column::labelsMergeDuplicateInto(Label * labelPrime)
@@ -1641,29 +1776,28 @@ void Column::labelsMergeDuplicateInto(Label * labelPrime)
 	
 	const std::string	value		= labelPrime->originalValueAsString(),
 						labelText	= labelPrime->label();
+	//labelPrime might still be in the index with its previous value, so it is not necessarily among these:
 	Labelset found;
-	std::copy_if(_labels.begin(), _labels.end(), std::inserter(found, found.begin()), [&value, &labelText](Label * label)
-	{
-		return label->originalValueAsString() == value && label->label() == labelText;
-	});
+	for(Label * label : _labelIndex.byValue(value))
+		if(label->label() == labelText)
+			found.insert(label);
+	
+	found.erase(labelPrime);
 	
-	if(found.size() > 1)
+	if(found.size() > 0)
 	{
-		found.erase(labelPrime);
-		
-		for(Label * otherLabel : found)
-			for(int & anInt : _ints)
-				if(anInt == otherLabel->intsId())
-					anInt = labelPrime->intsId();
-		
 		intset ids;
 		
 		for(Label * label : found)
 			ids.insert(label->intsId());
 		
+		for(int & anInt : _ints)
+			if(ids.count(anInt))
+				anInt = labelPrime->intsId();
+		
 		labelsRemoveByIntsId(ids, false);
 		
-		_labelByValDis[labelPrime->origValDisplay()] = labelPrime;
+		_labelIndex.update(labelPrime);
 		labelsTempReset();
 	}
 }
@@ -1994,7 +2128,7 @@ const stringset & Column::dependsOnColumns(bool refresh)
 	return _dependsOnColumns;
 }
 
-Json::Value Column::serialize() const
+Json::Value Column::serialize(bool includeValues) const
 {
 	Json::Value json(Json::objectValue);
 
@@ -2010,6 +2144,12 @@ Json::Value Column::serialize() const
 	json["error"]			= _error;
 	json["type"]			= int(_type);
 
+	json["customEmptyValues"]	= _emptyValues->toJson();
+	json["labels"]				= serializeLabels();
+
+	if(!includeValues)
+		return json;
+
 	Json::Value jsonDbls(Json::arrayValue);
 	for (double dbl : _dbls)
 		jsonDbls.append(dbl);
@@ -2018,9 +2158,6 @@ Json::Value Column::serialize() const
 	for (int i : _ints)
 		jsonInts.append(i);
 
-	json["customEmptyValues"]	= _emptyValues->toJson();
-
-	json["labels"]				= serializeLabels();
 	json["dbls"]				= jsonDbls;
 	json["ints"]				= jsonInts;
 
@@ -2041,8 +2178,7 @@ void Column::deserializeLabelsForCopy(const Json::Value & labels)
 	labelsTempReset();
 
 	beginBatchedLabelsDB();
-	_labelByIntsIdMap.clear();
-	_labelByValDis.clear();
+	_labelIndex.clear();
 	_labels.clear();
 
 	if (labels.isArray())
@@ -2078,10 +2214,10 @@ void Column::deserializeLabelsForRevert(const Json::Value & labels)
 			bool				filterAllow = labelJson["filterAllows"]	.asBool();
 			
 			
-			if(_labelByIntsIdMap.count(intsId))
+			Label * label = _labelIndex.byIntsId(intsId);
+			
+			if(label)
 			{
-				Label * label = _labelByIntsIdMap[intsId];
-				
 				label->setOrder(			order						);
 				label->setLabel(			labelStr					);
 				label->setDescription(		description					);
@@ -2126,6 +2262,25 @@ void Column::deserializeLabelsForRevert(const Json::Value & labels)
 }
 
 void Column::deserialize(const Json::Value &json)
+{
+	if (json.isNull())
+		return;
+
+	doublevec	dbls(json["dbls"].size());
+	intvec		ints(json["ints"].size());
+
+	size_t i=0;
+	for (const Json::Value& dblJson : json["dbls"])
+		dbls[i++] = dblJson.asDouble();
+
+	i=0;
+	for (const Json::Value& intJson : json["ints"])
+		ints[i++] = intJson.asInt();
+
+	deserialize(json, std::move(dbls), std::move(ints));
+}
+
+void Column::deserialize(const Json::Value &json, doublevec dbls, intvec ints)
 {
 	if (json.isNull())
 		return;
@@ -2160,15 +2315,8 @@ void Column::deserialize(const Json::Value &json)
 
 	_emptyValues->fromJson(json["customEmptyValues"]);
 	
-	size_t i=0;
-	_dbls.resize(json["dbls"].size());
-	for (const Json::Value& dblJson : json["dbls"])
-		_dbls[i++] = dblJson.asDouble();
-	
-	i=0;
-	_ints.resize(json["ints"].size());
-	for (const Json::Value& intJson : json["ints"])
-		_ints[i++] = intJson.asInt();
+	_dbls = std::move(dbls);
+	_ints = std::move(ints);
 	
 	assert(_ints.size() == _dbls.size());
 	
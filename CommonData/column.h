@@ -3,10 +3,13 @@
 
 #include "datasetbasenode.h"
 #include "label.h"
+#include "labelindex.h"
 #include "columntype.h"
 #include "utils.h"
 #include <list>
+#include <memory>
 #include "emptyvalues.h"
+#include "columnstatistics.h"
 
 class DataSet;
 class Analysis;
@@ -40,9 +43,10 @@ class Analysis;
 /// It also handles storing the information of computed columns (those used to be split off)
 class Column : public DataSetBaseNode
 {
-public:
-	typedef std::map<std::pair<std::string, std::string>, Label*>	LabelByStrStr;
+	friend class ColumnarSegment;
+	friend class DatabaseInterface;
 
+public:
 									Column(DataSet * data, int id = -1);
 									~Column();
 									
@@ -52,6 +56,7 @@ public:
 			void					dbCreate(	int index);
 			void					dbLoad(		int id=-1, bool getValues = true);	///< Loads *and* reloads from DB!
 			void					dbLoadIndex(int index, bool getValues = true);
+			void					dbLoadValues();												///< Only (re)loads _ints and _dbls from DB
 			void					dbUpdateComputedColumnStuff();
 			void					dbUpdateValues(bool labelsTempCanBeMaintained = true);
 			void					dbDelete(bool cleanUpRest = true);
@@ -78,6 +83,7 @@ public:
 			bool					setAsNominalOrOrdinal(	const intvec	& values, intstrmap uniqueValues,			bool	is_ordinal = false);
 
 			bool					overwriteDataAndType(	stringvec		data, columnType colType);
+			bool					overwriteDataAndType(	doublevec		dbls, intvec levelIndices, const stringvec & levels, columnType colType); ///< Typed version of the above, a negative (or no) levelIndices[row] means dbls[row] is used, otherwise levels[levelIndices[row]]
 			
 			bool					allLabelsPassFilter()	const;
 			bool					hasFilter()				const;
@@ -128,8 +134,9 @@ public:
 			int						labelsDoubleValueIsTempLabelRow(double dbl);
 			Label				*	labelDoubleDummy()		{ return _doubleDummy; }
 
-			int						nonFilteredNumericsCount();
-			stringset				nonFilteredLevels();
+			const ColumnStatistics	&	statistics();									///< Of the rows that pass the filter, recalculated only when the column or filter changed
+			int						nonFilteredNumericsCount()	{ return statistics().numerics;	}
+			const stringset		&	nonFilteredLevels()			{ return statistics().levels;	}
 			void					nonFilteredCountersReset();
 
 			std::set<size_t>		labelsMoveRows(std::vector<qsizetype> rows, bool up);
@@ -163,6 +170,8 @@ public:
 			bool					setValue(					size_t row, double				value,								bool writeToDB = true);
 			bool					setValue(					size_t row, int					valueInt, double valueDbl,			bool writeToDB = true);
 			columnType				setValues(			const stringvec &	values, const stringvec &	labels, int thresholdScale, bool * changedSomething = nullptr); ///< Returns what would be the most sensible columntype
+			columnType				setValues(			const doublevec &	dbls,	const intvec & labelIndices, const stringvec & labelDictionary, bool onlyInts, int thresholdScale, bool * changedSomething = nullptr); ///< Typed version of the above for importers that already parsed their values. A negative labelIndices[row] means dbls[row] is used, otherwise a label for labelDictionary[labelIndex]
+			void					setValuesFrom(		size_t firstRow,	const stringvec &	values); ///< Sets the rows from firstRow on like setValue(row, value, "", false) would, but resolves each distinct value only once. For rows that were empty, like the ones appended by a synchronisation
 			bool					setDescriptions(	strstrmap labelToDescriptionMap); ///<Returns any changes
 			void					rowInsertEmptyVal(size_t row);
 			void					rowDelete(size_t row);
@@ -209,9 +218,10 @@ public:
 
 			void					checkForLoopInDependencies(std::string code);
 			const	stringset	 &	dependsOnColumns(bool refresh = true);
-			Json::Value				serialize()																const;
+			Json::Value				serialize(bool includeValues = true)									const;	///< Without the values there is no "dbls" and "ints", see deserialize(info, dbls, ints)
 			Json::Value				serializeLabels()														const;
 			void					deserialize(				const Json::Value & info);
+			void					deserialize(				const Json::Value & info, doublevec dbls, intvec ints);
 			void					deserializeLabelsForCopy(	const Json::Value & info);
 			void					deserializeLabelsForRevert(	const Json::Value & info);
 			std::string				getUniqueName(const std::string& name)									const;
@@ -235,13 +245,15 @@ public:
 	
 protected:
 			void					_checkForDependencyLoop(stringset foundNames, std::list<std::string> loopList);
-			void					_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease = false);		///< Sets the order of the _labels to label.order and in DB
+			void					_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease = false, bool labelsTempCanBeMaintained = false);		///< Sets the order of the _labels to label.order and in DB
 			void					_sortLabelsByOrder();		///< Sorts the labels by label.order
 			std::string				_getLabelDisplayStringByValue(int key, bool ignoreEmptyValue = false) const;
 			columnTypeChangeResult	_changeColumnToNominalOrOrdinal(enum columnType newColumnType);
 			columnTypeChangeResult	_changeColumnToScale();
 			void					_convertVectorIntToDouble(intvec & intValues, doublevec & doubleValues);
 			void					_resetLabelValueMap();
+			void					_labelsTempAdd(Label * label);
+			columnType				_suggestColumnType(bool onlyInts, bool onlyDoubles, const intset & ints, int thresholdScale) const;
 			doublevec				valuesNumericOrdered();			
 			std::map<Label*,size_t> valuesAlphabeticalOffsets();
 
@@ -259,9 +271,10 @@ private:
 			qsizetype				_labelsTempMaxWidth = 0;
 			stringvec				_labelsTemp;				///< Contains displaystring for labels. Used to allow people to edit "double" labels. Initialized when necessary
 			doublevec				_labelsTempDbls;
-			strintmap				_labelsTempToIndex;
-			stringset				_nonFilteredLevels;
-			int						_nonFilteredNumericsCount	= -1;
+			std::unordered_map<std::string, size_t>		_labelsTempToIndex;
+			Labels					_labelsTempLabels;			///< The Label behind each of the first entries of _labelsTemp, the entries after those come from _dbls
+			std::unordered_map<const Label*, size_t>	_labelsTempIndexByLabel;
+			std::unique_ptr<ColumnStatistics>	_statistics;
 			bool					_invalidated		= false,
 									_autoSortByValue;
 			computedColumnType		_codeType			= computedColumnType::notComputed;
@@ -274,10 +287,7 @@ private:
 			doublevec				_dbls;
 			intvec					_ints;
 			stringset				_dependsOnColumns;
-			std::map<int, Label*>	_labelByIntsIdMap,
-									_labelByNonEmptyIndex;
-			std::map<Label*, int>	_labelNonEmptyIndexByLabel;
-			LabelByStrStr			_labelByValDis;
+			LabelIndex				_labelIndex;
 			int						_batchedLabelDepth	= 0;
 	static	bool					_autoSortByValuesByDefault;
 			
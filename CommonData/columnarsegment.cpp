@@ -0,0 +1,173 @@
+#include "columnarsegment.h"
+#include "databaseinterface.h"
+#include "tempfiles.h"
+#include "dataset.h"
+#include "timers.h"
+#include "log.h"
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <map>
+#include <new>
+
+using namespace boost;
+
+const uint32_t ColumnarSegment::_magic = 0x4A435347; // "JCSG"
+
+std::string ColumnarSegment::segmentName(int dataSetId, int revision)
+{
+	return "JASP-" + std::to_string(TempFiles::sessionId()) + "-DataSet_" + std::to_string(dataSetId) + "-" + std::to_string(revision);
+}
+
+std::string ColumnarSegment::publish(DataSet * data)
+{
+	JASPTIMER_SCOPE(ColumnarSegment::publish);
+
+	if(!data || data->id() == -1 || !data->filter())
+		return "";
+
+	const size_t	rows		= data->rowCount() > 0 ? data->rowCount() : 0,
+					cols		= data->columns().size(),
+					headerSize	= sizeof(Header) + cols * sizeof(ColumnEntry),
+					dblsOffset	= headerSize,
+					intsOffset	= dblsOffset + rows * cols * sizeof(double),
+					filterOff	= intsOffset + rows * cols * sizeof(int32_t),
+					totalSize	= std::max(filterOff + rows, size_t(1));
+
+	const std::string name = segmentName(data->id(), data->revision());
+
+	try
+	{
+		interprocess::shared_memory_object::remove(name.c_str());
+
+		interprocess::shared_memory_object	shm(interprocess::create_only, name.c_str(), interprocess::read_write);
+											shm.truncate(totalSize);
+		interprocess::mapped_region			region(shm, interprocess::read_write);
+
+		char		*	base	= static_cast<char*>(region.get_address());
+		Header		*	header	= new (base) Header(); //Constructs complete as 0
+		ColumnEntry	*	entries	= reinterpret_cast<ColumnEntry*>(base + sizeof(Header));
+
+		header->magic			= _magic;
+		header->dataSetId		= data->id();
+		header->revision		= data->revision();
+		header->filterId		= data->filter()->id();
+		header->filterRevision	= data->filter()->revision();
+		header->rowCount		= rows;
+		header->columnCount		= cols;
+		header->filterOffset	= filterOff;
+
+		for(size_t c=0; c<cols; c++)
+		{
+			Column		*	col		= data->columns()[c];
+			ColumnEntry &	entry	= entries[c];
+
+			entry.columnId		= col->id();
+			entry.revision		= col->rowCount() == rows ? col->revision() : -1;
+			entry.dblsOffset	= dblsOffset + c * rows * sizeof(double);
+			entry.intsOffset	= intsOffset + c * rows * sizeof(int32_t);
+
+			if(entry.revision == -1)
+				continue;
+
+			std::memcpy(base + entry.dblsOffset, col->dbls().data(), rows * sizeof(double));
+			std::memcpy(base + entry.intsOffset, col->ints().data(), rows * sizeof(int32_t));
+		}
+
+		const boolvec & filtered = data->filter()->filtered();
+
+		if(filtered.size() != rows)
+			header->filterRevision = -1;
+		else
+			for(size_t r=0; r<rows; r++)
+				base[filterOff + r] = filtered[r] ? 1 : 0;
+
+		header->complete.store(1, std::memory_order_release);
+	}
+	catch(interprocess::interprocess_exception & e)
+	{
+		Log::log() << "ColumnarSegment::publish could not write segment '" << name << "' because: " << e.what() << std::endl;
+		interprocess::shared_memory_object::remove(name.c_str());
+		return "";
+	}
+
+	return name;
+}
+
+bool ColumnarSegment::load(DataSet * data)
+{
+	JASPTIMER_SCOPE(ColumnarSegment::load);
+
+	if(!data || data->id() == -1)
+		return false;
+
+	const std::string name = segmentName(data->id(), data->revision());
+
+	try
+	{
+		interprocess::shared_memory_object	shm(interprocess::open_only, name.c_str(), interprocess::read_only);
+		interprocess::mapped_region			region(shm, interprocess::read_only);
+
+		const char		*	base	= static_cast<const char*>(region.get_address());
+		const Header	*	header	= reinterpret_cast<const Header*>(base);
+
+		if(region.get_size() < sizeof(Header) || header->magic != _magic || !header->complete.load(std::memory_order_acquire))
+			return false;
+
+		const size_t rows = header->rowCount;
+
+		if(header->dataSetId != data->id() || header->revision != data->revision() || int(rows) != data->rowCount() || region.get_size() < header->filterOffset + rows)
+			return false;
+
+		const ColumnEntry * entries = reinterpret_cast<const ColumnEntry*>(base + sizeof(Header));
+
+		std::map<int, const ColumnEntry*> entryById;
+		for(size_t c=0; c<header->columnCount; c++)
+			entryById[entries[c].columnId] = entries + c;
+
+		for(Column * col : data->columns())
+		{
+			const ColumnEntry * entry = entryById.count(col->id()) ? entryById.at(col->id()) : nullptr;
+
+			if(!entry || entry->revision == -1 || entry->revision != col->revision())
+			{
+				col->dbLoadValues();
+				continue;
+			}
+
+			col->_dbls.resize(rows);
+			col->_ints.resize(rows);
+
+			std::memcpy(col->_dbls.data(), base + entry->dblsOffset, rows * sizeof(double));
+			std::memcpy(col->_ints.data(), base + entry->intsOffset, rows * sizeof(int32_t));
+
+			col->labelsTempReset();
+		}
+
+		Filter * filter = data->filter();
+
+		if(filter->id() == header->filterId && filter->revision() == header->filterRevision)
+		{
+			filter->setRowCount(rows);
+
+			for(size_t r=0; r<rows; r++)
+				filter->setFilterValueNoDB(r, base[header->filterOffset + r]);
+		}
+		else
+			filter->dbLoad();
+	}
+	catch(interprocess::interprocess_exception & e)
+	{
+		//No segment for this revision, this is quite normal if the change did not come from Desktop
+		return false;
+	}
+
+	return true;
+}
+
+void ColumnarSegment::remove(const std::string & segmentName)
+{
+	if(!segmentName.empty())
+		interprocess::shared_memory_object::remove(segmentName.c_str());
+}
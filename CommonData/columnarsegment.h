@@ -0,0 +1,58 @@
+#ifndef COLUMNARSEGMENT_H
+#define COLUMNARSEGMENT_H
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+
+class DataSet;
+
+/// Immutable, versioned snapshot of the values of a DataSet in shared memory
+///
+/// Desktop publishes Column::_dbls, Column::_ints and the filter vector of its DataSet into a shared memory segment
+/// whenever the revision of the DataSet changes. Each revision gets its own segment, named after the session, the dataset and the revision.
+/// Once written a segment is never changed again, the previous one is simply removed when a new revision is published.
+///
+/// The engines map such a segment read-only when DataSet::dbLoad is called and copy the columns out of it,
+/// this way they do not need to scan the entire DataSet_# table in sqlite after every change.
+///
+/// Because the dataset revision does not change when only a single column is edited each column also has its revision stored.
+/// A column (or filter) whose revision in sqlite differs from the one in the segment is loaded from sqlite as before.
+/// If there is no (complete) segment for the current revision load() returns false and DataSet falls back to DatabaseInterface::dataSetBatchedValuesLoad.
+class ColumnarSegment
+{
+public:
+	static std::string	segmentName(int dataSetId, int revision);
+
+	static std::string	publish(DataSet * data);					///< Writes a new segment for the current revision of data and returns its name, or "" if that failed.
+	static bool			load(DataSet * data);						///< Loads the values of data from the segment matching its revision, returns false if there is none or it is unusable.
+	static void			remove(const std::string & segmentName);
+
+private:
+	static const uint32_t _magic;
+
+	struct Header
+	{
+		uint32_t				magic;
+		std::atomic<uint32_t>	complete;		///< Stored last with release, loaded first with acquire, so a reader never uses a half written segment
+		int32_t					dataSetId,
+								revision,
+								filterId,
+								filterRevision;
+		uint64_t				rowCount,
+								columnCount,
+								filterOffset;
+	};
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "ColumnarSegment needs lock free 32 bit atomics to share them between processes");
+
+	struct ColumnEntry
+	{
+		int32_t		columnId,
+					revision;		///< -1 when the values in memory did not match the rowcount and should not be used
+		uint64_t	dblsOffset,
+					intsOffset;
+	};
+};
+
+#endif // COLUMNARSEGMENT_H
@@ -0,0 +1,70 @@
+#include "columnstatistics.h"
+#include "column.h"
+#include "dataset.h"
+#include "filter.h"
+#include "columnutils.h"
+#include "timers.h"
+#include <cmath>
+
+ColumnStatistics::ColumnStatistics(Column * column)
+	: min(NAN), max(NAN), histogram(histogramBins, 0), _columnRevision(column->revision()), _filterRevision(column->data()->filter()->revision())
+{
+	JASPTIMER_SCOPE(ColumnStatistics::ColumnStatistics);
+
+	const std::vector<bool>	&	filtered	= column->data()->filter()->filtered();
+	const doublevec			&	dbls		= column->dbls();
+	const intvec			&	ints		= column->ints();
+	const size_t				rowCount	= std::min(size_t(column->data()->rowCount()), dbls.size());
+
+	//Whether a label is empty is a string lookup, so only do that once per label instead of once per row
+	std::map<int, const Label*>	nonEmptyLabels;
+
+	for(const Label * label : column->labels())
+		if(!label->isEmptyValue())
+			nonEmptyLabels[label->intsId()] = label;
+
+	doubleset	numericValues;
+	doublevec	finite;
+
+	for(size_t r=0; r<rowCount; r++)
+		if(r < filtered.size() && filtered[r])
+		{
+			rows++;
+
+			if(ints[r] != Label::DOUBLE_LABEL_VALUE)
+			{
+				auto label = nonEmptyLabels.find(ints[r]);
+
+				if(label != nonEmptyLabels.end())	levels.insert(label->second->label());
+				else								missing++;
+			}
+			else if(!column->isEmptyValue(dbls[r]))
+				levels.insert(ColumnUtils::doubleToString(dbls[r]));
+			else
+				missing++;
+
+			if(!column->isEmptyValue(dbls[r]))
+			{
+				numericValues.insert(dbls[r]);
+
+				if(std::isfinite(dbls[r]))
+				{
+					finite.push_back(dbls[r]);
+					min = std::isnan(min) ? dbls[r] : std::min(min, dbls[r]);
+					max = std::isnan(max) ? dbls[r] : std::max(max, dbls[r]);
+				}
+			}
+		}
+
+	numerics = numericValues.size();
+
+	const double width = (max - min) / histogramBins;
+
+	for(double dbl : finite)
+		histogram[width > 0 ? std::min(histogramBins - 1, size_t((dbl - min) / width)) : 0]++;
+}
+
+bool ColumnStatistics::upToDate(Column * column) const
+{
+	return _columnRevision == column->revision() && _filterRevision == column->data()->filter()->revision();
+}
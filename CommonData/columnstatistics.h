@@ -0,0 +1,36 @@
+#ifndef COLUMNSTATISTICS_H
+#define COLUMNSTATISTICS_H
+
+#include "utils.h"
+
+class Column;
+
+///
+/// Summary of the rows of a Column that pass the filter, which is what the forms want to know about a variable to check their constraints or to show a preview.
+/// Column::statistics() keeps one around and makes a new one when the revision of the column or of the filter changed, or when Column::nonFilteredCountersReset() was called.
+///
+/// "Missing" here is anything that is an empty value for the column, the levels are the same as Column::nonFilteredLevels always were.
+/// The histogram divides [min, max] in histogramBins equally wide bins and counts the numeric values in each, the last bin includes max.
+class ColumnStatistics
+{
+public:
+							ColumnStatistics(Column * column);
+
+	bool					upToDate(Column * column)	const;
+
+	static const size_t		histogramBins = 20;
+
+	size_t					rows			= 0,	///< That pass the filter
+							missing			= 0,
+							numerics		= 0;	///< Distinct numeric values
+	stringset				levels;
+	double					min,
+							max;					///< Both NaN when there are no numeric values
+	std::vector<size_t>		histogram;
+
+private:
+	int						_columnRevision,
+							_filterRevision;
+};
+
+#endif // COLUMNSTATISTICS_H
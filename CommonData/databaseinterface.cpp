@@ -6,6 +6,8 @@
 #include "timers.h"
 #include "utils.h"
 #include "log.h"
+#include <zlib.h>
+#include <cstring>
 
 DatabaseInterface * DatabaseInterface::_singleton = nullptr;
 
@@ -50,6 +52,29 @@ void DatabaseInterface::upgradeDBFromVersion(Version originalVersion)
 	if(originalVersion < "0.19.2" && !tableHasColumn("Filters", "name"))
 		runStatements("ALTER TABLE Filters  ADD COLUMN name		TEXT;");
 
+	//The tables below are not tied to a release, so they are checked on the schema itself
+	runStatements("CREATE TABLE IF NOT EXISTS DataSetChanges ( id INTEGER PRIMARY KEY, dataSet INT, revision INT, nodeType TEXT, nodeId INT NULL, FOREIGN KEY(dataSet) REFERENCES DataSets(id));");
+	
+	if (!tableHasColumn("DataSets", "dataFileFingerprint"))
+		runStatements("ALTER TABLE DataSets  ADD 	COLUMN dataFileFingerprint	TEXT;");
+
+	runStatements("CREATE TABLE IF NOT EXISTS ColumnValueEdits ( columnId INT, row INT, valueInt INT, valueDbl INT, PRIMARY KEY(columnId, row), FOREIGN KEY(columnId) REFERENCES Columns(id));");
+
+	//A file that already has ColumnValues or FilterValues never stored its values in DataSet_#, so only the ones without need to be moved over
+	if (!tableHasColumn("ColumnValues", "columnId"))
+	{
+		runStatements("CREATE TABLE ColumnValues ( columnId INTEGER PRIMARY KEY, rowCount INT, checksum INT, ints BLOB, dbls BLOB, FOREIGN KEY(columnId) REFERENCES Columns(id));");
+		
+		_upgradeColumnValuesToBlobs();
+	}
+
+	if (!tableHasColumn("FilterValues", "filterId"))
+	{
+		runStatements("CREATE TABLE FilterValues ( filterId INTEGER PRIMARY KEY, rowCount INT, bits BLOB, FOREIGN KEY(filterId) REFERENCES Filters(id));");
+
+		_upgradeFilterValuesToBlobs();
+	}
+
 	transactionWriteEnd();
 }
 
@@ -70,7 +95,7 @@ DatabaseInterface::~DatabaseInterface()
 }
 
 
-int DatabaseInterface::dataSetInsert(const std::string & dataFilePath, long dataFileTimestamp, const std::string & description, const std::string & databaseJson, const std::string & emptyValuesJson, bool dataSynch)
+int DatabaseInterface::dataSetInsert(const std::string & dataFilePath, long dataFileTimestamp, const std::string & description, const std::string & databaseJson, const std::string & emptyValuesJson, bool dataSynch, const std::string & dataFileFingerprint)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetInsert);
 	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt)
@@ -81,17 +106,18 @@ int DatabaseInterface::dataSetInsert(const std::string & dataFilePath, long data
 		sqlite3_bind_text(stmt, 4, databaseJson.c_str(),	databaseJson.length(),		SQLITE_TRANSIENT);
 		sqlite3_bind_text(stmt, 5, emptyValuesJson.c_str(), emptyValuesJson.length(),	SQLITE_TRANSIENT);
 		sqlite3_bind_int(stmt,	6, dataSynch);
+		sqlite3_bind_text(stmt, 7, dataFileFingerprint.c_str(), dataFileFingerprint.length(), SQLITE_TRANSIENT);
 	};
 
 	transactionWriteBegin();
-	int id = runStatementsId("INSERT INTO DataSets (dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, dataFileSynch) VALUES (?, ?, ?, ?, ?, ?) RETURNING id;", prepare);
+	int id = runStatementsId("INSERT INTO DataSets (dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, dataFileSynch, dataFileFingerprint) VALUES (?, ?, ?, ?, ?, ?, ?) RETURNING id;", prepare);
 	runStatements("CREATE TABLE " + dataSetName(id) + " (rowNumber INTEGER PRIMARY KEY);"); // Can be overwritten through dataSetCreateTable
 	transactionWriteEnd();
 
 	return id;
 }
 
-void DatabaseInterface::dataSetUpdate(int dataSetId,	const std::string & dataFilePath, long dataFileTimestamp, const std::string & description, const std::string & databaseJson, const std::string & emptyValuesJson, bool dataSynch)
+void DatabaseInterface::dataSetUpdate(int dataSetId,	const std::string & dataFilePath, long dataFileTimestamp, const std::string & description, const std::string & databaseJson, const std::string & emptyValuesJson, bool dataSynch, const std::string & dataFileFingerprint)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetUpdate);
 	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt)
@@ -102,15 +128,16 @@ void DatabaseInterface::dataSetUpdate(int dataSetId,	const std::string & dataFil
 		sqlite3_bind_text(stmt, 4, databaseJson.c_str(),	databaseJson.length(),		SQLITE_TRANSIENT);
 		sqlite3_bind_text(stmt, 5, emptyValuesJson.c_str(), emptyValuesJson.length(),	SQLITE_TRANSIENT);
 		sqlite3_bind_int(stmt,	6, dataSynch);
-		sqlite3_bind_int(stmt,	7, dataSetId);
+		sqlite3_bind_text(stmt, 7, dataFileFingerprint.c_str(), dataFileFingerprint.length(), SQLITE_TRANSIENT);
+		sqlite3_bind_int(stmt,	8, dataSetId);
 	};
 
 	//Log::log() << "UPDATE DataSet " << dataSetId << " with Empty Values: " << emptyValuesJson << std::endl;
 
-	runStatements("UPDATE DataSets SET dataFilePath=?, dataFileTimestamp=?, description=?, databaseJson=?, emptyValuesJson=?, dataFileSynch=?, revision=revision+1 WHERE id = ?;", prepare);
+	runStatements("UPDATE DataSets SET dataFilePath=?, dataFileTimestamp=?, description=?, databaseJson=?, emptyValuesJson=?, dataFileSynch=?, dataFileFingerprint=?, revision=revision+1 WHERE id = ?;", prepare);
 }
 
-void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, long & dataFileTimestamp, std::string & description, std::string & databaseJson, std::string & emptyValuesJson, int & revision, bool & dataSynch)
+void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, long & dataFileTimestamp, std::string & description, std::string & databaseJson, std::string & emptyValuesJson, int & revision, bool & dataSynch, std::string & dataFileFingerprint)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetLoad);
 	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt)
@@ -122,7 +149,7 @@ void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, l
 	{
 		int colCount = sqlite3_column_count(stmt);
 
-		assert(colCount == 7);
+		assert(colCount == 8);
 
 		dataFilePath	= _wrap_sqlite3_column_text(stmt, 0);
 		dataFileTimestamp	= sqlite3_column_int(	stmt, 1);
@@ -131,11 +158,12 @@ void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, l
 		emptyValuesJson = _wrap_sqlite3_column_text(stmt, 4);
 		revision		= sqlite3_column_int(		stmt, 5);
 		dataSynch		= sqlite3_column_int(		stmt, 6);
+		dataFileFingerprint = _wrap_sqlite3_column_text(stmt, 7);
 
 		//Log::log() << "Output loadDataset(dataSetId="<<dataSetId<<") had (dataFilePath='"<<dataFilePath<<"', databaseJson='"<<databaseJson<<"', emptyValuesJson='"<<emptyValuesJson<<"')" << std::endl;
 	};
 
-	runStatements("SELECT dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, revision, dataFileSynch FROM DataSets WHERE id = ?;", prepare, processRow);
+	runStatements("SELECT dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, revision, dataFileSynch, dataFileFingerprint FROM DataSets WHERE id = ?;", prepare, processRow);
 }
 
 int DatabaseInterface::dataSetColCount(int dataSetId)
@@ -179,9 +207,9 @@ void DatabaseInterface::dataSetSetRowCount(int dataSetId, size_t rowCount)
 void DatabaseInterface::filterClear(int id)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::filterClear);
-	int dataSet = filterGetDataSetId(id);
 
-	runStatements("UPDATE " + dataSetName(dataSet) + " SET " + filterTableName(id) + " = 1;");
+	//Without values everything passes
+	runStatements("DELETE FROM FilterValues WHERE filterId = " + std::to_string(id) + ";");
 }
 
 void DatabaseInterface::filterDelete(int filterIndex)
@@ -189,10 +217,7 @@ void DatabaseInterface::filterDelete(int filterIndex)
 	JASPTIMER_SCOPE(DatabaseInterface::filterDelete);
 	transactionWriteBegin();
 
-	int dataSetId = filterGetDataSetId(filterIndex);
-
-	if(dataSetId != -1)
-		runStatements("ALTER TABLE " + dataSetName(dataSetId) + " DROP COLUMN " + filterTableName(filterIndex) + ";");
+	runStatements("DELETE FROM FilterValues WHERE filterId = " + std::to_string(filterIndex) + ";");
 	runStatements("DELETE FROM Filters WHERE id = " + std::to_string(filterIndex) + ";");
 
 	transactionWriteEnd();
@@ -215,7 +240,6 @@ int DatabaseInterface::filterInsert(int dataSetId, const std::string & rFilter,
 	transactionWriteBegin();
 	
 	int id = runStatementsId("INSERT INTO Filters (dataSet, rFilter, generatedFilter, constructorJson, constructorR, name) VALUES (?, ?, ?, ?, ?, ?) RETURNING rowid;", prepare);
-	runStatements("ALTER TABLE " + dataSetName(dataSetId) + " ADD " + filterTableName(id) +" INT NOT NULL DEFAULT 1;");
 	
 	transactionWriteEnd();
 
@@ -290,20 +314,14 @@ bool DatabaseInterface::filterSelect(int filterIndex, boolvec & bools)
 
 	if(dataSet != -1)
 	{
+		boolvec loaded(dataSetRowCount(dataSet), true);
 
-		const size_t rows = dataSetRowCount(dataSet);
+		runStatements("SELECT rowCount, bits FROM FilterValues WHERE filterId = ?;",
+			[&](sqlite3_stmt * stmt)				{ sqlite3_bind_int(stmt, 1, filterIndex); },
+			[&](size_t row, sqlite3_stmt * stmt)	{ _filterUnpack(sqlite3_column_blob(stmt, 1), sqlite3_column_bytes(stmt, 1), sqlite3_column_int64(stmt, 0), loaded); });
 
-		changed = changed || rows != bools.size();
-
-		bools.resize(rows);
-
-		runStatements("SELECT " + filterTableName(filterIndex) + " FROM " + dataSetName(dataSet) + " ORDER BY rowNumber;",
-		[&](sqlite3_stmt *){ }, [&](size_t row, sqlite3_stmt * stmt)
-		{
-			int val			= sqlite3_column_int(stmt, 0);
-				changed		= changed || bools[row] != val;
-				bools[row]	= val;
-		});
+		changed = loaded != bools;
+		bools.swap(loaded);
 	}
 
 	transactionReadEnd();
@@ -399,6 +417,8 @@ int DatabaseInterface::filterIncRevision(int filterIndex)
 				runStatements(	"UPDATE Filters SET revision=revision+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM Filters			WHERE id=?;", prepare);
 
+	changeLogAddFilter(filterIndex);
+
 	transactionWriteEnd();
 
 	return rev;
@@ -415,32 +435,135 @@ void DatabaseInterface::filterWrite(int filterIndex, const std::vector<bool> & v
 	JASPTIMER_SCOPE(DatabaseInterface::filterWrite);
 
 	transactionWriteBegin();
-	
-	int dataSet = filterGetDataSetId(filterIndex);
 
-	const std::string updateFilterPrefix = "UPDATE " + dataSetName(dataSet) + " SET " + filterTableName(filterIndex) + "= ?  WHERE rowNumber = ?;" ;
+	const std::string					packed = _filterPack(values);
+	std::vector<std::pair<size_t, size_t>>	changedRanges; //offset and length in bytes
+	bool								sameSize = false;
 
-	size_t rowOutside;
-	
-	bindParametersType _bindParams = [&](sqlite3_stmt *stmt)
-	{
-		sqlite3_bind_int(stmt, 1, values[rowOutside]);
-		sqlite3_bind_int(stmt, 2, rowOutside+1);
-	};
-	
-	_runStatementsRepeatedly(updateFilterPrefix, [&](bindParametersType ** bindParams, size_t row)
+	//Usually only some rows flipped, so we look for the ranges of bytes that changed
+	runStatements("SELECT rowCount, bits FROM FilterValues WHERE filterId = ?;",
+		[&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, filterIndex); },
+		[&](size_t, sqlite3_stmt * stmt)
+		{
+			const char * stored = static_cast<const char*>(sqlite3_column_blob(stmt, 1));
+			sameSize			= stored && size_t(sqlite3_column_int64(stmt, 0)) == values.size() && size_t(sqlite3_column_bytes(stmt, 1)) == packed.size();
+
+			if(!sameSize)
+				return;
+
+			const size_t mergeGap = 64; //Writing a few unchanged bytes is cheaper than another call
+
+			for(size_t byte=0; byte<packed.size(); byte++)
+				if(packed[byte] != stored[byte])
+				{
+					if(changedRanges.size() && byte - (changedRanges.back().first + changedRanges.back().second) <= mergeGap)
+						changedRanges.back().second = byte + 1 - changedRanges.back().first;
+					else
+						changedRanges.push_back({ byte, 1 });
+				}
+		});
+
+	if(!sameSize)
+		_filterValuesReplace(filterIndex, values);
+	else if(changedRanges.size())
 	{
-		rowOutside = row;
-		(*bindParams) = &_bindParams;
-		
-		return row < values.size();
-	});
+		sqlite3_blob * blob = nullptr;
+
+		if(sqlite3_blob_open(_db, "main", "FilterValues", "bits", filterIndex, 1, &blob) != SQLITE_OK)
+		{
+			sqlite3_blob_close(blob);
+			Log::log() << "Could not open the values of filter #" << filterIndex << " for writing because of: " << sqlite3_errmsg(_db) << std::endl;
+			_filterValuesReplace(filterIndex, values);
+		}
+		else
+		{
+			for(const auto & [offset, length] : changedRanges)
+				if(sqlite3_blob_write(blob, packed.data() + offset, length, offset) != SQLITE_OK)
+				{
+					std::string errorMsg = "Writing the values of filter #" + std::to_string(filterIndex) + " failed because of: " + sqlite3_errmsg(_db);
+					sqlite3_blob_close(blob);
+					Log::log() << errorMsg << std::endl;
+					throw std::runtime_error(errorMsg);
+				}
+
+			sqlite3_blob_close(blob);
+		}
+	}
 
 	filterIncRevision(filterIndex);
 
 	transactionWriteEnd();
 }
 
+void DatabaseInterface::_filterValuesReplace(int filterIndex, const boolvec & values)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_filterValuesReplace);
+
+	const std::string packed = _filterPack(values);
+
+	runStatements("INSERT OR REPLACE INTO FilterValues (filterId, rowCount, bits) VALUES (?, ?, ?);", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(	stmt, 1, filterIndex);
+		sqlite3_bind_int64(	stmt, 2, values.size());
+		sqlite3_bind_blob(	stmt, 3, packed.data(), packed.size(), SQLITE_TRANSIENT);
+	});
+}
+
+std::string DatabaseInterface::_filterPack(const boolvec & values)
+{
+	std::string packed((values.size() + 7) / 8, '\0');
+
+	for(size_t row=0; row<values.size(); row++)
+		if(values[row])
+			packed[row / 8] |= char(1 << (row % 8));
+
+	return packed;
+}
+
+void DatabaseInterface::_filterUnpack(const void * bits, size_t bytes, size_t storedRows, boolvec & values)
+{
+	const unsigned char	*	packed	= static_cast<const unsigned char*>(bits);
+	const size_t			rows	= std::min({ values.size(), storedRows, bytes * 8 });
+
+	for(size_t row=0; row<rows; row++)
+		values[row] = packed[row / 8] & (1 << (row % 8));
+}
+
+void DatabaseInterface::_upgradeFilterValuesToBlobs()
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_upgradeFilterValuesToBlobs);
+
+	std::vector<std::pair<int, int>> filterAndDataSetIds;
+
+	runStatements("SELECT id, dataSet FROM Filters;", [](sqlite3_stmt *){}, [&](size_t, sqlite3_stmt * stmt)
+	{
+		filterAndDataSetIds.push_back({ sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1) });
+	});
+
+	for(const auto & [filterId, dataSetId] : filterAndDataSetIds)
+	{
+		const std::string	column	= filterTableName(filterId),
+							table	= dataSetName(dataSetId);
+
+		if(!tableHasColumn(table, column))
+			continue;
+
+		Log::log() << "Moving values of filter #" << filterId << " from " << table << " to FilterValues" << std::endl;
+
+		boolvec values(dataSetRowCount(dataSetId), true);
+
+		runStatements("SELECT " + column + " FROM " + table + " ORDER BY rowNumber;", [](sqlite3_stmt *){}, [&](size_t row, sqlite3_stmt * stmt)
+		{
+			if(row < values.size())
+				values[row] = sqlite3_column_int(stmt, 0);
+		});
+
+		_filterValuesReplace(filterId, values);
+
+		runStatements("ALTER TABLE " + table + " DROP COLUMN " + column + ";");
+	}
+}
+
 int DatabaseInterface::columnInsert(int dataSetId, int index, const std::string & name, columnType colType, bool alterTable)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnInsert);
@@ -470,16 +593,7 @@ int DatabaseInterface::columnInsert(int dataSetId, int index, const std::string
 #endif
 
 	
-	if(alterTable) //If not then via dataSetCreateTable
-	{
-		//Add a scalar and ordinal/nominal column to DataSet_# for the column
-		const std::string alterDatasetPrefix = "ALTER TABLE " + dataSetName(dataSetId);
-		const std::string addColumnFragment  = " ADD  " + columnBaseName(columnId);
-	
-		runStatements(alterDatasetPrefix + addColumnFragment + "_DBL REAL NULL;");
-		runStatements(alterDatasetPrefix + addColumnFragment + "_INT INT  NULL;");
-	}
-	
+	//The values are stored in ColumnValues as soon as they are set, until then columnGetValues will simply give back empty values.
 	//The labels will be added separately later
 
 	transactionWriteEnd();
@@ -491,12 +605,7 @@ void DatabaseInterface::dataSetCreateTable(DataSet * dataSet)
 	runStatements("DROP TABLE " + dataSetName(dataSet->id()) + ";");
 	
 	std::stringstream statements;
-	statements <<  "CREATE TABLE " + dataSetName(dataSet->id()) + " (rowNumber INTEGER PRIMARY KEY, "+ filterTableName(dataSet->filter()->id()) + " INT NOT NULL DEFAULT 1";
-	
-	for(Column * column : dataSet->columns())
-		statements << ", " << columnBaseName(column->id()) << "_DBL REAL NULL, " << columnBaseName(column->id()) << "_INT INT NULL";
-
-	statements << ");";
+	statements <<  "CREATE TABLE " + dataSetName(dataSet->id()) + " (rowNumber INTEGER PRIMARY KEY);";
 	
 	runStatements(statements.str());
 }
@@ -555,68 +664,75 @@ void DatabaseInterface::dataSetBatchedValuesUpdate(DataSet * data, Columns colum
 
 	transactionWriteBegin();
 
-	//Clear the entire dataset, then insert each row, including filter.
-	// But maybe we should update instead, maybe it speeds up the application?
-	//As this data isnt synced anyway this shouldnt be a problem because it'd be invalidated after a single edit anyway
+	//The DataSet_# table only keeps the rows now, so we just clear it and insert each row again
 	runStatements("DELETE FROM " + dataSetName(data->id()));
 
-	std::stringstream statement;
-	
-	statement << "INSERT INTO " << dataSetName(data->id()) << " (";
+	const std::string insertRow = "INSERT INTO " + dataSetName(data->id()) + " (rowNumber) VALUES (?);";
 
-	//Add columnnames for data we want to insert
-	for(Column * col : columns)
+	//We put a size_t outside the bindParamStore lambda to set it without having to change the signature
+	size_t rowOutside=0;
+	bindParametersType bindRow = [&](sqlite3_stmt * stmt)
 	{
-		assert(col->data() == data); //Little sanity check
-		statement << "Column_" << col->id() << "_DBL"<< ", "  << "Column_" << col->id() << "_INT" << ", ";
-	}
+		sqlite3_bind_int(stmt,	1, rowOutside+1);
+	};
 
-	//And the filtername and rowNumber
-	statement << filterTableName(data->filter()->id()) << ", " << "rowNumber) VALUES (";
+	_runStatementsRepeatedly(
+		insertRow,
+		[&](bindParametersType ** bindParameters, size_t row)
+		{
+			rowOutside = row;
+			(*bindParameters) = &bindRow;
 
-	for(size_t i=0; i<columns.size(); i++)
-		statement << "?, ?, ";
-	statement << "?, ?);"; //filter and rowNumber
+			return row < data->rowCount();
+		});
 
-	//We put a size_t outside the bindParamStore lambda to set it without having to change the signature
-	size_t rowOutside=0;
-	bindParametersType bindParamStore = [&](sqlite3_stmt * stmt)
+	//While the filter goes into FilterValues as a whole
+	_filterValuesReplace(data->filter()->id(), data->filter()->filtered());
+
+	progressCallback(0.1);
+
+	//And then each column gets written as a whole in a single statement, which includes any single values edited before
+	//Only the edits of the columns that are written here though, callers like pasteSpreadsheet pass just the columns they changed
+	const float columnsInverse = 1.0 / float(std::max(size_t(1), columns.size()));
+	
+	size_t colOutside=0;
+	bindParametersType bindColumnId = [&](sqlite3_stmt * stmt)
 	{
-		size_t i=1;
-		for(Column * col : columns)
+		sqlite3_bind_int(stmt, 1, columns[colOutside]->id());
+	};
+
+	_runStatementsRepeatedly(
+		"DELETE FROM ColumnValueEdits WHERE columnId=?;",
+		[&](bindParametersType ** bindParameters, size_t col)
 		{
-			_doubleTroubleBinder(	stmt,	i++, col->dbls()[rowOutside]);
-			sqlite3_bind_int(		stmt,	i++, col->ints()[rowOutside]);
-		}
+			colOutside = col;
+			(*bindParameters) = &bindColumnId;
 
-		sqlite3_bind_int(stmt,	i++, data->filter()->filtered()[rowOutside]);
-		sqlite3_bind_int(stmt,	i++, rowOutside+1);
+			return col < columns.size();
+		});
+	
+	bindParametersType bindColumnValues = [&](sqlite3_stmt * stmt)
+	{
+		Column * col = columns[colOutside];
+		_columnValuesBinder(stmt, 1, col->id(), col->ints(), col->dbls());
 	};
 
-	const float rowsInverse		= 1.0 / float(data->rowCount());
-	const int	updateInterval	= std::max(1, data->rowCount() / 100);
-
 	_runStatementsRepeatedly(
-		statement.str(),
-		[&](bindParametersType ** bindParameters, size_t row)
+		_columnValuesWriteStatement,
+		[&](bindParametersType ** bindParameters, size_t col)
 		{
-			if(row >= data->rowCount())
+			if(col >= columns.size())
 			{
 				progressCallback(1);
 				return false;
 			}
 
-			rowOutside = row;
-
-			static int prevUpdate = 0;
+			assert(columns[col]->data() == data); //Little sanity check
 
-			if(prevUpdate + updateInterval <= rowOutside)
-			{
-				progressCallback(float(rowOutside) * rowsInverse);
-				prevUpdate = rowOutside;
-			}
+			colOutside = col;
+			progressCallback(0.1 + 0.9 * float(col) * columnsInverse);
 
-			(*bindParameters) = &bindParamStore;
+			(*bindParameters) = &bindColumnValues;
 
 			return true;
 		});
@@ -636,115 +752,262 @@ void DatabaseInterface::dataSetBatchedValuesLoad(DataSet *data, std::function<vo
 
 	transactionReadBegin();
 
-	std::stringstream statement;
-
-	statement << "SELECT ";
+	const size_t	rowCount	= dataSetRowCount(data->id());
 
+	std::map<int, Column*> columnById;
 	for(Column * col : data->columns())
-		statement << "Column_" << col->id() << "_INT" << ", Column_" << col->id() << "_DBL, ";
+	{
+		//Columns without a row in ColumnValues are simply empty
+		col->_ints.assign(rowCount, EmptyValues::missingValueInteger);
+		col->_dbls.assign(rowCount, EmptyValues::missingValueDouble);
+		col->labelsTempReset();
+		
+		columnById[col->id()] = col;
+	}
 
-	statement << filterTableName(data->filter()->id()) << " FROM " << dataSetName(data->id()) << " ORDER BY rowNumber";
+	const float columnsInverse = 1.0 / float(std::max(size_t(1), columnById.size()));
+	std::string	corruptColumns;
 
-	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt) {};
+	runStatements("SELECT columnId, rowCount, checksum, ints, dbls FROM ColumnValues WHERE columnId IN (SELECT id FROM Columns WHERE dataSet=?);",
+		[&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, data->id()); },
+		[&](size_t row, sqlite3_stmt * stmt)
+		{
+			int columnId = sqlite3_column_int(stmt, 0);
 
-	const size_t	rowCount	= dataSetRowCount(data->id());
+			if(!columnById.count(columnId))
+				return;
 
-	for(Column * col : data->columns())
-		col->setRowCount(rowCount);
+			Column * col = columnById[columnId];
+			if(!_columnValuesReader(stmt, 1, columnId, rowCount, col->_ints, col->_dbls))
+				corruptColumns += (corruptColumns.empty() ? "" : ", ") + col->name();
 
-	data->filter()->setRowCount(rowCount);
+			progressCallback(0.9 * float(row) * columnsInverse);
+		});
 
-    size_t rowPercent = std::max(1, int(rowCount) / 100);
+	runStatements("SELECT columnId, row, valueInt, valueDbl FROM ColumnValueEdits WHERE columnId IN (SELECT id FROM Columns WHERE dataSet=?);",
+		[&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, data->id()); },
+		[&](size_t, sqlite3_stmt * stmt)
+		{
+			int columnId = sqlite3_column_int(stmt, 0);
 
-	std::function<void(size_t, sqlite3_stmt *stmt)> processRow = [&](size_t row, sqlite3_stmt *stmt)
-	{
-        if(row % rowPercent == 0)
-            progressCallback(float(row) / float(rowCount));
+			if(columnById.count(columnId))
+				_columnValueEditApply(stmt, 1, columnById[columnId]->_ints, columnById[columnId]->_dbls);
+		});
 
-		int colCount = sqlite3_column_count(stmt);
+	if(data->filter()->id() != -1)
+	{
+		//The whole filter comes in a single blob
+		boolvec filtered(rowCount, true);
 
-		assert(colCount == data->columns().size() * 2 + 1);
+		runStatements("SELECT rowCount, bits FROM FilterValues WHERE filterId = ?;",
+			[&](sqlite3_stmt * stmt)				{ sqlite3_bind_int(stmt, 1, data->filter()->id()); },
+			[&](size_t row, sqlite3_stmt * stmt)	{ _filterUnpack(sqlite3_column_blob(stmt, 1), sqlite3_column_bytes(stmt, 1), sqlite3_column_int64(stmt, 0), filtered); });
 
-		for(size_t colI=0; colI<data->columns().size(); colI++)
-		{
-			Column * col = data->columns()[colI];
-			
-			if(!sqlite3_column_text(	stmt, colI*2) && !sqlite3_column_text(	stmt, 1+colI*2)) //If string is NULL then column value is NULL, so empty!
-				col->setValue(row, EmptyValues::missingValueInteger,		EmptyValues::missingValueDouble,		false);
-			else
-				col->setValue(row, sqlite3_column_int(stmt, colI*2),		_doubleTroubleReader(stmt, colI*2 + 1),	false);
-		}
+		data->filter()->setRowCount(rowCount);
 
-		data->filter()->setFilterValueNoDB(row, sqlite3_column_int(stmt, colCount - 1));
-	};
+		for(size_t r=0; r<rowCount; r++)
+			data->filter()->setFilterValueNoDB(r, filtered[r]);
+	}
 
-	runStatements(statement.str(), prepare, processRow);
+	progressCallback(1);
 
 	transactionReadEnd();
+
+	if(!corruptColumns.empty())
+		throw std::runtime_error("The data of the following column(s) is damaged and could not be loaded: " + corruptColumns);
 }
 
 void DatabaseInterface::columnSetValues(int columnId, const intvec &ints, const doublevec &dbls)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnSetValues);
 	transactionWriteBegin();
-	
-	const int			dataSetId = columnGetDataSetId(columnId);
-	
-	const std::string	updateStatement = "UPDATE Dataset_" + std::to_string(dataSetId)	+ " SET Column_"  + std::to_string(columnId) + "_INT=?,  Column_"  + std::to_string(columnId) + "_DBL=? WHERE rowNumber=?";
 
-	size_t				rowOutside;
-	bindParametersType	bindParamStore;
+	runStatements(_columnValuesWriteStatement, [&](sqlite3_stmt * stmt)
+	{
+		_columnValuesBinder(stmt, 1, columnId, ints, dbls);
+	});
 
-	_runStatementsRepeatedly(
-		updateStatement,
-		[&](bindParametersType ** bindParameters, size_t row)
-		{
-			if(row == ints.size())
-				return false;
+	//Everything edited before is in there now
+	runStatements("DELETE FROM ColumnValueEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); });
 
-			rowOutside = row;
+	transactionWriteEnd();
+}
 
-			bindParamStore = [&](sqlite3_stmt * stmt)
-			{
-				sqlite3_bind_int(	stmt,	1, ints[rowOutside]);
-				_doubleTroubleBinder(stmt,	2, dbls[rowOutside]);
-				sqlite3_bind_int(	stmt,	3, rowOutside+1);
-			};
+void DatabaseInterface::columnSetValue(int columnId, size_t row, int valueInt, double valueDbl)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::columnSetValue);
+	transactionWriteBegin();
 
-			(*bindParameters) = &bindParamStore;
+	//Only the edited value is written, columnGetValues and dataSetBatchedValuesLoad put it over the stored column
+	int64_t dblBits;
+	std::memcpy(&dblBits, &valueDbl, sizeof(double)); //Stored as its bits because sqlite turns NaN into NULL
 
-			return true;
-		});
+	runStatements("INSERT OR REPLACE INTO ColumnValueEdits (columnId, row, valueInt, valueDbl) VALUES (?, ?, ?, ?);", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(	stmt, 1, columnId);
+		sqlite3_bind_int64(	stmt, 2, row);
+		sqlite3_bind_int(	stmt, 3, valueInt);
+		sqlite3_bind_int64(	stmt, 4, dblBits);
+	});
+
+	//When a lot of values of a column were edited they go into the stored column, otherwise every read would have to apply them all
+	int edits = runStatementsId("SELECT COUNT(*) FROM ColumnValueEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); });
+
+	if(edits >= _columnValueEditsMax)
+	{
+		intvec		ints;
+		doublevec	dbls;
+
+		columnGetValues(columnId, ints, dbls);
+		columnSetValues(columnId, ints, dbls);
+	}
 
 	transactionWriteEnd();
 }
 
-void DatabaseInterface::columnSetValue(int columnId, size_t row, int valueInt, double valueDbl)
+void DatabaseInterface::_columnValueEditApply(sqlite3_stmt * stmt, int colI, intvec & ints, doublevec & dbls)
 {
-	JASPTIMER_SCOPE(DatabaseInterface::columnSetValue);
-	const int dataSetId = columnGetDataSetId(columnId);
+	const size_t	row		= sqlite3_column_int64(stmt, colI);
+	const int64_t	dblBits	= sqlite3_column_int64(stmt, colI + 2);
+
+	if(row >= ints.size())
+		return; //The dataset got shorter since
+
+	ints[row] = sqlite3_column_int(stmt, colI + 1);
+	std::memcpy(&dbls[row], &dblBits, sizeof(double));
+}
+
+const std::string DatabaseInterface::_columnValuesWriteStatement = "INSERT OR REPLACE INTO ColumnValues (columnId, rowCount, checksum, ints, dbls) VALUES (?, ?, ?, ?, ?);";
+
+std::string DatabaseInterface::_blobCompress(const void * data, size_t bytes)
+{
+	uLongf		compressedSize = compressBound(bytes);
+	std::string compressed(compressedSize, '\0');
+
+	if(compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize, reinterpret_cast<const Bytef*>(data), bytes, Z_BEST_SPEED) != Z_OK)
+		throw std::runtime_error("DatabaseInterface could not compress column values!");
+
+	compressed.resize(compressedSize);
+
+	return compressed;
+}
+
+bool DatabaseInterface::_blobDecompress(const void * blob, size_t blobBytes, void * out, size_t outBytes)
+{
+	if(outBytes == 0)
+		return true;
+
+	if(!blob)
+		return false;
+
+	uLongf outSize = outBytes;
+
+	return uncompress(reinterpret_cast<Bytef*>(out), &outSize, reinterpret_cast<const Bytef*>(blob), blobBytes) == Z_OK && outSize == outBytes;
+}
+
+uint32_t DatabaseInterface::_columnValuesChecksum(const intvec & ints, const doublevec & dbls)
+{
+	uLong crc = crc32(0L, Z_NULL, 0);
 	
-	const std::string updateStatement = "UPDATE Dataset_" + std::to_string(dataSetId)	+ " SET Column_"  + std::to_string(columnId) + "_INT=?,  Column_"  + std::to_string(columnId) + "_DBL=? WHERE rowNumber=?";
+	crc = crc32(crc, reinterpret_cast<const Bytef*>(ints.data()), ints.size() * sizeof(int));
+	crc = crc32(crc, reinterpret_cast<const Bytef*>(dbls.data()), dbls.size() * sizeof(double));
+
+	return crc;
+}
+
+void DatabaseInterface::_columnValuesBinder(sqlite3_stmt * stmt, int param, int columnId, const intvec & ints, const doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnValuesBinder);
+
+	assert(ints.size() == dbls.size());
+
+	//NaN and Inf need no special treatment here as the doubles are stored as is
+	const std::string	intsBlob = _blobCompress(ints.data(), ints.size() * sizeof(int)),
+						dblsBlob = _blobCompress(dbls.data(), dbls.size() * sizeof(double));
 
-	runStatements(updateStatement, [&](sqlite3_stmt * stmt)
+	sqlite3_bind_int(	stmt, param,		columnId);
+	sqlite3_bind_int64(	stmt, param + 1,	dbls.size());
+	sqlite3_bind_int64(	stmt, param + 2,	_columnValuesChecksum(ints, dbls));
+	sqlite3_bind_blob(	stmt, param + 3,	intsBlob.data(), intsBlob.size(), SQLITE_TRANSIENT);
+	sqlite3_bind_blob(	stmt, param + 4,	dblsBlob.data(), dblsBlob.size(), SQLITE_TRANSIENT);
+}
+
+bool DatabaseInterface::_columnValuesReader(sqlite3_stmt * stmt, int colI, int columnId, size_t rowCount, intvec & ints, doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnValuesReader);
+
+	const int64_t	storedRows	= sqlite3_column_int64(stmt, colI);
+	const uint32_t	checksum	= sqlite3_column_int64(stmt, colI + 1);
+
+	//zlib does not compress better than 1032:1, so a larger rowCount than that can only come from a damaged row and should not be allocated
+	const bool		plausible	= storedRows >= 0 && size_t(storedRows) * sizeof(double) <= 1032 * size_t(sqlite3_column_bytes(stmt, colI + 3)) + 1024;
+
+	if(plausible)
 	{
-		sqlite3_bind_int(		stmt,	1, valueInt);
-		_doubleTroubleBinder(	stmt,	2, valueDbl);
-		sqlite3_bind_int(		stmt,	3, row+1);
-	});
+		ints.resize(storedRows);
+		dbls.resize(storedRows);
+	}
+
+	if(		!plausible
+		||	!_blobDecompress(sqlite3_column_blob(stmt, colI + 2), sqlite3_column_bytes(stmt, colI + 2), ints.data(), storedRows * sizeof(int))
+		||	!_blobDecompress(sqlite3_column_blob(stmt, colI + 3), sqlite3_column_bytes(stmt, colI + 3), dbls.data(), storedRows * sizeof(double))
+		||	checksum != _columnValuesChecksum(ints, dbls))
+	{
+		//Throwing from here would leave the statement and the transaction open, so the callers report it once they are done reading
+		Log::log() << "Values of column #" << columnId << " in the internal database are corrupt!" << std::endl;
+
+		ints.assign(rowCount, EmptyValues::missingValueInteger);
+		dbls.assign(rowCount, EmptyValues::missingValueDouble);
+
+		return false;
+	}
+
+	//The rowcount of the dataset might have changed since the column was written, in that case we pad with empty values or cut off the superfluous ones
+	ints.resize(rowCount, EmptyValues::missingValueInteger);
+	dbls.resize(rowCount, EmptyValues::missingValueDouble);
+
+	return true;
 }
 
-void DatabaseInterface::_doubleTroubleBinder(sqlite3_stmt * stmt, int param, double dbl)
+void DatabaseInterface::_upgradeColumnValuesToBlobs()
 {
-	JASPTIMER_SCOPE(DatabaseInterface::_doubleTroubleBinder);
-	
-	if(std::isnan(dbl)	|| std::isinf(dbl))
+	JASPTIMER_SCOPE(DatabaseInterface::_upgradeColumnValuesToBlobs);
+
+	std::vector<std::pair<int, int>> columnAndDataSetIds;
+
+	runStatements("SELECT id, dataSet FROM Columns;", [](sqlite3_stmt *){}, [&](size_t, sqlite3_stmt * stmt)
+	{
+		columnAndDataSetIds.push_back({ sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1) });
+	});
+
+	for(const auto & [columnId, dataSetId] : columnAndDataSetIds)
 	{
-		const std::string storeThis = dbDblToString(std::isnan(dbl) ? dbDbl::nan : dbl < 0 ? dbDbl::neg_inf : dbDbl::inf);
-		sqlite3_bind_text(stmt, param, storeThis.c_str(), storeThis.size(), SQLITE_TRANSIENT);
+		const std::string	base	= columnBaseName(columnId),
+							table	= dataSetName(dataSetId);
+
+		if(!tableHasColumn(table, base + "_DBL"))
+			continue;
+
+		Log::log() << "Moving values of column #" << columnId << " from " << table << " to ColumnValues" << std::endl;
+
+		const size_t	rowCount = dataSetRowCount(dataSetId);
+		intvec			ints(rowCount, EmptyValues::missingValueInteger);
+		doublevec		dbls(rowCount, EmptyValues::missingValueDouble);
+
+		runStatements("SELECT " + base + "_INT, " + base + "_DBL FROM " + table + " ORDER BY rowNumber;", [](sqlite3_stmt *){}, [&](size_t row, sqlite3_stmt * stmt)
+		{
+			if(row >= rowCount || (!sqlite3_column_text(stmt, 0) && !sqlite3_column_text(stmt, 1))) //If string is NULL then column value is NULL, so empty!
+				return;
+
+			ints[row] = sqlite3_column_int(stmt, 0);
+			dbls[row] = _doubleTroubleReader(stmt, 1);
+		});
+
+		columnSetValues(columnId, ints, dbls);
+
+		runStatements("ALTER TABLE " + table + " DROP COLUMN " + base + "_DBL;");
+		runStatements("ALTER TABLE " + table + " DROP COLUMN " + base + "_INT;");
 	}
-	else
-		sqlite3_bind_double(stmt, param, dbl);
 }
 
 double DatabaseInterface::_doubleTroubleReader(sqlite3_stmt * stmt, int colI)
@@ -826,29 +1089,26 @@ void DatabaseInterface::columnGetValues(int columnId, intvec & ints, doublevec &
 	JASPTIMER_SCOPE(DatabaseInterface::columnGetValues);
 	transactionReadBegin();
 
-	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt)
-	{
-		sqlite3_bind_int(stmt, 1, columnId);
-	};
-
-	int				dataSet		= columnGetDataSetId(columnId);
-	const size_t	rowCount	= dataSetRowCount(dataSet);
+	const size_t	rowCount	= dataSetRowCount(columnGetDataSetId(columnId));
 
-	ints.resize(rowCount);
+	//If nothing was stored yet the column is simply empty
+	ints.assign(rowCount, EmptyValues::missingValueInteger);
+	dbls.assign(rowCount, EmptyValues::missingValueDouble);
 
-	std::function<void(size_t, sqlite3_stmt *stmt)> processRow = [&](size_t row, sqlite3_stmt *stmt)
-	{
-		int colCount = sqlite3_column_count(stmt);
+	bool corrupt = false;
 
-		assert(colCount == 2);
+	runStatements("SELECT rowCount, checksum, ints, dbls FROM ColumnValues WHERE columnId=?;", 
+		[&](sqlite3_stmt *stmt)					{ sqlite3_bind_int(stmt, 1, columnId); }, 
+		[&](size_t row, sqlite3_stmt *stmt)		{ corrupt = !_columnValuesReader(stmt, 0, columnId, rowCount, ints, dbls); });
 
-		ints[row] = sqlite3_column_int(		stmt, 0);
-		dbls[row] = _doubleTroubleReader(	stmt, 1);
-	};
-
-	runStatements("SELECT " + columnBaseName(columnId) + "_INT, " + columnBaseName(columnId) + "_DBL FROM " + dataSetName(dataSet) + " ORDER BY rowNumber;", prepare, processRow);
+	runStatements("SELECT row, valueInt, valueDbl FROM ColumnValueEdits WHERE columnId=?;", 
+		[&](sqlite3_stmt *stmt)					{ sqlite3_bind_int(stmt, 1, columnId); }, 
+		[&](size_t row, sqlite3_stmt *stmt)		{ _columnValueEditApply(stmt, 0, ints, dbls); });
 
 	transactionReadEnd();
+
+	if(corrupt)
+		throw std::runtime_error("The data of column #" + std::to_string(columnId) + " is damaged and could not be loaded.");
 }
 
 std::string DatabaseInterface::columnBaseName(int columnId) const
@@ -876,6 +1136,13 @@ int DatabaseInterface::dataSetIncRevision(int dataSetId)
 				runStatements(	"UPDATE DataSets SET revision=revision+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM DataSets				WHERE id=?;", prepare);
 
+	//Keep the log short, whoever is further behind than this will just reload everything
+	runStatements("DELETE FROM DataSetChanges WHERE dataSet=? AND revision < ?;", [&](sqlite3_stmt *stmt)
+	{
+		sqlite3_bind_int(stmt, 1, dataSetId);
+		sqlite3_bind_int(stmt, 2, rev - changeLogDepth);
+	});
+
 	transactionWriteEnd();
 
 	return rev;
@@ -893,6 +1160,62 @@ int DatabaseInterface::dataSetGetFilter(int dataSetId)
 	return runStatementsId("SELECT id FROM Filters WHERE dataSet=? LIMIT 1;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 }
 
+void DatabaseInterface::changeLogAdd(int dataSetId, dataSetBaseNodeType nodeType, int nodeId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::changeLogAdd);
+
+	const std::string nodeTypeStr = dataSetBaseNodeTypeToString(nodeType);
+
+	runStatements("INSERT INTO DataSetChanges (dataSet, revision, nodeType, nodeId) SELECT id, revision, ?, ? FROM DataSets WHERE id=?;", [&](sqlite3_stmt *stmt)
+	{
+		sqlite3_bind_text(stmt, 1, nodeTypeStr.c_str(), nodeTypeStr.length(), SQLITE_TRANSIENT);
+		sqlite3_bind_int(stmt,	2, nodeId);
+		sqlite3_bind_int(stmt,	3, dataSetId);
+	});
+}
+
+void DatabaseInterface::changeLogAddColumn(int columnId)
+{
+	changeLogAdd(columnGetDataSetId(columnId), dataSetBaseNodeType::column, columnId);
+}
+
+void DatabaseInterface::changeLogAddFilter(int filterIndex)
+{
+	changeLogAdd(filterGetDataSetId(filterIndex), dataSetBaseNodeType::filter, filterIndex);
+}
+
+bool DatabaseInterface::changeLogSince(int dataSetId, int revision, intset & columnIds, bool & filterChanged)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::changeLogSince);
+
+	columnIds.clear();
+	filterChanged = false;
+
+	transactionReadBegin();
+
+	bool	everything	= dataSetGetRevision(dataSetId) - revision > changeLogDepth;
+
+	if(!everything)
+		runStatements("SELECT nodeType, nodeId FROM DataSetChanges WHERE dataSet=? AND revision >= ?;", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, dataSetId);
+			sqlite3_bind_int(stmt, 2, revision);
+		},
+		[&](size_t row, sqlite3_stmt *stmt)
+		{
+			switch(dataSetBaseNodeTypeFromString(_wrap_sqlite3_column_text(stmt, 0)))
+			{
+			case dataSetBaseNodeType::column:	columnIds.insert(sqlite3_column_int(stmt, 1));	break;
+			case dataSetBaseNodeType::filter:	filterChanged = true;							break;
+			default:							everything = true;								break;
+			}
+		});
+
+	transactionReadEnd();
+
+	return !everything;
+}
+
 std::string DatabaseInterface::filterTableName(int filterIndex) const
 {
 	JASPTIMER_SCOPE(DatabaseInterface::filterName);
@@ -908,15 +1231,16 @@ void DatabaseInterface::columnDelete(int columnId, bool cleanUpRest)
 	int dataSetId	= columnGetDataSetId(columnId),
 		columnIndex	= columnIndexForId(columnId);
 
-	if(cleanUpRest)
+	//Drop the values
+	runStatements("DELETE FROM ColumnValues WHERE columnId=?;", [&](sqlite3_stmt * stmt)
 	{
+		sqlite3_bind_int(stmt,	1, columnId);
+	});
 
-		const std::string & alterDatasetPrefix = "ALTER TABLE Dataset_"  + std::to_string(dataSetId)	+ " ";
-		const std::string & addColumnFragment  = "DROP COLUMN  " + columnBaseName(columnId);
-
-		runStatements(alterDatasetPrefix + addColumnFragment + "_DBL;");
-		runStatements(alterDatasetPrefix + addColumnFragment + "_INT;");
-	}
+	runStatements("DELETE FROM ColumnValueEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt,	1, columnId);
+	});
 
 	//Delete column entry
 	runStatements("DELETE FROM Columns WHERE dataSet=? AND id=?;", [&](sqlite3_stmt * stmt)
@@ -986,6 +1310,8 @@ int DatabaseInterface::columnIncRevision(int columnId)
 				runStatements(	"UPDATE Columns SET revision=revision+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM Columns			WHERE id=?;", prepare);
 
+	changeLogAddColumn(columnId);
+
 	transactionWriteEnd();
 
 	return rev;
@@ -1429,6 +1755,7 @@ void DatabaseInterface::dataSetDelete(int dataSetId)
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetDelete);
 	transactionWriteBegin();
 	runStatements("DELETE FROM DataSets WHERE id = " + std::to_string(dataSetId) + ";");
+	runStatements("DELETE FROM DataSetChanges WHERE dataSet = " + std::to_string(dataSetId) + ";");
 	runStatements("DROP TABLE " + dataSetName(dataSetId) + ";");
 	transactionWriteEnd();
 }
@@ -2,6 +2,7 @@
 #define DATABASEINTERFACE_H
 
 #include "columntype.h"
+#include "datasetbasenode.h"
 #include <sqlite3.h>
 #include <string>
 #include "utils.h"
@@ -26,15 +27,24 @@ class DatabaseInterface;
 /// Whenever a dataset is created it gets its own entry in DataSets describing it
 /// and also a table named as for instance: DataSet_0 is created.
 ///
-/// This DataSet_# table intially only contains a default filter column (for which an entry is made in Filters)
+/// This DataSet_# table has a row per row of data and nothing else, it only keeps track of the number of rows.
 ///
 /// Then when columns are loaded/added each gets an entry in Columns describing it.
-/// DataSet_# then also adds 2 columns for each actual column, both initially filled with NULLs
-/// An integers column for ordinal and nominal(text) columns, and basically any future column with labels (those labels might be integers)
-/// A double column for scalar columns, and perhaps later monetary or time related columns
+/// The values of a column are stored as a whole in ColumnValues, one row per column with two compressed BLOBs:
+/// The integers, used for ordinal and nominal(text) columns, and basically any future column with labels (those labels might be integers)
+/// The doubles, used for scalar columns, and perhaps later monetary or time related columns
+/// Both are stored as the raw (little-endian) vectors, compressed with zlib and checked with a crc32 over the uncompressed values.
+/// A column without an entry in ColumnValues is simply empty.
 ///
-/// As values are set they can be stored value for value (during manual editing) or bulked.
-/// This is then represented in the linked column(s) in DataSet_#
+/// A column set as a whole is written and read in a single statement.
+/// Values edited one by one (during manual editing) are written to ColumnValueEdits instead, a row per value that is put over the stored column when reading it.
+/// Setting the whole column again clears its edits, which also happens once a column has _columnValueEditsMax of them.
+/// Jasp files from before this was introduced have Column_#_DBL and Column_#_INT in DataSet_#, upgradeDBFromVersion moves those over.
+///
+/// The results of a filter (for which an entry is made in Filters) are stored in FilterValues, as a packed bitset of one bit per row.
+/// This BLOB is not compressed, so that filterWrite can overwrite only the bytes that changed in place and filterSelect reads it in one go.
+/// A filter without an entry in FilterValues lets all rows through, as do any rows past its rowCount.
+/// These also used to be stored in DataSet_# as Filter_#, upgradeDBFromVersion moves those over as well.
 /// 
 /// The tables DataSets, Filters and Columns all have a field "revision"
 /// This is incremented whenever a change is made. So if a single value in a column changes
@@ -45,11 +55,18 @@ class DatabaseInterface;
 /// they also have a "revision" field and so they can, and do, regurlarly check for it to synchronise
 /// their loaded data.
 /// 
+/// Because a DataSets revision++ says nothing about *what* changed, every revision++ also adds a row to DataSetChanges.
+/// Such a row records which column or filter changed while the dataset was at a particular revision, or that the whole dataset did.
+/// This allows the other side to reload only what actually changed, see changeLogSince() and DataSet::checkForUpdates().
+/// Only the last changeLogDepth revisions are kept, anything older means reloading the whole DataSet.
+/// 
 /// General table structure (an example with a single dataset and support for a single filter
 /// 
-/// DataSets [ id, info... ] -> DataSet_1 [ row, Filter_1, Column_1_INT, Column_1_DBL, Column_2_int, ... ]
-///		|---------------------> Filters [id, info...] 
+/// DataSets [ id, info... ] -> DataSet_1 [ row ]
+///		|---------------------> Filters [id, info...] -> FilterValues [ filterId, rowCount, bits ]
 ///		|---------------------> Column  [id, info...] -> Labels [ id, columnId, info... ]
+///		                                              -> ColumnValues [ columnId, rowCount, checksum, ints, dbls ]
+///		                                              -> ColumnValueEdits [ columnId, row, valueInt, valueDbl ]
 /// 
 class DatabaseInterface
 {
@@ -76,9 +93,9 @@ public:
 	int			dataSetGetId();
 	bool		dataSetExists(			int dataSetId);
 	void		dataSetDelete(			int dataSetId);
-	int			dataSetInsert(							const std::string & dataFilePath = "", long dataFileTimestamp = 0, const std::string & description = "", const std::string & databaseJson = "", const std::string & emptyValuesJson = "", bool dataSynch = false);		///< Inserts a new DataSet row into DataSets and creates an empty DataSet_#id. returns id
-	void		dataSetUpdate(			int dataSetId,	const std::string & dataFilePath = "", long dataFileTimestamp = 0, const std::string & description = "", const std::string & databaseJson = "", const std::string & emptyValuesJson = "", bool dataSynch = false);		///< Updates an existing DataSet row in DataSets
-	void		dataSetLoad(			int dataSetId,		  std::string & dataFilePath,	long & dataFileTimestamp,		 std::string & description,			   std::string & databaseJson,			  std::string & emptyValuesJson, int & revision, bool & dataSynch);	///< Loads an existing DataSet row into arguments
+	int			dataSetInsert(							const std::string & dataFilePath = "", long dataFileTimestamp = 0, const std::string & description = "", const std::string & databaseJson = "", const std::string & emptyValuesJson = "", bool dataSynch = false, const std::string & dataFileFingerprint = "");		///< Inserts a new DataSet row into DataSets and creates an empty DataSet_#id. returns id
+	void		dataSetUpdate(			int dataSetId,	const std::string & dataFilePath = "", long dataFileTimestamp = 0, const std::string & description = "", const std::string & databaseJson = "", const std::string & emptyValuesJson = "", bool dataSynch = false, const std::string & dataFileFingerprint = "");		///< Updates an existing DataSet row in DataSets
+	void		dataSetLoad(			int dataSetId,		  std::string & dataFilePath,	long & dataFileTimestamp,		 std::string & description,			   std::string & databaseJson,			  std::string & emptyValuesJson, int & revision, bool & dataSynch, std::string & dataFileFingerprint);	///< Loads an existing DataSet row into arguments
 	static int	dataSetColCount(		int dataSetId);
 	static int	dataSetRowCount(		int dataSetId);
 	void		dataSetSetRowCount(		int dataSetId, size_t rowCount);
@@ -92,13 +109,20 @@ public:
 	void		dataSetBatchedValuesUpdate(DataSet * data, std::vector<Column*> columns, std::function<void(float)> progressCallback = [](float){});
 	void		dataSetBatchedValuesUpdate(DataSet * data, std::function<void(float)> progressCallback = [](float){});
 
+	//Change log
+	static const int changeLogDepth = 256;
+	void		changeLogAdd(			int dataSetId, dataSetBaseNodeType nodeType, int nodeId = -1);						///< Records a change made while dataSetId is at its current revision, dataSetBaseNodeType::dataSet means anything could have changed
+	void		changeLogAddColumn(		int columnId);
+	void		changeLogAddFilter(		int filterIndex);
+	bool		changeLogSince(			int dataSetId, int revision, intset & columnIds, bool & filterChanged);				///< Collects the columns and filter changed since revision, returns false if the whole dataset must be reloaded
+
 	//Filters
-	std::string filterTableName(		int filterIndex) const;
+	std::string filterTableName(		int filterIndex) const;																				///< Name of the column in DataSet_# older jasp files kept the values of the filter in
 	int			filterGetId(			int dataSetId);
 	int			filterGetId(			const std::string & name);
-	bool		filterSelect(			int filterIndex,			boolvec & bools);																	///< Loads result and errorMsg and returns whether there was a change in either of those.
-	void		filterWrite(			int filterIndex,	const	boolvec & values);																	///< Overwrites the current filter values, no checks are done on the size. If too few the rest is TRUE nd superfluous bools are ignored.
-	int			filterInsert(			int dataSetId,		const std::string & rFilter = "", const std::string & generatedFilter = "", const std::string & constructorJson = "", const std::string & constructorR = "", const std::string & name = "");		///< Inserts a new Filter row into Filters and creates an empty FilterValues_#id. It returns id
+	bool		filterSelect(			int filterIndex,			boolvec & bools);																	///< Loads the result into bools (resized to the rowcount of the dataset) and returns whether anything changed
+	void		filterWrite(			int filterIndex,	const	boolvec & values);																	///< Overwrites the current filter values, only the bytes that changed are written if the size stays the same. Rows past values are TRUE.
+	int			filterInsert(			int dataSetId,		const std::string & rFilter = "", const std::string & generatedFilter = "", const std::string & constructorJson = "", const std::string & constructorR = "", const std::string & name = "");		///< Inserts a new Filter row into Filters, it lets everything through until filterWrite is called. It returns id
 	void		filterUpdate(			int filterIndex,	const std::string & rFilter = "", const std::string & generatedFilter = "", const std::string & constructorJson = "", const std::string & constructorR = "", const std::string & name = "");		///< Updates an existing Filter row in Filters
 	void		filterLoad(				int filterIndex,		  std::string & rFilter,			std::string & generatedFilter,			  std::string & constructorJson,			std::string & constructorR, int & revision, std::string & name);			///< Loads an existing Filter row into arguments
 	void		filterClear(			int filterIndex);																					///< Clears all values in Filter
@@ -112,7 +136,7 @@ public:
 
 	//Columns & Data/Values
 	//Index stuff:
-	int			columnInsert(			int dataSetId, int index = -1, const std::string & name = "", columnType colType = columnType::unknown, bool alterTable=true);	///< Insert a row into Columns and create the corresponding columns in DataSet_? Also makes sure the indices are correct
+	int			columnInsert(			int dataSetId, int index = -1, const std::string & name = "", columnType colType = columnType::unknown, bool alterTable=true);	///< Insert a row into Columns and makes sure the indices are correct. alterTable is no longer needed as values live in ColumnValues
 	int			columnLastFreeIndex(	int dataSetId);
 	void		columnIndexIncrements(	int dataSetId, int index);																			///< If index already is in use that column and all after are incremented by 1
 	void		columnIndexDecrements(	int dataSetId, int index);																			///< Indices bigger than index are decremented, assumption is that the previous one using it has been removed already
@@ -136,7 +160,7 @@ public:
 	void		columnSetComputedInfo(		int columnId, int analysisId,  bool   invalidated, computedColumnType   codeType, const	std::string & rCode, const	std::string & error, const	std::string & constructorJson);
 	void		columnGetComputedInfo(		int columnId, int &analysisId, bool & invalidated, computedColumnType & codeType,		std::string & rCode,		std::string & error,		Json::Value & constructorJson);
 	void		columnSetValues(			int columnId, const intvec	  & ints, const doublevec & dbls);
-	void		columnSetValue(				int columnId, size_t row, int valueInt, double valueDbl);
+	void		columnSetValue(				int columnId, size_t row, int valueInt, double valueDbl);	///< Only writes this value to ColumnValueEdits
 	intvec		columnGetLabelIds(			int columnId);
 	size_t		columnGetLabelCount(		int columnId);
 	void		columnGetValues(			int columnId,	intvec		& ints, doublevec & dbls);
@@ -161,8 +185,20 @@ public:
 	void		transactionReadEnd();							///< runs COMMIT and ends the transaction. Tracks whether nested and only does BEGIN+COMMIT at lowest depth
 		
 private:
-	void		_doubleTroubleBinder(sqlite3_stmt *stmt, int param, double dbl);	///< Needed to work around the lack of support for NAN, INF and NEG_INF in sqlite, converts those to string to make use of sqlite flexibility
-	double		_doubleTroubleReader(sqlite3_stmt *stmt, int colI);					///< The reading counterpart to _doubleTroubleBinder to convert string representations of NAN, INF and NEG_INF back to double
+	double		_doubleTroubleReader(sqlite3_stmt *stmt, int colI);					///< Converts the string representations of NAN, INF and NEG_INF that older jasp files stored in DataSet_# back to double
+	void		_columnValuesBinder(sqlite3_stmt *stmt, int param, int columnId, const intvec & ints, const doublevec & dbls);					///< Binds all parameters of _columnValuesWriteStatement starting at param
+	bool		_columnValuesReader(sqlite3_stmt *stmt, int colI,  int columnId, size_t rowCount, intvec & ints, doublevec & dbls);			///< Reads rowCount, checksum, ints and dbls starting at colI and makes sure the vectors have rowCount values. Returns false and leaves them empty if the data is corrupt
+	void		_columnValueEditApply(sqlite3_stmt *stmt, int colI, intvec & ints, doublevec & dbls);										///< Puts the row, valueInt and valueDbl starting at colI in ints and dbls
+	void		_upgradeColumnValuesToBlobs();																								///< Moves any Column_#_DBL/_INT from DataSet_# tables to ColumnValues
+	void		_upgradeFilterValuesToBlobs();																								///< Moves any Filter_# from DataSet_# tables to FilterValues
+	void		_filterValuesReplace(int filterIndex, const boolvec & values);															///< Writes the whole bitset of a filter, without incrementing its revision
+	
+	static std::string	_filterPack(	const boolvec & values);
+	static void			_filterUnpack(	const void * bits, size_t bytes, size_t storedRows, boolvec & values);						///< values keeps its size, anything not stored is TRUE
+	
+	static std::string	_blobCompress(			const void * data, size_t bytes);
+	static bool			_blobDecompress(		const void * blob, size_t blobBytes, void * out, size_t outBytes);
+	static uint32_t		_columnValuesChecksum(	const intvec & ints, const doublevec & dbls);
 	void		_runStatements(				const std::string & statements,						std::function<void(sqlite3_stmt *stmt)> *	bindParameters = nullptr,	std::function<void(size_t row, sqlite3_stmt *stmt)> *	processRow = nullptr);	///< Runs several sql statements without looking at the results. Unless processRow is not NULL, then this is called for each row.
 	void		_runStatementsRepeatedly(	const std::string & statements, std::function<bool(	std::function<void(sqlite3_stmt *stmt)> **	bindParameters, size_t row)> bindParameterFactory, std::function<void(size_t row, size_t repetition, sqlite3_stmt *stmt)> * processRow = nullptr);
 
@@ -177,7 +213,9 @@ private:
 	sqlite3	*	_db = nullptr;
 
 	static			std::string _wrap_sqlite3_column_text(sqlite3_stmt * stmt, int iCol);
-	static const	std::string _dbConstructionSql;
+	static const	std::string _dbConstructionSql,
+								_columnValuesWriteStatement;
+	static const	int			_columnValueEditsMax = 1024;	///< Beyond this many edits columnSetValue writes the whole column again
 
 
 	static DatabaseInterface * _singleton;
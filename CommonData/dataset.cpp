@@ -4,8 +4,10 @@
 #include "dataset.h"
 #include "jsonutilities.h"
 #include "databaseinterface.h"
+#include "columnarsegment.h"
 
-stringset DataSet::_defaultEmptyvalues;
+bool		DataSet::_publishesColumnarSegment = false;
+stringset	DataSet::_defaultEmptyvalues;
 
 DataSet::DataSet(int index)
 	: DataSetBaseNode(dataSetBaseNodeType::dataSet, nullptr)
@@ -36,6 +38,8 @@ DataSet::~DataSet()
 	_emptyValues	= nullptr;
 	_dataNode		= nullptr;
 	_filter			= nullptr;
+
+	ColumnarSegment::remove(_publishedSegment);
 	
 	
 }
@@ -59,6 +63,9 @@ void DataSet::dbDelete()
 
 	_dataSetID = -1;
 
+	ColumnarSegment::remove(_publishedSegment);
+	_publishedSegment.clear();
+
 	
 	db().transactionWriteEnd();
 }
@@ -66,7 +73,8 @@ void DataSet::dbDelete()
 void DataSet::beginBatchedToDB()
 {
 	assert(!_writeBatchedToDB);
-	_writeBatchedToDB = true;
+	_writeBatchedToDB		= true;
+	_batchedWholeChanged	= false;
 }
 
 void DataSet::endBatchedToDB(std::function<void(float)> progressCallback, Columns columns)
@@ -74,11 +82,23 @@ void DataSet::endBatchedToDB(std::function<void(float)> progressCallback, Column
 	assert(_writeBatchedToDB);
 	_writeBatchedToDB = false;
 	
+	const bool onlySomeColumns = columns.size() > 0 && !_batchedWholeChanged;
+
 	if(columns.size() == 0)
 		columns = _columns;
 
+	db().transactionWriteBegin();
+
 	db().dataSetBatchedValuesUpdate(this, columns, progressCallback);
-	incRevision(); //Should trigger reload at engine end
+
+	//If only the values of some columns changed the engines only need to reload those
+	if(onlySomeColumns)
+		for(Column * column : columns)
+			db().changeLogAdd(_dataSetID, dataSetBaseNodeType::column, column->id());
+
+	_incRevision(!onlySomeColumns); //Should trigger reload at engine end
+
+	db().transactionWriteEnd();
 }
 
 int DataSet::getColumnIndex(const std::string & name) const 
@@ -226,7 +246,7 @@ void DataSet::dbCreate()
 	db().transactionWriteBegin();
 
 	//The variables are probably empty though:
-	_dataSetID	= db().dataSetInsert(_dataFilePath, _dataFileTimestamp, _description, _databaseJson, _emptyValues->toJson().toStyledString(), _dataFileSynch);
+	_dataSetID	= db().dataSetInsert(_dataFilePath, _dataFileTimestamp, _description, _databaseJson, _emptyValues->toJson().toStyledString(), _dataFileSynch, _dataFileFingerprint);
 	_filter = new Filter(this);
 	_filter->dbCreate();
 	_columns.clear();
@@ -239,7 +259,7 @@ void DataSet::dbCreate()
 void DataSet::dbUpdate()
 {
 	assert(_dataSetID > 0);
-	db().dataSetUpdate(_dataSetID, _dataFilePath, _dataFileTimestamp, _description, _databaseJson, _emptyValues->toJson().toStyledString(), _dataFileSynch);
+	db().dataSetUpdate(_dataSetID, _dataFilePath, _dataFileTimestamp, _description, _databaseJson, _emptyValues->toJson().toStyledString(), _dataFileSynch, _dataFileFingerprint);
 	incRevision();
 }
 
@@ -264,7 +284,7 @@ void DataSet::dbLoad(int index, std::function<void(float)> progressCallback, boo
 
 	std::string emptyVals;
 
-	db().dataSetLoad(_dataSetID, _dataFilePath, _dataFileTimestamp, _description, _databaseJson, emptyVals, _revision, _dataFileSynch);
+	db().dataSetLoad(_dataSetID, _dataFilePath, _dataFileTimestamp, _description, _databaseJson, emptyVals, _revision, _dataFileSynch, _dataFileFingerprint);
 	progressCallback(0.1);
 
 	if(!_filter)
@@ -293,7 +313,8 @@ void DataSet::dbLoad(int index, std::function<void(float)> progressCallback, boo
 
 	_columns.resize(colCount);
 
-	db().dataSetBatchedValuesLoad(this, [&](float p){ progressCallback(0.5 + p * 0.5); });
+	if(_publishesColumnarSegment || !ColumnarSegment::load(this))
+		db().dataSetBatchedValuesLoad(this, [&](float p){ progressCallback(0.5 + p * 0.5); });
 	
 	Json::Value emptyValsJson;
 	Json::Reader().parse(emptyVals, emptyValsJson);
@@ -421,10 +442,32 @@ void DataSet::incRevision()
 	assert(_dataSetID != -1);
 
 	if(!writeBatchedToDB())
+		_incRevision(true);
+	else
+		_batchedWholeChanged = true;
+}
+
+void DataSet::_incRevision(bool wholeDataSetChanged)
+{
+	db().transactionWriteBegin();
+
+	if(wholeDataSetChanged)
+		db().changeLogAdd(_dataSetID, dataSetBaseNodeType::dataSet);
+
+	_revision = db().dataSetIncRevision(_dataSetID);
+
+	db().transactionWriteEnd();
+
+	if(_publishesColumnarSegment)
 	{
-		_revision = db().dataSetIncRevision(_dataSetID);
-		checkForChanges();
+		const std::string previous	= _publishedSegment;
+		_publishedSegment			= ColumnarSegment::publish(this);
+
+		if(previous != _publishedSegment)
+			ColumnarSegment::remove(previous);
 	}
+
+	checkForChanges();
 }
 
 bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved, bool * newColumns, bool * rowCountChanged)
@@ -438,10 +481,12 @@ bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved,
 	for(Column * col : _columns)
 		prevCols.insert(col->name());
 	
-	size_t rowCountPrev = rowCount();
+	size_t	rowCountPrev	= rowCount();
+	int		dbRevision		= db().dataSetGetRevision(_dataSetID);
+	intset	changedColumnIds;
+	bool	filterChanged	= false;
 	
-		
-	if(_revision != db().dataSetGetRevision(_dataSetID))
+	if(_revision != dbRevision && !db().changeLogSince(_dataSetID, _revision, changedColumnIds, filterChanged))
 	{
 		dbLoad();
 		
@@ -468,16 +513,32 @@ bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved,
 	}
 	else
 	{
-		bool somethingChanged = _filter->checkForUpdates();
+		//Either the revision of the dataset didnt change or the change log tells us exactly which columns and/or filter did
+		_revision = dbRevision;
+		
+		bool somethingChanged = filterChanged || _filter->checkForUpdates();
+		
+		if(filterChanged)
+			_filter->dbLoad();
+
+		if(colsChanged)
+			colsChanged->clear();
 
 		for(Column * col : _columns)
-			if(col->checkForUpdates())
+		{
+			bool colChanged = changedColumnIds.count(col->id());
+			
+			if(colChanged)	col->dbLoad();
+			else			colChanged = col->checkForUpdates();
+			
+			if(colChanged)
 			{
 				somethingChanged = true;
 
 				if(colsChanged)
 					colsChanged->push_back(col->name());
 			}
+		}
 		
 		if(colsRemoved)
 			colsRemoved->clear();
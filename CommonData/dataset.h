@@ -29,8 +29,12 @@ public:
 			bool			dataFileSynch()			const { return _dataFileSynch;			}
 	const	std::string &	dataFilePath()			const { return _dataFilePath;			}
 			int				dataFileTimestamp()		const { return _dataFileTimestamp;		}
+	const	std::string &	dataFileFingerprint()	const { return _dataFileFingerprint;	}
 	const	std::string &	databaseJson()			const { return _databaseJson;			}
 			bool			writeBatchedToDB()		const { return _writeBatchedToDB;		}
+	const	std::string &	publishedSegment()		const { return _publishedSegment;		}
+
+	static	void			setPublishesColumnarSegment(bool publishes) { _publishesColumnarSegment = publishes; } ///< Should only be true for Desktop, the engines read from the segment instead
 
 			void			dbCreate();
 			void			dbUpdate();
@@ -58,6 +62,7 @@ public:
 			void			setDataFile( const std::string & dataFilePath, long timestamp)	{ _dataFilePath	= dataFilePath;	_dataFileTimestamp = timestamp; dbUpdate(); }
 			void			setDatabaseJson(	const std::string & databaseJson)	{ _databaseJson		= databaseJson;			dbUpdate(); }
 			void			setDataFileSynch(	bool synchronizing)					{ _dataFileSynch	= synchronizing;		dbUpdate(); }
+			void			setDataFileFingerprint(const std::string & fingerprint)	{ _dataFileFingerprint = fingerprint;		dbUpdate(); }
 
 			void			setColumnCount(	size_t colCount);
 			void			setRowCount(	size_t rowCount);
@@ -85,6 +90,7 @@ public:
 
 private:			
 			void					upgradeTo019(const Json::Value & emptyVals);
+			void					_incRevision(bool wholeDataSetChanged);
 			void					setEmptyValuesJsonOldStuff(	const Json::Value & emptyValues);
 			
 			
@@ -98,10 +104,14 @@ private:
 								_rowCount				= -1;
 	long						_dataFileTimestamp		= 0;
 	std::string					_dataFilePath,
-								_databaseJson;
+								_dataFileFingerprint,	///< Hashes of the blocks of the datafile as it was last read, see DataFileFingerprint in Desktop
+								_databaseJson,
+								_publishedSegment;		///< Name of the ColumnarSegment last published for this dataset, if any
 	
 	bool						_writeBatchedToDB		= false,
+								_batchedWholeChanged	= false,	///< Set when incRevision() was called during a batch, so endBatchedToDB knows more than just some column values changed
 								_dataFileSynch			= false;
+	static bool					_publishesColumnarSegment;
 	static stringset			_defaultEmptyvalues;	// Default empty values if workspace do not have its own empty values (used for backward compatibility)
 	std::string					_description;
 };
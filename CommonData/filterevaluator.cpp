@@ -0,0 +1,334 @@
+#include "filterevaluator.h"
+#include "dataset.h"
+#include "timers.h"
+#include <cmath>
+
+bool FilterEvaluator::rFilterOnlyUsesGenerated(const std::string & rFilter)
+{
+	const std::string	stripped	= stringUtils::stripRComments(rFilter),
+						whitespace	= " \t\r\n";
+	size_t				begin		= stripped.find_first_not_of(whitespace),
+						end			= stripped.find_last_not_of(whitespace);
+
+	return begin != std::string::npos && stripped.substr(begin, end + 1 - begin) == "generatedFilter";
+}
+
+bool FilterEvaluator::canEvaluate(const std::string & rFilter, const std::string & constructorJson)
+{
+	JASPTIMER_SCOPE(FilterEvaluator::canEvaluate);
+
+	if(!_data || !_data->filter() || !rFilterOnlyUsesGenerated(rFilter))
+		return false;
+
+	Json::Value json;
+	if(!Json::Reader().parse(constructorJson, json) || !json.isObject() || !json["formulas"].isArray())
+		return false;
+
+	for(const Json::Value & formula : json["formulas"])
+		if(!_checkLogical(formula))
+			return false;
+
+	return true;
+}
+
+boolvec FilterEvaluator::evaluate(const std::string & constructorJson)
+{
+	JASPTIMER_SCOPE(FilterEvaluator::evaluate);
+
+	_rowCount = _data->rowCount();
+
+	Json::Value json;
+	Json::Reader().parse(constructorJson, json);
+
+	logicvec result(_rowCount, Logic::True);
+
+	auto andInto = [&](const logicvec & clause)
+	{
+		for(size_t row=0; row<_rowCount; row++)
+			if(result[row] != Logic::False)
+				result[row] = clause[row] == Logic::False ? Logic::False : clause[row] == Logic::NA ? Logic::NA : result[row];
+	};
+
+	for(Column * column : _data->columns())
+		if(column->hasFilter())
+			andInto(_labelFilter(column));
+
+	for(const Json::Value & formula : json["formulas"])
+		andInto(_logical(formula));
+
+	boolvec	filtered(_rowCount, false);
+	bool	atLeastOneRow = false;
+
+	for(size_t row=0; row<_rowCount; row++)
+		if(result[row] == Logic::True)
+			filtered[row] = atLeastOneRow = true;
+
+	if(!atLeastOneRow)
+		throw std::runtime_error("Filtered out all data.");
+
+	return filtered;
+}
+
+bool FilterEvaluator::_isComparison(const std::string & op)
+{
+	return op == "==" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">=";
+}
+
+Column * FilterEvaluator::_column(const Json::Value & node)
+{
+	//A column with a changed type is read as columnName.type in R, we leave those to R
+	if(node.get("columnTypeUser", -1).asInt() != -1)
+		return nullptr;
+
+	return _data->column(node.get("columnName", "").asString());
+}
+
+bool FilterEvaluator::_checkLogical(const Json::Value & node)
+{
+	if(!node.isObject())
+		return false;
+
+	const std::string nodeType = node.get("nodeType", "").asString();
+
+	if(nodeType == "Operator" || nodeType == "OperatorVertical")
+	{
+		const std::string op = node.get("operator", "").asString();
+
+		if(op == "&" || op == "|")
+			return _checkLogical(node["leftArgument"]) && _checkLogical(node["rightArgument"]);
+
+		Operand::Kind left, right;
+
+		return _isComparison(op) && _checkOperand(node["leftArgument"], left) && _checkOperand(node["rightArgument"], right) && _checkCompare(op, left, right);
+	}
+
+	if(nodeType == "Function")
+	{
+		const std::string	functionName	= node.get("functionName", "").asString();
+		const Json::Value &	arguments		= node["arguments"];
+
+		if(!arguments.isArray() || arguments.size() != 1 || !arguments[0].isObject())
+			return false;
+
+		const Json::Value & argument = arguments[0]["argument"];
+		Operand::Kind		kind;
+
+		if(functionName == "!")		return _checkLogical(argument);
+		if(functionName == "is.na")	return _checkLogical(argument) || _checkOperand(argument, kind);
+	}
+
+	return false;
+}
+
+bool FilterEvaluator::_checkOperand(const Json::Value & node, Operand::Kind & kind)
+{
+	if(!node.isObject())
+		return false;
+
+	const std::string nodeType = node.get("nodeType", "").asString();
+
+	if(nodeType == "Number")	{ kind = Operand::Kind::Number;	return node["value"].isNumeric();	}
+	if(nodeType == "String")	{ kind = Operand::Kind::Text;	return node["text"].isString();		}
+
+	if(nodeType == "Column")
+	{
+		Column * column = _column(node);
+
+		if(!column)
+			return false;
+
+		switch(column->type())
+		{
+		case columnType::scale:		kind = Operand::Kind::Number;	return true;
+		case columnType::nominal:
+		case columnType::ordinal:	kind = Operand::Kind::Levels;	return true;
+		default:													return false;
+		}
+	}
+
+	return false;
+}
+
+bool FilterEvaluator::_checkCompare(const std::string & op, Operand::Kind left, Operand::Kind right) const
+{
+	typedef Operand::Kind Kind;
+
+	if(left == Kind::Number && right == Kind::Number)
+		return true;
+
+	//Ordering of factors and strings depends on levels and locale in R and comparing two factors fails on different levels, so only equality against a string
+	return (op == "==" || op == "!=") && (left == Kind::Text || right == Kind::Text) && left != Kind::Number && right != Kind::Number;
+}
+
+FilterEvaluator::logicvec FilterEvaluator::_logical(const Json::Value & node)
+{
+	const std::string nodeType = node["nodeType"].asString();
+
+	if(nodeType == "Operator" || nodeType == "OperatorVertical")
+	{
+		const std::string op = node["operator"].asString();
+
+		if(op == "&" || op == "|")
+		{
+			logicvec	left	= _logical(node["leftArgument"]),
+						right	= _logical(node["rightArgument"]);
+			bool		isAnd	= op == "&";
+			Logic		decides	= isAnd ? Logic::False : Logic::True;
+
+			for(size_t row=0; row<_rowCount; row++)
+				left[row] = left[row] == decides || right[row] == decides	? decides
+						  : left[row] == Logic::NA || right[row] == Logic::NA	? Logic::NA
+						  : isAnd ? Logic::True : Logic::False;
+
+			return left;
+		}
+
+		return _compare(op, _operand(node["leftArgument"]), _operand(node["rightArgument"]));
+	}
+
+	//So it must be a function
+	const std::string	functionName	= node["functionName"].asString();
+	const Json::Value &	argument		= node["arguments"][0]["argument"];
+
+	if(functionName == "!")
+	{
+		logicvec result = _logical(argument);
+
+		for(Logic & value : result)
+			if(value != Logic::NA)
+				value = value == Logic::True ? Logic::False : Logic::True;
+
+		return result;
+	}
+
+	//is.na
+	logicvec result(_rowCount, Logic::False);
+
+	if(_checkLogical(argument))
+	{
+		logicvec values = _logical(argument);
+
+		for(size_t row=0; row<_rowCount; row++)
+			result[row] = values[row] == Logic::NA ? Logic::True : Logic::False;
+
+		return result;
+	}
+
+	Operand operand = _operand(argument);
+
+	for(size_t row=0; row<_rowCount; row++)
+		switch(operand.kind)
+		{
+		case Operand::Kind::Number:	result[row] = std::isnan(operand.numbers[operand.numbers.size() == 1 ? 0 : row])		? Logic::True : Logic::False;	break;
+		case Operand::Kind::Levels:	result[row] = operand.levelIndices[row] == EmptyValues::missingValueInteger				? Logic::True : Logic::False;	break;
+		case Operand::Kind::Text:																													break;
+		}
+
+	return result;
+}
+
+FilterEvaluator::Operand FilterEvaluator::_operand(const Json::Value & node)
+{
+	const std::string	nodeType = node["nodeType"].asString();
+	Operand				operand;
+
+	if(nodeType == "Number")
+	{
+		operand.kind	= Operand::Kind::Number;
+		operand.numbers	= { node["value"].asDouble() };
+	}
+	else if(nodeType == "String")
+	{
+		operand.kind	= Operand::Kind::Text;
+		operand.text	= node["text"].asString();
+	}
+	else
+	{
+		Column * column = _column(node);
+
+		if(column->type() == columnType::scale)
+		{
+			operand.kind	= Operand::Kind::Number;
+			operand.numbers	= column->dataAsRDoubles({});
+		}
+		else
+		{
+			operand.kind	= Operand::Kind::Levels;
+			operand.levels	= column->dataAsRLevels(operand.levelIndices, {}, true);
+		}
+	}
+
+	return operand;
+}
+
+FilterEvaluator::logicvec FilterEvaluator::_compare(const std::string & op, const Operand & left, const Operand & right) const
+{
+	typedef Operand::Kind Kind;
+
+	logicvec result(_rowCount, Logic::NA);
+
+	if(left.kind == Kind::Number)
+	{
+		auto value = [&](const Operand & operand, size_t row) { return operand.numbers[operand.numbers.size() == 1 ? 0 : row]; };
+
+		for(size_t row=0; row<_rowCount; row++)
+		{
+			double	l = value(left, row),
+					r = value(right, row);
+
+			if(std::isnan(l) || std::isnan(r))
+				continue;
+
+			bool	passes	=	op == "==" ? l == r
+							:	op == "!=" ? l != r
+							:	op == "<"  ? l <  r
+							:	op == "<=" ? l <= r
+							:	op == ">"  ? l >  r
+							:				 l >= r;
+
+			result[row] = passes ? Logic::True : Logic::False;
+		}
+
+		return result;
+	}
+
+	//Only == and != are left, between a string and either a string or a column with levels
+	const bool		equal	= op == "==";
+	const Operand &	text	= left.kind == Kind::Text ? left  : right,
+				 &	other	= left.kind == Kind::Text ? right : left;
+
+	if(other.kind == Kind::Text)
+		return logicvec(_rowCount, (text.text == other.text) == equal ? Logic::True : Logic::False);
+
+	int level = -1;
+	for(size_t i=0; i<other.levels.size(); i++)
+		if(other.levels[i] == text.text)
+			level = i;
+
+	for(size_t row=0; row<_rowCount; row++)
+		if(other.levelIndices[row] != EmptyValues::missingValueInteger)
+			result[row] = (other.levelIndices[row] == level) == equal ? Logic::True : Logic::False;
+
+	return result;
+}
+
+FilterEvaluator::logicvec FilterEvaluator::_labelFilter(Column * column) const
+{
+	//A row passes if its label is allowed, values without a label are never filtered out by it and missing values never pass (they are NA in R)
+	std::map<int, bool> allowedByIntsId;
+
+	for(const Label * label : column->labels())
+		allowedByIntsId[label->intsId()] = label->filterAllows() && !label->isEmptyValue();
+
+	const intvec	&	ints	= column->ints();
+	const doublevec	&	dbls	= column->dbls();
+	logicvec			result(_rowCount, Logic::False);
+
+	for(size_t row=0; row<_rowCount; row++)
+		if(ints[row] == Label::DOUBLE_LABEL_VALUE)
+			result[row] = !column->isEmptyValue(dbls[row])											? Logic::True : Logic::False;
+		else
+			result[row] = allowedByIntsId.count(ints[row]) && allowedByIntsId.at(ints[row])		? Logic::True : Logic::False;
+
+	return result;
+}
@@ -0,0 +1,67 @@
+#ifndef FILTEREVALUATOR_H
+#define FILTEREVALUATOR_H
+
+#include <json/json.h>
+#include "utils.h"
+
+class DataSet;
+class Column;
+
+///
+/// Runs the filters that do not need R directly on the columns of a DataSet
+///
+/// The label filters are taken straight from the Label::filterAllows of the labels referred to by the _ints of every column that hasFilter().
+/// Of the drag and drop filter (Filter::constructorJson) the following subset is supported:
+///  - Columns (without a changed type), Numbers and Strings
+///  - Comparisons (== != < <= > >=) between scale columns and/or numbers
+///  - == and != between a nominal or ordinal column and a string, or between two strings
+///  - The boolean operators & and |, and the functions ! and is.na
+///
+/// The results are the same as R would give, so comparing with a missing value gives NA and a row that ends up NA does not pass.
+/// Anything else, like arithmetic, other functions or an R filter that does more than return generatedFilter, still needs to go through R.
+/// Use canEvaluate() to find out which it is.
+/// (The drag and drop filter has no %in%, choosing multiple values of a column is what the label filters are for.)
+class FilterEvaluator
+{
+public:
+					FilterEvaluator(DataSet * data) : _data(data) {}
+
+	bool			canEvaluate(const std::string & rFilter, const std::string & constructorJson);
+	boolvec			evaluate(	const std::string & constructorJson);					///< Throws a std::runtime_error if no row passes, just like the filter in R would
+
+	static bool		rFilterOnlyUsesGenerated(const std::string & rFilter);				///< True if rFilter, ignoring comments and whitespace, is just "generatedFilter"
+
+private:
+	///Three-valued logic like R has
+	enum class Logic : char { False = 0, True = 1, NA = 2 };
+	typedef std::vector<Logic> logicvec;
+
+	///Something that can be compared, for Levels levelIndices refers to levels (or is EmptyValues::missingValueInteger)
+	struct Operand
+	{
+		enum class Kind { Number, Text, Levels };
+
+		Kind		kind;
+		doublevec	numbers;		///< One value for a constant, NaN means missing
+		std::string	text;
+		intvec		levelIndices;
+		stringvec	levels;
+	};
+
+	bool			_checkLogical(	const Json::Value & node);
+	bool			_checkOperand(	const Json::Value & node, Operand::Kind & kind);
+	bool			_checkCompare(	const std::string & op, Operand::Kind left, Operand::Kind right) const;
+
+	logicvec		_logical(		const Json::Value & node);
+	Operand			_operand(		const Json::Value & node);
+	logicvec		_compare(		const std::string & op, const Operand & left, const Operand & right) const;
+	logicvec		_labelFilter(	Column * column) const;
+
+	Column		*	_column(		const Json::Value & node);
+	static bool		_isComparison(	const std::string & op);
+
+	DataSet		*	_data		= nullptr;
+	size_t			_rowCount	= 0;
+};
+
+#endif // FILTEREVALUATOR_H
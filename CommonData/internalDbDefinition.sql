@@ -4,6 +4,7 @@ CREATE TABLE DataSets (
 	id				INTEGER PRIMARY KEY, 
 	dataFilePath	TEXT, 
 	dataFileTimestamp INT DEFAULT 0,
+	dataFileFingerprint TEXT,
 	description		TEXT,
 	databaseJson	TEXT, 
 	emptyValuesJson TEXT, 
@@ -62,3 +63,47 @@ CREATE TABLE Labels
 	
 	FOREIGN KEY(columnId) REFERENCES Columns(id)
 );
+
+-- The values of columns and filters used to be Column_#_DBL, Column_#_INT and Filter_# in the DataSet_# tables.
+-- They now live in ColumnValues and FilterValues and the old columns are dropped on upgrade, so a jasp file saved by this version cannot be opened by older versions of JASP.
+CREATE TABLE ColumnValues
+(
+	columnId			INTEGER PRIMARY KEY,
+	rowCount			INT,
+	checksum			INT,
+	ints				BLOB,
+	dbls				BLOB,
+
+	FOREIGN KEY(columnId) REFERENCES Columns(id)
+);
+
+CREATE TABLE ColumnValueEdits
+(
+	columnId			INT,
+	row					INT,
+	valueInt			INT,
+	valueDbl			INT,
+
+	PRIMARY KEY(columnId, row),
+	FOREIGN KEY(columnId) REFERENCES Columns(id)
+);
+
+CREATE TABLE FilterValues
+(
+	filterId			INTEGER PRIMARY KEY,
+	rowCount			INT,
+	bits				BLOB,
+
+	FOREIGN KEY(filterId) REFERENCES Filters(id)
+);
+
+CREATE TABLE DataSetChanges
+(
+	id					INTEGER PRIMARY KEY,
+	dataSet				INT,
+	revision			INT,
+	nodeType			TEXT,
+	nodeId				INT		NULL,
+
+	FOREIGN KEY(dataSet) REFERENCES DataSets(id)
+);
@@ -22,6 +22,7 @@
 #include "log.h"
 #include "utils.h"
 #include "dirs.h"
+#include <cstring>
 
 #ifdef BOOST_INTERPROCESS_SHARED_DIR_FUNC
 namespace boost {
@@ -46,7 +47,8 @@ IPCChannel::IPCChannel(std::string name, size_t channelNumber, bool isSlave)
 	  _nameMtS(			name + "_MasterToSlave"						),
 	  _nameStM(			name + "_SlaveToMaster"						),
 	  _channelNumber(	channelNumber								),
-	  _isSlave(			isSlave										)
+	  _isSlave(			isSlave										),
+	  _sendTimeoutMs(	isSlave ? 30000 : 1000						)
 {
 	Log::log() << "IPCChannel(" << name << ", " << channelNumber << ", " << (isSlave ? "slave" : "master") << ");" << std::endl;
 
@@ -56,10 +58,7 @@ IPCChannel::IPCChannel(std::string name, size_t channelNumber, bool isSlave)
 									   : new interprocess::managed_shared_memory(interprocess::open_only,		_baseName.c_str());
 
 	if(!_isSlave)
-	{
-		_sizeMtoS				= _memoryControl->find_or_construct<size_t>("sizeMasterToSlave")(1024 * 1024 * 8);
-		_sizeStoM				= _memoryControl->find_or_construct<size_t>("sizeSlaveToMaster")(1024 * 1024 * 8);
-	}
+		findConstructSizes();
 	else
 		catchAndRepeat("Finding sizes if communication channels", [&]()
 		{
@@ -95,55 +94,37 @@ IPCChannel::IPCChannel(std::string name, size_t channelNumber, bool isSlave)
 
 	generateNames();
 
-	Log::log() << "Finding/constructing mutexes" << std::endl;
-
-	if(!_isSlave)	findConstructMutexes();
-	else
-		catchAndRepeat("Finding mutexes", [&]()
-		{
-			auto mutexesIn  = _memoryControl->find<interprocess::interprocess_mutex>(_mutexInName.c_str());
-			auto mutexesOut = _memoryControl->find<interprocess::interprocess_mutex>(_mutexOutName.c_str());
-
-			if(mutexesIn.first  == nullptr)	throw std::runtime_error("Couldn't find mutex in for IPCChannel...");
-			if(mutexesOut.first == nullptr)	throw std::runtime_error("Couldn't find mutex out for IPCChannel...");
-
-			_mutexIn	= mutexesIn.first;
-			_mutexOut	= mutexesOut.first;
-		});
-
 	_memoryIn	= _isSlave ? _memoryMasterToSlave : _memorySlaveToMaster;
 	_memoryOut	= _isSlave ? _memorySlaveToMaster : _memoryMasterToSlave;
 
 	_sizeIn		= _isSlave ? _sizeMtoS : _sizeStoM;
 	_sizeOut	= _isSlave ? _sizeStoM : _sizeMtoS;
 
-	_previousSizeIn  = *_sizeIn;
-	_previousSizeOut = *_sizeOut;
-
 	if(!_isSlave)
-		findConstructDataStrings();
+		findConstructRings();
 	else
-		catchAndRepeat("Finding communication strings", [&]()
+		catchAndRepeat("Finding communication rings", [&]()
 		{
 			Log::log() << "Opening " << _dataInName << std::endl;
-			auto foundDataIn  = _memoryIn ->find<String>(_dataInName.c_str());
+			auto foundRingIn	= _memoryIn ->find<RingState>(_dataInName.c_str());
+			auto foundBytesIn	= _memoryIn ->find<char>((_dataInName + "_bytes").c_str());
 
 			Log::log() << "Opening " << _dataOutName << std::endl;
-			auto foundDataOut = _memoryOut->find<String>(_dataOutName.c_str());
+			auto foundRingOut	= _memoryOut->find<RingState>(_dataOutName.c_str());
+			auto foundBytesOut	= _memoryOut->find<char>((_dataOutName + "_bytes").c_str());
 
-			if(foundDataIn.first == nullptr)	throw std::runtime_error("Couldn't find data in for IPCChannel...");
-			if(foundDataOut.first == nullptr)	throw std::runtime_error("Couldn't find data out for IPCChannel...");
+			if(foundRingIn.first  == nullptr || foundBytesIn.first  == nullptr)	throw std::runtime_error("Couldn't find ring in for IPCChannel...");
+			if(foundRingOut.first == nullptr || foundBytesOut.first == nullptr)	throw std::runtime_error("Couldn't find ring out for IPCChannel...");
 
-			_dataIn	 = foundDataIn.first;  //It could actually be an array, but of course, this would just take the first one and we ignore the rest.
-			_dataOut = foundDataOut.first;
-
-			if(foundDataIn.second > 1 || foundDataOut.second > 1)
-				Log::log() << "More than 1 (in: " << foundDataIn.second << " out: " << foundDataOut.second << ") data String found in IPCChannel startup on engine." << std::endl;
+			_ringIn		= foundRingIn.first;
+			_bytesIn	= foundBytesIn.first;
+			_ringOut	= foundRingOut.first;
+			_bytesOut	= foundBytesOut.first;
 		});
 
 #ifdef __APPLE__
-	_semaphoreIn  = sem_open(_mutexInName.c_str(),  O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
-	_semaphoreOut = sem_open(_mutexOutName.c_str(), O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
+	_semaphoreIn  = sem_open(_semaphoreInName.c_str(),  O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
+	_semaphoreOut = sem_open(_semaphoreOutName.c_str(), O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
 
 	if (isSlave == false)
 	{
@@ -176,16 +157,16 @@ IPCChannel::IPCChannel(std::string name, size_t channelNumber, bool isSlave)
 
 	if (_isSlave == false)
 	{
-		interprocess::named_semaphore::remove(_mutexInName.c_str());
-		interprocess::named_semaphore::remove(_mutexOutName.c_str());
+		interprocess::named_semaphore::remove(_semaphoreInName.c_str());
+		interprocess::named_semaphore::remove(_semaphoreOutName.c_str());
 
-		_semaphoreIn  = new interprocess::named_semaphore(interprocess::create_only, _mutexInName.c_str(), 0);
-		_semaphoreOut = new interprocess::named_semaphore(interprocess::create_only, _mutexOutName.c_str(), 0);
+		_semaphoreIn  = new interprocess::named_semaphore(interprocess::create_only, _semaphoreInName.c_str(), 0);
+		_semaphoreOut = new interprocess::named_semaphore(interprocess::create_only, _semaphoreOutName.c_str(), 0);
 	}
 	else
 	{
-		_semaphoreIn  = new interprocess::named_semaphore(interprocess::open_only, _mutexInName.c_str());
-		_semaphoreOut = new interprocess::named_semaphore(interprocess::open_only, _mutexOutName.c_str());
+		_semaphoreIn  = new interprocess::named_semaphore(interprocess::open_only, _semaphoreInName.c_str());
+		_semaphoreOut = new interprocess::named_semaphore(interprocess::open_only, _semaphoreOutName.c_str());
 	}
 
 
@@ -200,31 +181,47 @@ void IPCChannel::findConstructSizes()
 	_sizeStoM	= _memoryControl->find_or_construct<size_t>("sizeSlaveToMaster")(1024 * 1024 * 8);
 }
 
-
-void IPCChannel::findConstructMutexes()
+void IPCChannel::findConstructRings()
 {
-	_mutexIn  = _memoryControl->find_or_construct<interprocess::interprocess_mutex>(_mutexInName.c_str())();
-	_mutexOut = _memoryControl->find_or_construct<interprocess::interprocess_mutex>(_mutexOutName.c_str())();
-}
+	Log::log() << "Finding/constructing communication rings" << std::endl;
 
+	//Half of the segment leaves more than enough room for the bookkeeping of boost
+	auto findConstruct = [&](interprocess::managed_shared_memory * memory, const std::string & name, size_t segmentSize, RingState *& ring, char *& bytes)
+	{
+		Log::log() << "Creating " << name << std::endl;
 
-void IPCChannel::findConstructDataStrings()
-{
-	Log::log() << "Finding/constructing communication strings" << std::endl;
+		const size_t capacity = (segmentSize / 2) - (segmentSize / 2) % sizeof(FrameHeader);
 
-	Log::log() << "Creating " << _dataInName << std::endl;
-	_dataIn		= _memoryIn ->find_or_construct<String>(_dataInName.c_str())	(_memoryIn ->get_segment_manager());
+		ring	= memory->find_or_construct<RingState>(name.c_str())(capacity);
+		bytes	= memory->find_or_construct<char>((name + "_bytes").c_str())[ring->capacity](0);
+	};
 
-	Log::log() << "Creating " << _dataOutName << std::endl;
-	_dataOut	= _memoryOut->find_or_construct<String>(_dataOutName.c_str())	(_memoryOut->get_segment_manager());
+	findConstruct(_memoryIn,	_dataInName,	*_sizeIn,	_ringIn,	_bytesIn);
+	findConstruct(_memoryOut,	_dataOutName,	*_sizeOut,	_ringOut,	_bytesOut);
 }
 
 void IPCChannel::findConstructAllAgain()
 {
 	Log::log() << "Finding/constructing all relevant shared memory objects again." << std::endl;
 	findConstructSizes();
-	findConstructMutexes();
-	findConstructDataStrings();
+	findConstructRings();
+
+	//Whatever a previous engine left behind is of no use to the next one
+	discardUnreadOut();
+	discardUnreadIn();
+}
+
+void IPCChannel::discardUnreadOut()
+{
+	_ringOut->head = _ringOut->tail.load();
+}
+
+void IPCChannel::discardUnreadIn()
+{
+	_ringIn->tail = _ringIn->head.load();
+
+	_partialIn	.clear();
+	_receivedIn	.clear();
 }
 
 void IPCChannel::catchAndRepeat(const std::string & taskDescription, std::function<void()> doThis)
@@ -286,93 +283,96 @@ IPCChannel::~IPCChannel()
 
 void IPCChannel::generateNames()
 {
-	stringstream mutexInName, mutexOutName, dataInName, dataOutName, semaphoreInName, semaphoreOutName;
+	stringstream dataInName, dataOutName, semaphoreInName, semaphoreOutName;
 
 	std::string in  = _isSlave ? "-s" : "-m";
 	std::string out = _isSlave ? "-m" : "-s";
 
 	dataInName			<< _baseName << in  << 'd' << _channelNumber;
 	dataOutName			<< _baseName << out << 'd' << _channelNumber;
-	mutexInName			<< _baseName << in  << 'm' << _channelNumber;
-	mutexOutName		<< _baseName << out << 'm' << _channelNumber;
 	semaphoreInName		<< _baseName << in  << 's' << _channelNumber;
 	semaphoreOutName	<< _baseName << out << 's' << _channelNumber;
 
 	_semaphoreOutName	= semaphoreOutName.str();
 	_semaphoreInName	= semaphoreInName.str();
-	_mutexOutName		= mutexOutName.str();
-	_mutexInName		= mutexInName.str();
 	_dataOutName		= dataOutName.str();
 	_dataInName			= dataInName.str();
 }
 
-void IPCChannel::rebindMemoryInIfSizeChanged()
+void IPCChannel::writeOut(uint64_t position, const char * data, size_t bytes)
 {
-	if(_previousSizeIn < *_sizeIn)
-	{
-		Log::log() << "rebindMemoryInIfSizeChanged! Size changed!\n" << std::flush;
+	const size_t	start	= position % _ringOut->capacity,
+					first	= std::min(bytes, size_t(_ringOut->capacity - start));
 
-		delete _memoryIn;
-		_previousSizeIn = *_sizeIn;
-		_memoryIn		= new interprocess::managed_shared_memory(interprocess::open_only, _isSlave ? _nameMtS.c_str() : _nameStM.c_str());
+	memcpy(_bytesOut + start, data, first);
+	memcpy(_bytesOut, data + first, bytes - first);
+}
 
-		if(_isSlave)	_memoryMasterToSlave	= _memoryIn;
-		else			_memorySlaveToMaster	= _memoryIn;
+void IPCChannel::readIn(uint64_t position, char * data, size_t bytes) const
+{
+	const size_t	start	= position % _ringIn->capacity,
+					first	= std::min(bytes, size_t(_ringIn->capacity - start));
 
-		_dataIn = _memoryIn->find<String>(_dataInName.c_str()).first;
-	}
+	memcpy(data, _bytesIn + start, first);
+	memcpy(data + first, _bytesIn, bytes - first);
 }
 
-void IPCChannel::doubleMemoryOut()
+bool IPCChannel::waitForSpaceOut(size_t bytes)
 {
-	Log::log() << "IPCChannel::doubleMemoryOut is called and new memsize: ";
+	const long	waitMs	= _sendTimeoutMs,
+				started	= Utils::currentMillis();
 
-	std::string memOutName = _isSlave ? _nameStM : _nameMtS;
+	while(_ringOut->capacity - (_ringOut->head.load(std::memory_order_relaxed) - _ringOut->tail.load(std::memory_order_acquire)) < bytes)
+	{
+		if(Utils::currentMillis() > started + waitMs)
+			return false;
 
-	_memoryOut->destroy<String>(_dataOutName.c_str());
+		postOut(); //Just in case the reader missed something
+		Utils::sleep(1);
+	}
 
-	if(!interprocess::managed_shared_memory::grow(memOutName.c_str(), *_sizeOut))
-		throw std::runtime_error("Growing IPCChannel failed!");
+	return true;
+}
 
-	_memoryOut = new interprocess::managed_shared_memory(interprocess::open_only, memOutName.c_str());
+bool IPCChannel::send(const std::string & data)
+{
+	const size_t	headerSize		= sizeof(FrameHeader),
+					maxFrameBytes	= _ringOut->capacity / 4 - headerSize;
+	size_t			sent			= 0;
 
-	if(_isSlave)	_memorySlaveToMaster = _memoryOut;
-	else			_memoryMasterToSlave = _memoryOut;
+	do
+	{
+		FrameHeader header;
+		header.bytes = std::min(data.size() - sent, maxFrameBytes);
+		header.flags = (sent == 0 ? FrameHeader::firstOfMessage : 0) | (sent + header.bytes == data.size() ? FrameHeader::lastOfMessage : 0);
 
-	_dataOut	= _memoryOut->construct<String>(_dataOutName.c_str())(_memoryOut->get_segment_manager());
-	*_sizeOut	= _memoryOut->get_size();
+		const size_t frameSize = headerSize + header.bytes + (headerSize - header.bytes % headerSize) % headerSize;
 
-	Log::log() << *_sizeOut << "\n" << std::flush;
-}
+		if(!waitForSpaceOut(frameSize))
+		{
+			Log::log()	<< "IPCChannel(" << _baseName << ", " << _channelNumber << ", " << (_isSlave ? "slave" : "master") << "): "
+						<< "IPCChannel::send gave up waiting for the other side to read, the message is dropped." << std::endl;
+			return false;
+		}
 
-void IPCChannel::send(string &&data, bool alreadyLockedMutex)
-{
-	send(data, alreadyLockedMutex);
-}
+		const uint64_t head = _ringOut->head.load(std::memory_order_relaxed);
 
+		writeOut(head,				reinterpret_cast<const char*>(&header),	headerSize);
+		writeOut(head + headerSize,	data.data() + sent,						header.bytes);
 
-void IPCChannel::send(string &data, bool alreadyLockedMutex)
-{
-	try
-	{
-		if(!alreadyLockedMutex)
-			_mutexOut->lock();
-		_dataOut->assign(data.begin(), data.end());
-	}
-	catch (boost::interprocess::bad_alloc &e)	{ goto retryAfterDoublingMemory; }
-	catch (std::length_error &e)				{ goto retryAfterDoublingMemory; }
-	catch (boost::interprocess::interprocess_exception &e)
-	{
-		Log::log()	<< "IPCChannel(" << _baseName << ", " << _channelNumber << ", " << (_isSlave ? "slave" : "master") << "): "
-					<< "IPCChannel::send encountered an exception trying to acquire the lock: " << e.what() << std::endl;
-		throw e;
-	}
-	catch (std::exception & e)
-	{
-		Log::log() << "IPCChannel::send encountered an exception: " << e.what() << std::endl;
-		throw e; //no need to unlock because this will crash stuff
+		_ringOut->head.store(head + frameSize, std::memory_order_release);
+
+		postOut();
+
+		sent += header.bytes;
 	}
+	while(sent < data.size());
 
+	return true;
+}
+
+void IPCChannel::postOut()
+{
 #ifdef __APPLE__
 	sem_post(_semaphoreOut);
 #elif defined _WIN32
@@ -380,44 +380,71 @@ void IPCChannel::send(string &data, bool alreadyLockedMutex)
 #else
 	_semaphoreOut->post();
 #endif
+}
 
+void IPCChannel::readFramesIn()
+{
+	const size_t	headerSize	= sizeof(FrameHeader);
+	const uint64_t	head		= _ringIn->head.load(std::memory_order_acquire);
+	uint64_t		tail		= _ringIn->tail.load(std::memory_order_relaxed);
 
-	_mutexOut->unlock();
-	return; // return here to avoid going to retryAfterDoublingMemory
+	while(tail < head)
+	{
+		FrameHeader header;
+		readIn(tail, reinterpret_cast<char*>(&header), headerSize);
 
-retryAfterDoublingMemory:
-		Log::log() << "IPCChannel::send out buffer is too small!\n" << std::flush;
+		//A sender that died halfway through a message leaves the start of it behind, the next message starts fresh
+		if(header.flags & FrameHeader::firstOfMessage)
+			_partialIn.clear();
 
-		doubleMemoryOut();
+		const size_t offset = _partialIn.size();
+		_partialIn.resize(offset + header.bytes);
+		readIn(tail + headerSize, _partialIn.data() + offset, header.bytes);
 
-		send(data, true); //try again!
+		tail += headerSize + header.bytes + (headerSize - header.bytes % headerSize) % headerSize;
+
+		if(header.flags & FrameHeader::lastOfMessage)
+		{
+			_receivedIn.push_back(std::move(_partialIn));
+			_partialIn.clear();
+		}
+	}
+
+	_ringIn->tail.store(tail, std::memory_order_release);
+}
+
+bool IPCChannel::sendMessage(const Json::Value & message)
+{
+	return send(_codec->encode(message));
 }
 
 bool IPCChannel::receive(string &data, int timeout)
 {
-	if (tryWait(timeout))
+	try
 	{
-		_mutexIn->lock();
+		if(_receivedIn.empty())
+			readFramesIn();
 
-		while (tryWait()); // clear it completely
-
-		try
-		{
-			rebindMemoryInIfSizeChanged();
-			data.assign(_dataIn->c_str(), _dataIn->size());
-		}
-		catch(std::exception & e)
+		if(_receivedIn.empty() && tryWait(timeout))
 		{
-			Log::log() << "IPCChannel::receive encountered an exception: " << e.what() << std::endl;
-			throw e;
+			while (tryWait()); // The semaphore only tells us something was written, the frames tell us what
+
+			readFramesIn();
 		}
+	}
+	catch(std::exception & e)
+	{
+		Log::log() << "IPCChannel::receive encountered an exception: " << e.what() << std::endl;
+		throw e;
+	}
 
-		_mutexIn->unlock();
+	if(_receivedIn.empty())
+		return false;
 
-		return true;
-	}
+	data = std::move(_receivedIn.front());
+	_receivedIn.pop_front();
 
-	return false;
+	return true;
 }
 
 
@@ -429,10 +456,10 @@ bool IPCChannel::tryWait(int timeout)
 
 	messageWaiting = sem_trywait(_semaphoreIn) == 0;
 
-	while (timeout > 0 && messageWaiting == false)
+	while (timeout > 0 && messageWaiting == false) //No sem_timedwait on OS X, so we poll, but in small enough steps that it doesnt add latency
 	{
-		usleep(100000);
-		timeout -= 10;
+		usleep(5000);
+		timeout -= 5;
 		messageWaiting = sem_trywait(_semaphoreIn) == 0;
 	}
 
@@ -458,8 +485,3 @@ bool IPCChannel::tryWait(int timeout)
 	return messageWaiting;
 
 }
-
-std::string IPCChannel::lastSentMsg() const
-{
-	return _dataOut->data();
-}
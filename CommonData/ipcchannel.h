@@ -35,18 +35,25 @@
 #endif
 
 #include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/container/string.hpp>
 #include <functional>
-
-typedef boost::interprocess::allocator<char,	boost::interprocess::managed_shared_memory::segment_manager	> CharAllocator;
-typedef boost::container::basic_string<char,	std::char_traits<char>, CharAllocator						> String;
-typedef boost::interprocess::allocator<String,	boost::interprocess::managed_shared_memory::segment_manager	> StringAllocator;
+#include <atomic>
+#include <deque>
+#include "messagecodec.h"
 
 ///
 /// IPCChannel or Interproces communication channel
-/// Roughly a string guarded by a mutex to have a one way communication channel between Engine and Desktop
-/// This means that two of these are needed to have, well you guessed it, two way communication.
-/// It is created with a certain size but if it needs to grow (because of massive messages) it will double in size until it accomodates the message.
+/// Two single producer single consumer ring buffers in shared memory, one per direction, to communicate between Engine and Desktop.
+///
+/// Messages are written as frames (see FrameHeader), a message that does not fit in a quarter of the ring is split over several frames.
+/// This means several messages can be in flight at once and messages of any size can be sent without growing the shared memory.
+/// The writer only moves RingState::head and the reader only RingState::tail, so no locking is needed, just atomics.
+/// If the ring is full send() waits for the reader to make room (back-pressure), the semaphore is posted for every frame so the reader wakes up in time.
+/// A reader that does not make room within sendTimeoutMs() is taken to be gone, send() then drops the message and returns false so the caller can treat it as an error.
+/// On the Desktop side that is only a second, because send() runs on the GUI thread there, the engine gets the full 30s as Desktop is always reading.
+///
+/// Json::Value messages are encoded with codec(), which starts out as MessageCodec::defaultCodec(). The receiving side turns them back with MessageCodec::decode.
+///
+/// There can only be one thread sending and one thread receiving on each side!
 ///
 class IPCChannel
 {
@@ -54,27 +61,55 @@ public:
 	IPCChannel(std::string name, size_t channelNumber, bool isSlave = false);
 	~IPCChannel();
 
-	std::string lastSentMsg() const;
-
-	void send(std::string		&	data,	bool alreadyLockedMutex = false);
-	void send(std::string		&&	data,	bool alreadyLockedMutex = false);
-	bool receive(std::string	&	data,	int timeout = 0);
+	bool send(const std::string	&	data);							///< False if the message was dropped because the other side did not read
+	bool sendMessage(const Json::Value & message);					///< Encodes message with codec() first and sends that
+	bool receive(std::string	&	data,	int timeout = 0);	///< Gives the oldest complete message
 
 	size_t channelNumber() { return _channelNumber; }
+	int    sendTimeoutMs() { return _sendTimeoutMs; }
+
+	const MessageCodec *	codec() const							{ return _codec;	}
+	void					setCodec(const MessageCodec * codec)	{ _codec = codec;	}
 
 	void findConstructAllAgain();
+	void discardUnreadOut();										///< Throws away everything sent but not yet read, only do this when the other side is not running anymore
+	void discardUnreadIn();											///< Throws away everything received but not yet given out by receive(), including a partly read message. Same caveat as above
 
 private:
+	///Lives at the start of each ring, head and tail only ever increase and are taken modulo capacity
+	struct RingState
+	{
+		RingState(size_t capacity) : capacity(capacity) {}
+
+		std::atomic<uint64_t>	head		= 0,	///< Up to here is written, only changed by the sender
+								tail		= 0;	///< Up to here is read, only changed by the receiver
+		const uint64_t			capacity;
+	};
+
+	///Precedes the bytes of every frame, frames are padded to a multiple of sizeof(FrameHeader)
+	struct FrameHeader
+	{
+		enum Flags : uint32_t { firstOfMessage = 1, lastOfMessage = 2 };
+
+		uint32_t	bytes,
+					flags;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "IPCChannel needs lock free 64 bit atomics to share them between processes");
+
 	bool tryWait(int timeout = 0);
+	void postOut();
 	void catchAndRepeat(const std::string & taskDescription, std::function<void()> doThis);
 
-	void doubleMemoryOut();
-	void rebindMemoryInIfSizeChanged();
+	bool waitForSpaceOut(size_t bytes);
+	void writeOut(uint64_t position, const char * data, size_t bytes);
+	void readIn(  uint64_t position, char		* data, size_t bytes) const;
+	void readFramesIn();
+
 	void generateNames();
 
 	void findConstructSizes();
-	void findConstructDataStrings();
-	void findConstructMutexes();
+	void findConstructRings();
 
 	std::string										_baseName,
 													_nameControl,
@@ -82,24 +117,24 @@ private:
 													_nameStM;
 	size_t											_channelNumber;
 	bool											_isSlave;
+	int												_sendTimeoutMs;
 	boost::interprocess::managed_shared_memory	*	_memoryControl			= nullptr,
 												*	_memoryMasterToSlave	= nullptr,
 												*	_memorySlaveToMaster	= nullptr,
 												*	_memoryIn				= nullptr,
 												*	_memoryOut				= nullptr;
-	boost::interprocess::interprocess_mutex		*	_mutexOut				= nullptr,
-												*	_mutexIn				= nullptr;
-	String										*	_dataOut				= nullptr,
-												*	_dataIn					= nullptr;
+	RingState									*	_ringIn					= nullptr,
+												*	_ringOut				= nullptr;
+	char										*	_bytesIn				= nullptr,
+												*	_bytesOut				= nullptr;
 	size_t										*	_sizeMtoS				= nullptr,
 												*	_sizeStoM				= nullptr,
 												*	_sizeIn					= nullptr,
-												*	_sizeOut				= nullptr,
-													_previousSizeIn,
-													_previousSizeOut;
-	std::string										_mutexInName,
-													_mutexOutName,
-													_dataInName,
+												*	_sizeOut				= nullptr;
+	const MessageCodec							*	_codec					= MessageCodec::defaultCodec();
+	std::string										_partialIn;				///< The frames of a message that was not completely read yet
+	std::deque<std::string>							_receivedIn;			///< Complete messages read from the ring but not yet given out by receive()
+	std::string										_dataInName,
 													_dataOutName,
 													_semaphoreInName,
 													_semaphoreOutName;
@@ -135,3 +135,166 @@ stringset JsonUtilities::jsonStringArrayToSet(const Json::Value &jsonStrings)
 	
 	return stringset(vec.begin(), vec.end());
 }
+
+static std::string jsonPointerToken(const std::string & key)
+{
+	std::string escaped;
+	escaped.reserve(key.size());
+
+	for(char c : key)
+		if		(c == '~')	escaped += "~0";
+		else if	(c == '/')	escaped += "~1";
+		else				escaped += c;
+
+	return escaped;
+}
+
+static bool jsonPatchDiff(const Json::Value & from, const Json::Value & to, const std::string & path, Json::Value & operations, size_t maxOperations)
+{
+	auto operation = [&](const char * op, const std::string & opPath, const Json::Value * value)
+	{
+		Json::Value entry(Json::objectValue);
+		entry["op"]		= op;
+		entry["path"]	= opPath;
+
+		if(value)
+			entry["value"] = *value;
+
+		operations.append(entry);
+
+		return operations.size() <= maxOperations;
+	};
+
+	if(from.type() != to.type() || (!from.isObject() && !from.isArray()))
+		return from == to || operation("replace", path, &to);
+
+	if(from.isObject())
+	{
+		for(const std::string & key : from.getMemberNames())
+			if(!to.isMember(key) && !operation("remove", path + "/" + jsonPointerToken(key), nullptr))
+				return false;
+
+		for(auto it = to.begin(); it != to.end(); ++it)
+		{
+			const std::string	key		= it.name(),
+								keyPath	= path + "/" + jsonPointerToken(key);
+			const Json::Value *	old		= from.find(key.data(), key.data() + key.size());
+
+			if(!old)
+			{
+				if(!operation("add", keyPath, &(*it)))
+					return false;
+			}
+			else if(!jsonPatchDiff(*old, *it, keyPath, operations, maxOperations))
+				return false;
+		}
+
+		return true;
+	}
+
+	const Json::ArrayIndex common = std::min(from.size(), to.size());
+
+	for(Json::ArrayIndex i=0; i<common; i++)
+		if(!jsonPatchDiff(from[i], to[i], path + "/" + std::to_string(i), operations, maxOperations))
+			return false;
+
+	for(Json::ArrayIndex i=common; i<to.size(); i++)
+		if(!operation("add", path + "/" + std::to_string(i), &to[i]))
+			return false;
+
+	//Remove from the back so that the indices stay valid
+	for(Json::ArrayIndex i=from.size(); i>common; i--)
+		if(!operation("remove", path + "/" + std::to_string(i - 1), nullptr))
+			return false;
+
+	return true;
+}
+
+Json::Value JsonUtilities::jsonPatch(const Json::Value & from, const Json::Value & to, size_t maxOperations)
+{
+	Json::Value operations(Json::arrayValue);
+
+	if(!jsonPatchDiff(from, to, "", operations, maxOperations))
+		return Json::nullValue;
+
+	return operations;
+}
+
+bool JsonUtilities::applyJsonPatch(Json::Value & target, const Json::Value & patch)
+{
+	if(!patch.isArray())
+		return false;
+
+	for(const Json::Value & operation : patch)
+	{
+		const std::string	op		= operation.get("op",	"").asString(),
+							path	= operation.get("path",	"").asString();
+		const Json::Value &	value	= operation["value"];
+
+		if(path == "")
+		{
+			if(op != "replace")
+				return false;
+
+			target = value;
+			continue;
+		}
+
+		//Walk the pointer up to the parent of the last token
+		stringvec tokens;
+		for(size_t start = 1, end; start <= path.size(); start = end + 1)
+		{
+			end = path.find('/', start);
+
+			if(end == std::string::npos)
+				end = path.size();
+
+			std::string token = path.substr(start, end - start);
+
+			for(size_t tilde = token.find('~'); tilde != std::string::npos; tilde = token.find('~', tilde + 1))
+				token.replace(tilde, 2, token.substr(tilde + 1, 1) == "1" ? "/" : "~");
+
+			tokens.push_back(token);
+		}
+
+		Json::Value * parent = &target;
+
+		for(size_t t=0; t + 1 < tokens.size(); t++)
+		{
+			if		(parent->isObject() && parent->isMember(tokens[t]))	parent = &(*parent)[tokens[t]];
+			else if	(parent->isArray())
+			{
+				Json::ArrayIndex index = std::strtoul(tokens[t].c_str(), nullptr, 10);
+
+				if(index >= parent->size())
+					return false;
+
+				parent = &(*parent)[index];
+			}
+			else
+				return false;
+		}
+
+		const std::string & last = tokens.back();
+
+		if(parent->isObject())
+		{
+			if		(op == "add" || (op == "replace" && parent->isMember(last)))	(*parent)[last] = value;
+			else if	(op == "remove" && parent->isMember(last))						parent->removeMember(last);
+			else																	return false;
+		}
+		else if(parent->isArray())
+		{
+			Json::ArrayIndex index = last == "-" ? parent->size() : Json::ArrayIndex(std::strtoul(last.c_str(), nullptr, 10));
+
+			if		(op == "add"		&& index == parent->size())					parent->append(value);
+			else if	(op == "replace"	&& index <  parent->size())					(*parent)[index] = value;
+			else if	(op == "remove"		&& index <  parent->size())					parent->removeIndex(index, nullptr);
+			else																	return false;
+		}
+		else
+			return false;
+	}
+
+	return true;
+}
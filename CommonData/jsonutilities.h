@@ -26,6 +26,11 @@ public:
 	static void						replaceColumnNamesInDragNDropFilterJSONRef(			Json::Value & json,		const strstrmap & changeNameColumns);
 	static Json::Value				replaceColumnNamesInDragNDropFilterJSON(	const	Json::Value & json,		const strstrmap & changeNameColumns);
 
+	///JSON Patch (RFC 6902) operations that turn from into to, or Json::nullValue if that takes more than maxOperations and sending to itself is probably cheaper.
+	///Only "add" (of object members and at the end of arrays), "remove" and "replace" are generated, paths are JSON Pointers like "/results/descriptivesTable/data/3".
+	static Json::Value				jsonPatch(		const	Json::Value & from,		const Json::Value & to,		size_t maxOperations);
+	static bool						applyJsonPatch(			Json::Value & target,	const Json::Value & patch);	///< Applies the kind of patch jsonPatch makes, returns false (leaving target partially patched) if it does not fit target
+
 	static stringvec				jsonStringArrayToVec(const Json::Value & jsonStrings);
 	static stringset				jsonStringArrayToSet(const Json::Value & jsonStrings);
 
@@ -0,0 +1,122 @@
+#include "labelindex.h"
+
+void LabelIndex::clear()
+{
+	_byIntsId		.clear();
+	_byIntsIdSparse	.clear();
+	_byValDis		.clear();
+	_byValue		.clear();
+	_byDisplay		.clear();
+	_keys			.clear();
+}
+
+void LabelIndex::rebuild(const Labels & labels)
+{
+	clear();
+
+	_keys		.reserve(labels.size());
+	_byValDis	.reserve(labels.size());
+	_byValue	.reserve(labels.size());
+	_byDisplay	.reserve(labels.size());
+
+	for(Label * label : labels)
+		add(label);
+}
+
+void LabelIndex::add(Label * label)
+{
+	if(_keys.count(label))
+		remove(label);
+
+	Keys & keys = _keys[label];
+	keys.intsId		= label->intsId();
+	keys.valDis		= label->origValDisplay();
+	keys.display	= label->label();
+
+	if(keys.intsId >= 0 && size_t(keys.intsId) < 2 * _keys.size() + 1024)
+	{
+		if(_byIntsId.size() <= size_t(keys.intsId))
+			_byIntsId.resize(keys.intsId + 1, nullptr);
+
+		_byIntsId[keys.intsId] = label;
+	}
+	else
+		_byIntsIdSparse[keys.intsId] = label;
+
+	_byValDis[keys.valDis] = label;
+	_byValue	.insert(std::make_pair(keys.valDis.first,	label));
+	_byDisplay	.insert(std::make_pair(keys.display,		label));
+}
+
+void LabelIndex::remove(Label * label)
+{
+	auto found = _keys.find(label);
+
+	if(found == _keys.end())
+		return;
+
+	const Keys & keys = found->second;
+
+	if(keys.intsId >= 0 && size_t(keys.intsId) < _byIntsId.size() && _byIntsId[keys.intsId] == label)
+		_byIntsId[keys.intsId] = nullptr;
+
+	auto sparse = _byIntsIdSparse.find(keys.intsId);
+	if(sparse != _byIntsIdSparse.end() && sparse->second == label)
+		_byIntsIdSparse.erase(sparse);
+
+	auto valDis = _byValDis.find(keys.valDis);
+	if(valDis != _byValDis.end() && valDis->second == label)
+		_byValDis.erase(valDis);
+
+	auto eraseFrom = [label](std::unordered_multimap<std::string, Label*> & map, const std::string & key)
+	{
+		auto range = map.equal_range(key);
+		for(auto it = range.first; it != range.second; it++)
+			if(it->second == label)
+			{
+				map.erase(it);
+				return;
+			}
+	};
+
+	eraseFrom(_byValue,		keys.valDis.first);
+	eraseFrom(_byDisplay,	keys.display);
+
+	_keys.erase(found);
+}
+
+Label * LabelIndex::byIntsId(int intsId) const
+{
+	if(intsId >= 0 && size_t(intsId) < _byIntsId.size() && _byIntsId[intsId])
+		return _byIntsId[intsId];
+
+	auto sparse = _byIntsIdSparse.find(intsId);
+	return sparse == _byIntsIdSparse.end() ? nullptr : sparse->second;
+}
+
+Label * LabelIndex::byValueAndDisplay(const std::string & value, const std::string & display) const
+{
+	auto found = _byValDis.find(std::make_pair(value, display));
+	return found == _byValDis.end() ? nullptr : found->second;
+}
+
+Labelset LabelIndex::byValue(const std::string & value) const
+{
+	return _toSet(_byValue, value);
+}
+
+Labelset LabelIndex::byDisplay(const std::string & display) const
+{
+	return _toSet(_byDisplay, display);
+}
+
+Labelset LabelIndex::_toSet(const std::unordered_multimap<std::string, Label*> & map, const std::string & key)
+{
+	Labelset	labels;
+	auto		range = map.equal_range(key);
+
+	for(auto it = range.first; it != range.second; it++)
+		labels.insert(it->second);
+
+	return labels;
+}
@@ -0,0 +1,52 @@
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <unordered_map>
+#include "label.h"
+
+///
+/// Lets Column find its labels by intsId, by value, by display or by both without going through all of Column::_labels.
+/// Columns with an ID or free text in them easily have a hundred thousand labels, and setValues looks one up for every row.
+///
+/// Column keeps it up to date whenever a label is added, removed or gets a different value or display, the order of the labels is simply Column::_labels.
+/// The keys a label was indexed with are remembered, so it can always be removed again even when its value or display already changed.
+class LabelIndex
+{
+public:
+	void		clear();
+	void		rebuild(				const Labels		&	labels);
+	void		add(					Label				*	label);			///< If another label already has the same value and display byValueAndDisplay will return this one from now on
+	void		remove(					Label				*	label);
+	void		update(					Label				*	label)			{ remove(label); add(label); }
+
+	Label	*	byIntsId(				int						intsId)									const;
+	Label	*	byValueAndDisplay(		const std::string	&	value, const std::string & display)		const;
+	Labelset	byValue(				const std::string	&	value)									const;
+	Labelset	byDisplay(				const std::string	&	display)								const;	///< Matches Label::label()
+
+private:
+	typedef std::pair<std::string, std::string> StrStr;
+
+	struct StrStrHash
+	{
+		size_t operator()(const StrStr & strStr) const { return std::hash<std::string>()(strStr.first) ^ (std::hash<std::string>()(strStr.second) * 31); }
+	};
+
+	struct Keys
+	{
+		int			intsId;
+		StrStr		valDis;		///< Label::origValDisplay()
+		std::string	display;	///< Label::label()
+	};
+
+	static Labelset	_toSet(const std::unordered_multimap<std::string, Label*> & map, const std::string & key);
+
+	Labels											_byIntsId;			///< Dense, Column::labelsAdd hands out intsIds counting up from 0
+	std::unordered_map<int, Label*>					_byIntsIdSparse;	///< The ones too far away from 0 for _byIntsId, older files can have those
+	std::unordered_map<StrStr, Label*, StrStrHash>	_byValDis;
+	std::unordered_multimap<std::string, Label*>	_byValue,
+													_byDisplay;
+	std::unordered_map<const Label*, Keys>			_keys;
+};
+
+#endif // LABELINDEX_H
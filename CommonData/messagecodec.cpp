@@ -0,0 +1,525 @@
+#include "messagecodec.h"
+#include "ipcchannel.h"
+#include "processinfo.h"
+#include "timers.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+
+class JsonMessageCodec : public MessageCodec
+{
+public:
+	JsonMessageCodec()
+	{
+		_builder["indentation"]	= "";
+		_builder["emitUTF8"]	= true;
+	}
+
+	const char * name() const override { return "compact json"; }
+
+	std::string encode(const Json::Value & message) const override
+	{
+		JASPTIMER_SCOPE(JsonMessageCodec::encode);
+
+		return Json::writeString(_builder, message);
+	}
+
+private:
+	Json::StreamWriterBuilder _builder;
+};
+
+///
+/// Writes the following subset of MessagePack: nil, bool, fixint, int 64, uint 64, float 64, str, array, map and ext 32.
+/// Ext type numericDoubles and numericInts hold a whole array of doubles or int64s in little-endian order.
+/// The other multi-byte numbers are big-endian, as MessagePack requires.
+class BinaryMessageCodec : public MessageCodec
+{
+public:
+	enum ExtType : char { numericDoubles = 1, numericInts = 2 };
+
+	static const size_t minimumPackedArray = 4; ///< Shorter numeric arrays are not worth the ext header
+
+	const char * name() const override { return "binary"; }
+
+	std::string encode(const Json::Value & message) const override
+	{
+		JASPTIMER_SCOPE(BinaryMessageCodec::encode);
+
+		std::string out;
+		out.reserve(4096);
+		out.push_back(binaryMarker);
+
+		_encode(message, out);
+
+		return out;
+	}
+
+	static bool decode(const std::string & data, Json::Value & message, std::string & error)
+	{
+		JASPTIMER_SCOPE(BinaryMessageCodec::decode);
+
+		size_t pos = 1; //skip binaryMarker
+
+		try
+		{
+			message = _decode(data, pos);
+
+			if(pos != data.size())
+				throw std::runtime_error("trailing bytes after message");
+		}
+		catch(std::runtime_error & e)
+		{
+			error = "Binary message malformed at byte " + std::to_string(pos) + ": " + e.what();
+			return false;
+		}
+
+		return true;
+	}
+
+private:
+	template<typename T> static void _putBigEndian(T value, std::string & out)
+	{
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+
+		if constexpr(std::endian::native == std::endian::little)
+			std::reverse(bytes, bytes + sizeof(T));
+
+		out.append(bytes, sizeof(T));
+	}
+
+	template<typename T> static T _getBigEndian(const std::string & data, size_t & pos)
+	{
+		if(data.size() - pos < sizeof(T))
+			throw std::runtime_error("message ends in the middle of a number");
+
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, data.data() + pos, sizeof(T));
+		pos += sizeof(T);
+
+		if constexpr(std::endian::native == std::endian::little)
+			std::reverse(bytes, bytes + sizeof(T));
+
+		T value;
+		std::memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+
+	template<typename T> static void _putLittleEndianArray(const Json::Value & array, std::string & out, T (Json::Value::*as)() const)
+	{
+		size_t start = out.size();
+		out.resize(start + array.size() * sizeof(T));
+
+		char * bytes = out.data() + start;
+
+		for(const Json::Value & element : array)
+		{
+			T value = (element.*as)();
+			std::memcpy(bytes, &value, sizeof(T));
+
+			if constexpr(std::endian::native == std::endian::big)
+				std::reverse(bytes, bytes + sizeof(T));
+
+			bytes += sizeof(T);
+		}
+	}
+
+	template<typename T> static Json::Value _getLittleEndianArray(const std::string & data, size_t pos, size_t bytes)
+	{
+		if(bytes % sizeof(T) != 0)
+			throw std::runtime_error("numeric ext has a size that does not fit its type");
+
+		Json::Value array(Json::arrayValue);
+		array.resize(bytes / sizeof(T));
+
+		const char * in = data.data() + pos;
+
+		for(Json::ArrayIndex i=0; i<array.size(); i++, in += sizeof(T))
+		{
+			char value[sizeof(T)];
+			std::memcpy(value, in, sizeof(T));
+
+			if constexpr(std::endian::native == std::endian::big)
+				std::reverse(value, value + sizeof(T));
+
+			T typed;
+			std::memcpy(&typed, value, sizeof(T));
+			array[i] = typed;
+		}
+
+		return array;
+	}
+
+	static void _putLength(size_t length, unsigned char fixMarker, size_t fixMax, unsigned char marker32, std::string & out)
+	{
+		if(length <= fixMax)
+			out.push_back(char(fixMarker | length));
+		else
+		{
+			out.push_back(char(marker32));
+			_putBigEndian<uint32_t>(length, out);
+		}
+	}
+
+	static void _putString(const std::string & text, std::string & out)
+	{
+		_putLength(text.size(), 0xa0, 31, 0xdb, out);
+		out.append(text);
+	}
+
+	///Returns numericDoubles or numericInts if all elements are of that kind, 0 otherwise
+	static char _numericKind(const Json::Value & array)
+	{
+		if(array.size() < minimumPackedArray)
+			return 0;
+
+		const Json::ValueType type = array[0].type();
+
+		if(type != Json::realValue && type != Json::intValue)
+			return 0;
+
+		for(const Json::Value & element : array)
+			if(element.type() != type)
+				return 0;
+
+		return type == Json::realValue ? numericDoubles : numericInts;
+	}
+
+	static void _encode(const Json::Value & value, std::string & out)
+	{
+		switch(value.type())
+		{
+		case Json::nullValue:		out.push_back(char(0xc0));								return;
+		case Json::booleanValue:	out.push_back(char(value.asBool() ? 0xc3 : 0xc2));		return;
+		case Json::stringValue:		_putString(value.asString(), out);						return;
+
+		case Json::realValue:
+			out.push_back(char(0xcb));
+			_putBigEndian<double>(value.asDouble(), out);
+			return;
+
+		case Json::intValue:
+		{
+			Json::Int64 integer = value.asInt64();
+
+			if(integer >= -32 && integer <= 127)
+				out.push_back(char(integer)); //positive or negative fixint
+			else
+			{
+				out.push_back(char(0xd3));
+				_putBigEndian<int64_t>(integer, out);
+			}
+			return;
+		}
+
+		case Json::uintValue:
+			out.push_back(char(0xcf));
+			_putBigEndian<uint64_t>(value.asUInt64(), out);
+			return;
+
+		case Json::arrayValue:
+		{
+			const char kind = _numericKind(value);
+
+			if(kind)
+			{
+				out.push_back(char(0xc9));
+				_putBigEndian<uint32_t>(value.size() * 8, out);
+				out.push_back(kind);
+
+				if(kind == numericDoubles)	_putLittleEndianArray<double>		(value, out, &Json::Value::asDouble);
+				else						_putLittleEndianArray<Json::Int64>	(value, out, &Json::Value::asInt64);
+
+				return;
+			}
+
+			_putLength(value.size(), 0x90, 15, 0xdd, out);
+
+			for(const Json::Value & element : value)
+				_encode(element, out);
+
+			return;
+		}
+
+		case Json::objectValue:
+			_putLength(value.size(), 0x80, 15, 0xdf, out);
+
+			for(auto it = value.begin(); it != value.end(); ++it)
+			{
+				_putString(it.name(), out);
+				_encode(*it, out);
+			}
+			return;
+		}
+	}
+
+	static Json::Value _decode(const std::string & data, size_t & pos)
+	{
+		if(pos >= data.size())
+			throw std::runtime_error("message ends too soon");
+
+		const unsigned char marker = data[pos++];
+
+		auto length = [&](unsigned char fixMask, unsigned char marker32) -> size_t
+		{
+			if(marker == marker32)
+				return _getBigEndian<uint32_t>(data, pos);
+
+			return marker & fixMask;
+		};
+
+		auto string = [&](size_t bytes)
+		{
+			if(data.size() - pos < bytes)
+				throw std::runtime_error("message ends in the middle of a string");
+
+			std::string text = data.substr(pos, bytes);
+			pos += bytes;
+			return text;
+		};
+
+		if(marker <= 0x7f)					return Json::Value(Json::Int(marker));
+		if(marker >= 0xe0)					return Json::Value(Json::Int(int8_t(marker)));
+
+		if((marker & 0xe0) == 0xa0 || marker == 0xdb)
+			return Json::Value(string(length(0x1f, 0xdb)));
+
+		if((marker & 0xf0) == 0x90 || marker == 0xdd)
+		{
+			Json::Value array(Json::arrayValue);
+			size_t		elements = length(0x0f, 0xdd);
+
+			if(elements > data.size() - pos) //every element takes at least one byte
+				throw std::runtime_error("array longer than the message");
+
+			array.resize(elements);
+
+			for(size_t i=0; i<elements; i++)
+				array[Json::ArrayIndex(i)] = _decode(data, pos);
+
+			return array;
+		}
+
+		if((marker & 0xf0) == 0x80 || marker == 0xdf)
+		{
+			Json::Value object(Json::objectValue);
+			size_t		members = length(0x0f, 0xdf);
+
+			for(size_t i=0; i<members; i++)
+			{
+				const unsigned char keyMarker = pos < data.size() ? data[pos] : 0;
+
+				if((keyMarker & 0xe0) != 0xa0 && keyMarker != 0xdb)
+					throw std::runtime_error("map key is not a string");
+
+				std::string key		= _decode(data, pos).asString();
+				object[key]			= _decode(data, pos);
+			}
+
+			return object;
+		}
+
+		switch(marker)
+		{
+		case 0xc0:	return Json::nullValue;
+		case 0xc2:	return false;
+		case 0xc3:	return true;
+		case 0xcb:	return _getBigEndian<double>(data, pos);
+		case 0xd3:	return Json::Int64(_getBigEndian<int64_t>(data, pos));
+		case 0xcf:	return Json::UInt64(_getBigEndian<uint64_t>(data, pos));
+		case 0xc9:
+		{
+			size_t	bytes	= _getBigEndian<uint32_t>(data, pos);
+
+			if(data.size() - pos < bytes + 1)
+				throw std::runtime_error("message ends in the middle of a numeric array");
+
+			char	kind	= data[pos++];
+			size_t	start	= pos;
+
+			pos += bytes;
+
+			switch(kind)
+			{
+			case numericDoubles:	return _getLittleEndianArray<double>		(data, start, bytes);
+			case numericInts:		return _getLittleEndianArray<Json::Int64>	(data, start, bytes);
+			default:				throw std::runtime_error("unknown ext type " + std::to_string(int(kind)));
+			}
+		}
+		default:
+			throw std::runtime_error("unsupported marker " + std::to_string(int(marker)));
+		}
+	}
+};
+
+const MessageCodec * MessageCodec::compactJson()
+{
+	static JsonMessageCodec codec;
+	return &codec;
+}
+
+const MessageCodec * MessageCodec::binary()
+{
+	static BinaryMessageCodec codec;
+	return &codec;
+}
+
+const MessageCodec * MessageCodec::defaultCodec()
+{
+#ifdef JASP_BINARY_IPC
+	return binary();
+#else
+	return compactJson();
+#endif
+}
+
+bool MessageCodec::decode(const std::string & data, Json::Value & message, std::string * error)
+{
+	std::string errorMsg;
+	bool		decoded;
+
+	if(data.size() > 0 && data[0] == binaryMarker)
+		decoded = BinaryMessageCodec::decode(data, message, errorMsg);
+	else
+	{
+		JASPTIMER_SCOPE(JsonMessageCodec::decode);
+
+		Json::Reader reader;
+		decoded		= reader.parse(data, message, false);
+		errorMsg	= reader.getFormattedErrorMessages();
+	}
+
+	if(error)
+		*error = errorMsg;
+
+	return decoded;
+}
+
+///Something shaped like what jaspResults sends for an analysis with a table of rows x 6 and a column of samples (as for a posterior plot)
+static Json::Value benchmarkMessage(int rows, int samples)
+{
+	Json::Value table(Json::objectValue);
+	table["title"]		= "Descriptive Statistics";
+	table["status"]		= "complete";
+	table["name"]		= "descriptivesTable";
+
+	const char * fields[] = { "Variable", "Valid", "Missing", "Mean", "Std. Deviation", "p" };
+
+	for(const char * field : fields)
+	{
+		Json::Value fieldJson(Json::objectValue);
+		fieldJson["name"]	= field;
+		fieldJson["title"]	= field;
+		fieldJson["type"]	= field == fields[0] ? "string" : field == fields[1] || field == fields[2] ? "integer" : "number";
+		fieldJson["format"]	= "sf:4;dp:3";
+
+		table["schema"]["fields"].append(fieldJson);
+	}
+
+	Json::Value & data = table["data"] = Json::arrayValue;
+
+	for(int row=0; row<rows; row++)
+	{
+		Json::Value rowJson(Json::objectValue);
+		rowJson[fields[0]] = "variable_" + std::to_string(row);
+		rowJson[fields[1]] = 100 + row % 7;
+		rowJson[fields[2]] = row % 3;
+		rowJson[fields[3]] = 0.1 + row * 1.0001;
+		rowJson[fields[4]] = 1.0 / (1 + row);
+		rowJson[fields[5]] = row % 11 ? 0.05 / (row % 11) : 0.001;
+
+		data.append(rowJson);
+	}
+
+	Json::Value samplesJson(Json::arrayValue);
+	samplesJson.resize(samples);
+
+	for(int i=0; i<samples; i++)
+		samplesJson[i] = std::sin(i * 0.01) * 3.14159 + i * 1e-6;
+
+	Json::Value message(Json::objectValue);
+	message["typeRequest"]	= "analysis";
+	message["id"]			= 1;
+	message["name"]			= "Descriptives";
+	message["revision"]		= 3;
+	message["status"]		= "complete";
+	message["progress"]		= -1;
+	message["results"]["descriptivesTable"]		= table;
+	message["results"]["posteriorSamples"]		= samplesJson;
+	message["results"][".meta"]					= Json::arrayValue;
+
+	return message;
+}
+
+bool MessageCodec::benchmark(std::ostream & out)
+{
+	typedef std::chrono::steady_clock clock;
+
+	struct Payload { const char * name; int rows, samples, repeats; };
+	const Payload payloads[] = { { "small", 10, 0, 500 }, { "medium", 1000, 10000, 50 }, { "large", 100000, 1000000, 5 } };
+
+	const std::string	channelName		= "JASP-IPC-benchmark-" + std::to_string(ProcessInfo::currentPID());
+	IPCChannel			sender(			channelName, 0),
+						receiver(		channelName, 0, true);
+	bool				allSurvived		= true;
+
+	auto ms = [](clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	out << std::left << std::setw(8) << "payload" << std::setw(14) << "codec" << std::right << std::setw(14) << "bytes" << std::setw(14) << "encode ms" << std::setw(14) << "transfer ms" << std::setw(14) << "decode ms" << "\n";
+
+	for(const Payload & payload : payloads)
+	{
+		const Json::Value message = benchmarkMessage(payload.rows, payload.samples);
+
+		//The toStyledString that was used for every message before the codecs, as reference
+		clock::time_point	start	= clock::now();
+		std::string			styled;
+
+		for(int i=0; i<payload.repeats; i++)
+			styled = message.toStyledString();
+
+		out << std::left << std::setw(8) << payload.name << std::setw(14) << "styled json" << std::right << std::setw(14) << styled.size() << std::setw(14) << std::fixed << std::setprecision(3) << ms(clock::now() - start) / payload.repeats << "\n";
+
+		for(const MessageCodec * codec : { compactJson(), binary() })
+		{
+			std::string			encoded,
+								received;
+			Json::Value			decoded;
+			clock::duration		encoding	= clock::duration::zero(),
+								transfer	= clock::duration::zero(),
+								decoding	= clock::duration::zero();
+
+			for(int i=0; i<payload.repeats; i++)
+			{
+				start		= clock::now();
+				encoded		= codec->encode(message);
+				encoding   += clock::now() - start;
+
+				//The ring is smaller than the large messages, so it has to be read while it is written
+				start = clock::now();
+				std::thread reader([&]() { while(!receiver.receive(received, 1000)); });
+				sender.send(encoded);
+				reader.join();
+				transfer   += clock::now() - start;
+
+				start		= clock::now();
+				bool ok		= decode(received, decoded);
+				decoding   += clock::now() - start;
+
+				if(!ok || decoded != message)
+					allSurvived = false;
+			}
+
+			out << std::left << std::setw(8) << payload.name << std::setw(14) << codec->name() << std::right << std::setw(14) << encoded.size()
+				<< std::setw(14) << ms(encoding) / payload.repeats << std::setw(14) << ms(transfer) / payload.repeats << std::setw(14) << ms(decoding) / payload.repeats << "\n";
+		}
+	}
+
+	out << (allSurvived ? "All messages survived the round trip." : "Some messages did NOT survive the round trip!") << std::endl;
+
+	return allSurvived;
+}
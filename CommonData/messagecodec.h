@@ -0,0 +1,36 @@
+#ifndef MESSAGECODEC_H
+#define MESSAGECODEC_H
+
+#include <json/json.h>
+#include <ostream>
+
+///
+/// Turns the Json::Value messages between Engine and Desktop into the bytes IPCChannel sends and back.
+///
+/// There are two codecs:
+///  - compactJson(): JSON without any indentation, this is the default and what the messages always were minus the whitespace.
+///  - binary():      A subset of MessagePack preceded by binaryMarker. Arrays with only doubles or only integers (the columns of results tables and such)
+///                   are stored as a single MessagePack ext with the raw little-endian values instead of element by element.
+///
+/// Which one is used for sending is decided per side by defaultCodec(), which is binary() when JASP_BINARY_IPC is defined.
+/// decode() recognizes both, so an Engine and Desktop built differently still understand each other.
+class MessageCodec
+{
+public:
+	virtual						~MessageCodec() {}
+
+	virtual const char		*	name()										const = 0;
+	virtual std::string			encode(const Json::Value & message)			const = 0;
+
+	static bool					decode(const std::string & data, Json::Value & message, std::string * error = nullptr);
+
+	static const MessageCodec *	compactJson();
+	static const MessageCodec *	binary();
+	static const MessageCodec *	defaultCodec();
+
+	static bool					benchmark(std::ostream & out);				///< Times encode, transfer through an IPCChannel and decode of result-like messages with both codecs, returns false if any of them did not survive the round trip.
+
+	static constexpr char		binaryMarker = '\xc1';						///< Never used by MessagePack and never valid in UTF-8, so it cannot be the start of a JSON message
+};
+
+#endif // MESSAGECODEC_H
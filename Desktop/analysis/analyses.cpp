@@ -143,6 +143,7 @@ void Analyses::storeAnalysis(Analysis* analysis, size_t id, bool notifyAll)
 	beginInsertRows(QModelIndex(), newRowNum, newRowNum);
 	_analysisMap[id] = analysis;
 	_orderedIds.push_back(id);
+	_dependenciesStale = true;
 	endInsertRows();
 
 	emit countChanged();
@@ -171,6 +172,7 @@ void Analyses::bindAnalysisHandler(Analysis* analysis)
 	connect(analysis,	&Analysis::imageChanged,						this, &Analyses::somethingModified					);
 	connect(analysis,	&Analysis::userDataChangedSignal,				this, &Analyses::analysisOverwriteUserdata			);
 	connect(analysis,	&Analysis::emptyQMLCache,						this, &Analyses::emptyQMLCache						);
+	connect(analysis,	&Analysis::optionsChanged,						this, [&](){ _dependenciesStale = true; }			);
 }
 
 void Analyses::clear()
@@ -192,6 +194,7 @@ void Analyses::clear()
 
 	_analysisMap.clear();
 	_orderedIds.clear();
+	_dependenciesStale = true;
 
 	_nextId = 0;
 	endResetModel();
@@ -280,6 +283,7 @@ void Analyses::removeAnalysis(Analysis *analysis)
 	analysis->remove();
 	_analysisMap.erase(id);
 	_orderedIds.erase(_orderedIds.begin() + indexAnalysis);
+	_dependenciesStale = true;
 	for (int requestId : toRemove)
 		_scriptIDMap.remove(requestId);
 	endRemoveRows();
@@ -358,6 +362,104 @@ void Analyses::refreshAllAnalyses()
 		idAnalysis.second->refresh();
 }
 
+void Analyses::_rebuildDependencies()
+{
+	if(!_dependenciesStale)
+		return;
+
+	JASPTIMER_SCOPE(Analyses::_rebuildDependencies);
+
+	_analysesUsingColumn.clear();
+	_analysesUsingData.clear();
+	_indexedAnalyses.clear();
+
+	for(auto & idAnalysis : _analysisMap)
+	{
+		Analysis * analysis = idAnalysis.second;
+
+		//Without a form usedVariables() is empty, that doesn't mean the analysis uses no data though
+		if(!analysis->form())
+			continue;
+
+		//The columns an analysis creates are left out: it writes them itself and checkDataSetForUpdates reports that after every run, so indexing them would rerun it forever
+		stringset	usedCols	= analysis->usedVariables(),
+					createdCols	= analysis->createdVariables();
+
+		for(const std::string & col : usedCols)
+			if(!createdCols.count(col))
+				_analysesUsingColumn[col].insert(idAnalysis.first);
+
+		if(usedCols.size())
+			_analysesUsingData.insert(idAnalysis.first);
+
+		_indexedAnalyses.insert(idAnalysis.first);
+	}
+
+	_dependenciesStale = false;
+}
+
+void Analyses::_refreshAnalyses(std::function<bool(size_t id)> dependsOnChange)
+{
+	_rebuildDependencies();
+
+	for(auto & idAnalysis : _analysisMap)
+		if(!_indexedAnalyses.count(idAnalysis.first) || !idAnalysis.second->form() || dependsOnChange(idAnalysis.first))
+			idAnalysis.second->refresh();
+}
+
+bool Analyses::analysisUsesColumns(size_t id, const stringset & columns)
+{
+	_rebuildDependencies();
+
+	if(!_indexedAnalyses.count(id))
+		return true;
+
+	for(const std::string & col : columns)
+		if(_analysesUsingColumn.count(col) && _analysesUsingColumn.at(col).count(id))
+			return true;
+
+	return false;
+}
+
+void Analyses::refreshAnalysesUsingColumns(const stringset & columns)
+{
+	JASPTIMER_SCOPE(Analyses::refreshAnalysesUsingColumns);
+
+	_rebuildDependencies();
+
+	std::set<size_t> dependents;
+
+	for(const std::string & col : columns)
+		if(_analysesUsingColumn.count(col))
+			dependents.insert(_analysesUsingColumn.at(col).begin(), _analysesUsingColumn.at(col).end());
+
+	_refreshAnalyses([&](size_t id) { return dependents.count(id) > 0; });
+}
+
+void Analyses::refreshAnalysesUsingFilter()
+{
+	JASPTIMER_SCOPE(Analyses::refreshAnalysesUsingFilter);
+
+	//The filter decides which rows are passed to R, so it matters to every analysis that reads columns
+	_refreshAnalyses([&](size_t id) { return _analysesUsingData.count(id) > 0; });
+}
+
+void Analyses::workspaceEmptyValuesChanged()
+{
+	DataSet * data = DataSetPackage::pkg()->dataSet();
+
+	if(!data)
+		return;
+
+	stringset columns;
+
+	for(Column * column : data->columns())
+		if(!column->hasCustomEmptyValues())
+			columns.insert(column->name());
+
+	refreshAnalysesUsingColumns(columns);
+}
+
 void Analyses::refreshAllPlots(std::set<Analysis*> exceptThese)
 {
 	for(auto idAnalysis : _analysisMap)
@@ -75,6 +75,7 @@ public:
 
 	bool			allFresh()		const;
 	bool			allFinished()	const;
+	bool			analysisUsesColumns(size_t id, const stringset & columns);	///< By the dependency index, an analysis that is not in there yet is assumed to use them
 	void			setAnalysesUserData(Json::Value userData);
 	void			loadAnalysesFromDatasetPackage(bool & errorFound, std::stringstream & errorMsg, RibbonModel * ribbonModel);
 
@@ -108,6 +109,9 @@ public slots:
 	void removeAnalysisById(size_t id);
 	void removeAnalysis(Analysis *analysis);
 	void refreshAllAnalyses();
+	void refreshAnalysesUsingColumns(const stringset & columns);
+	void refreshAnalysesUsingFilter();
+	void workspaceEmptyValuesChanged();
 	void refreshAllPlots(std::set<Analysis*> exceptThese = {});
 	void analysisClickedHandler(QString analysisFunction, QString analysisQML, QString analysisTitle, QString module);
 	void setCurrentAnalysisIndex(int currentAnalysisIndex);
@@ -182,6 +186,8 @@ private:
 	void bindAnalysisHandler(Analysis* analysis);
 	void storeAnalysis(Analysis* analysis, size_t id, bool notifyAll);	
 	void _makeBackwardCompatible(RibbonModel* ribbonModel, Version& version, Json::Value& analysisData);
+	void _rebuildDependencies();
+	void _refreshAnalyses(std::function<bool(size_t id)> dependsOnChange);
 
 
 private:
@@ -201,6 +207,13 @@ private:
 	bool							_visible				= false;
 	bool							_moving					= false;
 
+	///Which analyses use a column, by usedVariables() without their own createdVariables(), rebuilt when _dependenciesStale.
+	///Analyses that are not in _indexedAnalyses (for instance because they have no form yet) have unknown dependencies and are always refreshed.
+	std::map<std::string, std::set<size_t>>	_analysesUsingColumn;
+	std::set<size_t>						_analysesUsingData,		///< Those that use at least one column and therefore also depend on the filter
+											_indexedAnalyses;
+	bool									_dependenciesStale		= true;
+
 	static int								_scriptRequestID;
 	QMap<int, QPair<Analysis*, QString> >	_scriptIDMap;
 
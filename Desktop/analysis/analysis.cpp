@@ -231,6 +231,17 @@ void Analysis::refresh()
 	emit refreshTableViewModels();
 }
 
+void Analysis::refreshForColumns(const QStringList & columns)
+{
+	stringset cols;
+	for(const QString & col : columns)
+		cols.insert(fq(col));
+
+	//Its own output columns are in the lists of some analyses too, a refresh for those would make it run forever
+	if(Analyses::analyses()->analysisUsesColumns(_id, cols))
+		refresh();
+}
+
 void Analysis::saveImage(const Json::Value &options)
 {
 	setStatus(Analysis::SaveImg);
@@ -568,6 +579,7 @@ Json::Value Analysis::createAnalysisRequestJson()
 	json["revision"]			= revision();
 	json["rfile"]				= _moduleData == nullptr ? rfile() : "";
 	json["dynamicModuleCall"]	= _moduleData == nullptr ? "" : _moduleData->getFullRCall();
+	json["moduleVersion"]		= moduleVersion().asString();
 	json["resultFont"]			= PreferencesModel::prefs()->resultFont().toStdString();
 
 	if (!isAborted())
@@ -116,6 +116,7 @@ public:
 			void				setTitle(const std::string& title)	override;
 			void				run()						override;
 			void				refresh()					override;
+			void				refreshForColumns(const QStringList & columns)	override;
 			void				reloadForm()				override;
 			void				exportResults()				override;
 			void				remove();
@@ -79,10 +79,67 @@ FocusScope
 
 			model:					dataSetModel
 			cacheItems:				true //!ribbonModel.dataMode
+			nativeCells:			true //Cells are drawn by DataSetView itself, DataTableViewItem is only used when this is off
 			maxColWidth:			250 * jaspTheme.uiScale
 			expandDataSet:			ribbonModel.dataMode
 			onDoubleClicked:		__myRoot.doubleClicked()
 
+			Connections
+			{
+				target:	dataTableView.view
+
+				//Does what the MouseArea in DataTableViewItem does for nativeCells
+				function onCellClicked(rowIndex, columnIndex, button, modifiers, globalPos)
+				{
+					if(ribbonModel.dataMode)
+					{
+						if(button !== Qt.RightButton)
+							dataTableView.view.select(rowIndex, columnIndex, Boolean(modifiers & Qt.ShiftModifier), Boolean(modifiers & Qt.ControlModifier));
+						else
+						{
+							dataTableView.view.clearEdit()
+							dataTableView.showPopupMenu(dataTableView.view, globalPos, rowIndex, columnIndex);
+						}
+					}
+
+					if (columnModel.visible)
+						columnModel.chosenColumn = columnIndex
+				}
+
+				function onCellHovered(rowIndex, columnIndex, modifiers, pos)
+				{
+					if(rowIndex >= 0 && ribbonModel.dataMode && Boolean(modifiers & Qt.ShiftModifier))
+						dataTableView.view.selectHover(rowIndex, columnIndex)
+
+					//Like JASPMouseAreaToolTipped: hide on every move and show again once the mouse rests on a truncated cell
+					nativeCellToolTip.visible	= false
+					nativeCellToolTip.pos		= pos
+					nativeCellToolTip.text		= rowIndex >= 0 ? dataTableView.view.cellToolTip(rowIndex, columnIndex) : ""
+
+					if(nativeCellToolTip.text !== "")	nativeCellToolTipTimer.restart()
+					else								nativeCellToolTipTimer.stop()
+				}
+			}
+
+			ToolTip
+			{
+				id:				nativeCellToolTip
+				parent:			dataTableView.view
+				delay:			0
+				timeout:		10000
+				x:				pos.x - (width / 2)
+				y:				pos.y + height
+
+				property point pos
+			}
+
+			Timer
+			{
+				id:				nativeCellToolTipTimer
+				interval:		400
+				onTriggered:	nativeCellToolTip.visible = true
+			}
+
 			function showPopupMenu(fromItem, globalPos, rowIndex, columnIndex)
 			{
 				var ctrlCmd = MACOS ? qsTr("Cmd") : qsTr("Ctrl");
@@ -370,6 +370,26 @@ For a local or toy database this is probably overkill, but use your own judgemen
                 }
             }
 
+            RowLayout
+            {
+                width:						parent.width
+
+                Text
+                {
+                    id:						incrementalColumnLabel
+                    text:					qsTr("Increasing column for fetching only new rows (optional)")
+                    width:					implicitWidth + jaspTheme.generalAnchorMargin
+                }
+
+                PrefsTextInput
+                {
+                    id:						incrementalColumn
+                    text:					fileMenuModel.database.incrementalColumn
+                    onEditingFinished:		fileMenuModel.database.incrementalColumn = text
+                    LQ.Layout.fillWidth:	true
+                }
+            }
+
 
 			Rectangle
 			{
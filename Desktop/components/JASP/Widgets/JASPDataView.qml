@@ -24,6 +24,7 @@ FocusScope
 				property alias extraColumnItem:			theView.extraColumnItem
 				property alias editDelegate:			theView.editDelegate
 				property alias cacheItems:				theView.cacheItems
+				property alias nativeCells:				theView.nativeCells
 				property alias maxColWidth:				theView.maxColWidth
 				property alias expandDataSet:			theView.expandDataSet
 
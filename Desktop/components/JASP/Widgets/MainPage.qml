@@ -482,6 +482,7 @@ Item
 				function setAllUserDataFromJavascript(json)			{ resultsJsInterface.setAllUserDataFromJavascript(json)			}
 				function setResultsMetaFromJavascript(json)			{ resultsJsInterface.setResultsMetaFromJavascript(json)			}
 				function duplicateAnalysis(id)						{ resultsJsInterface.duplicateAnalysis(id)						}
+				function resendAnalysis(id)							{ resultsJsInterface.resendAnalysis(id)							}
 				function showDependenciesInAnalysis(id, optName)	{ resultsJsInterface.showDependenciesInAnalysis(id, optName)	}
 				function showRSyntaxInResults(show)					{ resultsJsInterface.showRSyntaxInResults(show)					}
 
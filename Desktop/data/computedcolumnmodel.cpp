@@ -4,6 +4,7 @@
 #include "columnencoder.h"
 #include "analysis/analyses.h"
 #include "variableinfo.h"
+#include <queue>
 
 ComputedColumnModel * ComputedColumnModel::_singleton = nullptr;
 
@@ -132,7 +133,104 @@ void ComputedColumnModel::emitSendComputeCode(Column * column)
 		return;
 
 	if(areLoopDependenciesOk(column->name(), code))
+	{
+		_columnsComputing.insert(column->name());
 		emit sendComputeCode(tq(column->name()), tq(code), column->type());
+	}
+}
+
+bool ComputedColumnModel::isComputedByCode(Column * column)
+{
+	return column->isComputed() && column->codeType() != computedColumnType::analysis && column->codeType() != computedColumnType::analysisNotComputed;
+}
+
+stringset ComputedColumnModel::dependents(const stringset & columnNames, bool transitively)
+{
+	std::map<std::string, stringset> usedBy;
+
+	for(Column * col : computedColumns())
+		if(isComputedByCode(col))
+			for(const std::string & input : col->dependsOnColumns())
+				usedBy[input].insert(col->name());
+
+	stringset				found;
+	std::queue<std::string>	todo;
+
+	for(const std::string & columnName : columnNames)
+		todo.push(columnName);
+
+	for(; todo.size(); todo.pop())
+		for(const std::string & dependent : usedBy[todo.front()])
+			if(found.insert(dependent).second && transitively)
+				todo.push(dependent);
+
+	return found;
+}
+
+///The direct dependents of changedColumns and computeThese need to be computed, and everything depending on those might have to be.
+///All of them are invalidated right away, so that a column is only sent once none of its inputs are invalidated anymore.
+///That way each column is computed once per change, and columns that do not depend on each other go to different engines at the same time.
+void ComputedColumnModel::scheduleComputation(const stringset & changedColumns, const stringset & computeThese)
+{
+	if(!dataSet())
+		return;
+
+	stringset inputChanged	= dependents(changedColumns, false),
+			  affected;
+
+	inputChanged.insert(computeThese.begin(), computeThese.end());
+
+	affected = dependents(inputChanged, true);
+	affected.insert(inputChanged.begin(), inputChanged.end());
+
+	for(const std::string & columnName : affected)
+	{
+		Column * col = dataSet()->column(columnName);
+
+		if(!col || !isComputedByCode(col))
+			continue;
+
+		//A column that was already invalidated for some other reason is probably out of date as well
+		if(inputChanged.count(columnName) || (col->invalidated() && !_columnsScheduled.count(columnName) && !_columnsComputing.count(columnName)))
+			_columnsInputChanged.insert(columnName);
+
+		_columnsScheduled.insert(columnName);
+		invalidate(tq(columnName));
+	}
+
+	sendReadyColumns();
+}
+
+void ComputedColumnModel::sendReadyColumns()
+{
+	if(!dataSet())
+		return;
+
+	//Validating a column with unchanged inputs might make others ready, so keep going until nothing changes
+	for(bool validatedSome = true; validatedSome; )
+	{
+		validatedSome = false;
+
+		for(Column * col : computedColumns())
+		{
+			const std::string columnName = col->name();
+
+			if(!_columnsScheduled.count(columnName) || _columnsComputing.count(columnName))
+				continue;
+
+			if(col->invalidated() && !col->iShouldBeSentAgain())
+				continue; //Still waiting for its inputs
+
+			_columnsScheduled.erase(columnName);
+
+			if(_columnsInputChanged.erase(columnName) && col->invalidated())
+				emitSendComputeCode(col);
+			else
+				validate(tq(columnName));
+
+			validatedSome |= !col->invalidated();
+		}
+	}
 }
 
 void ComputedColumnModel::sendCode(const QString & code, const QString & json)
@@ -144,7 +242,7 @@ void ComputedColumnModel::sendCode(const QString & code, const QString & json)
 void ComputedColumnModel::sendCode(const QString & code)
 {
 	setComputeColumnRCode(code);
-	emitSendComputeCode(_selectedColumn);
+	scheduleComputation({}, { _selectedColumn->name() });
 }
 
 void ComputedColumnModel::validate(const QString & columnName)
@@ -194,6 +292,10 @@ void ComputedColumnModel::computeColumnRemoved(QString columnNameQ)
 {
 	std::string columnName	= columnNameQ.toStdString();
 
+	_columnsComputing		.erase(columnName);
+	_columnsScheduled		.erase(columnName);
+	_columnsInputChanged	.erase(columnName);
+
 	if(!dataSet())
 		return;
 	
@@ -206,6 +308,8 @@ void ComputedColumnModel::computeColumnSucceeded(QString columnNameQ, QString wa
 	std::string columnName	= columnNameQ.toStdString(),
 				warning		= warningQ.toStdString();
 
+	_columnsComputing.erase(columnName);
+
 	if(!dataSet())
 		return;
 
@@ -223,11 +327,13 @@ void ComputedColumnModel::computeColumnSucceeded(QString columnNameQ, QString wa
 		emit computeColumnErrorChanged();
 
 	emit refreshColumn(columnNameQ);
-	
-	validate(columnNameQ);
 
-	if(dataChanged)
-		checkForDependentColumnsToBeSent(columnNameQ);
+	//If it got scheduled again while being computed it stays invalidated until whatever it depends on is done
+	if(!_columnsScheduled.count(columnName))
+		validate(columnNameQ);
+
+	if(dataChanged)	checkForDependentColumnsToBeSent(columnNameQ);
+	else			sendReadyColumns(); //The columns waiting for this one might not need to be computed at all now
 }
 
 void ComputedColumnModel::computeColumnFailed(QString columnNameQ, QString errorQ)
@@ -235,6 +341,8 @@ void ComputedColumnModel::computeColumnFailed(QString columnNameQ, QString error
 	std::string columnName	= columnNameQ.toStdString(),
 				error		= errorQ.toStdString();
 
+	_columnsComputing.erase(columnName);
+
 	if(!dataSet())
 		return;
 	
@@ -252,8 +360,23 @@ void ComputedColumnModel::computeColumnFailed(QString columnNameQ, QString error
 	DataSetPackage::pkg()->columnSetDefaultValues(columnName, columnType::unknown, false);
 	emit refreshColumn(columnNameQ);
 
+	if(_columnsScheduled.count(columnName))
+	{
+		sendReadyColumns(); //It gets another chance once its inputs are done
+		return;
+	}
+
 	validate(tq(columnName));
 	invalidateDependents(columnName);
+
+	//Whatever depends on this column stays invalidated until it is fixed
+	for(const std::string & dependent : dependents({ columnName }, true))
+	{
+		_columnsScheduled		.erase(dependent);
+		_columnsInputChanged	.erase(dependent);
+	}
+
+	sendReadyColumns();
 }
 
 ///Called from datatype changed
@@ -272,20 +395,7 @@ void ComputedColumnModel::checkForDependentColumnsToBeSent(QString columnNameQ,
 {
 	std::string columnName = fq(columnNameQ);
 
-	for(Column * col : computedColumns())
-		if(	col->codeType() != computedColumnType::analysis				&&
-			col->codeType() != computedColumnType::analysisNotComputed	&&
-			(
-					col->dependsOn(columnName) ||
-					(refreshMe && col->name() == columnName)
-			) )
-			invalidate(tq(col->name()));
-
-	for(Column * col : computedColumns())
-		if(	col->codeType() != computedColumnType::analysis				&&
-			col->codeType() != computedColumnType::analysisNotComputed	&&
-			col->iShouldBeSentAgain() )
-			emitSendComputeCode(col);
+	scheduleComputation({ columnName }, refreshMe ? stringset{ columnName } : stringset{});
 
 	checkForDependentAnalyses(columnName);
 }
@@ -394,14 +504,18 @@ void ComputedColumnModel::datasetChanged(	QStringList				changedColumns,
 
 	}
 
+	stringset computeThese;
+
 	for(Column * col : computedColumns())
 	{
 		col->findDependencies(); //columnNames might have changed right? so check it again
 
-		if(col->iShouldBeSentAgain())
-			emitSendComputeCode(col);
+		if(col->invalidated() && isComputedByCode(col))
+			computeThese.insert(col->name());
 	}
 
+	scheduleComputation({}, computeThese);
+
 	emit refreshData();
 }
 
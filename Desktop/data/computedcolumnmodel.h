@@ -7,6 +7,7 @@
 /// 
 /// A model for use by the computed columns editor in QML
 /// It can only show the relevant information for a single computed column at a time
+/// It also decides when computed columns are sent to the engines, see scheduleComputation
 class ComputedColumnModel : public QObject
 {
 	Q_OBJECT
@@ -62,6 +63,11 @@ private:
 				void				invalidate(							const QString		& name);
 				void				invalidateDependents(				const std::string	& columnName);
 				void				emitSendComputeCode(				Column				* column);
+				stringset			dependents(							const stringset		& columnNames, bool transitively);	///< The computed columns (that have code) using any of columnNames, and those using them etc if transitively
+				void				scheduleComputation(				const stringset		& changedColumns, const stringset & computeThese = {});
+				void				sendReadyColumns();
+
+	static		bool				isComputedByCode(					Column				* column);
 
 signals:
 				void	refreshProperties();
@@ -96,6 +102,9 @@ public slots:
 private:
 	static	ComputedColumnModel		* _singleton;
 			Column					* _selectedColumn	= nullptr;
+			stringset				  _columnsScheduled,		///< Invalidated because something they depend on is going to be computed, they wait until all of that is done
+									  _columnsInputChanged,		///< The part of _columnsScheduled that really needs to be computed, the rest turned out to have unchanged inputs and are simply validated
+									  _columnsComputing;		///< Sent to an engine and not returned yet
 };
 
 #endif // COMPUTEDCOLUMNSCODEITEM_H
@@ -2,6 +2,7 @@
 #include "utilities/qutils.h"
 #include <QSqlDatabase>
 #include <QSqlError>
+#include <QSqlDriver>
 #include "log.h"
 
 Json::Value DatabaseConnectionInfo::toJson(bool forJaspFile) const
@@ -17,6 +18,7 @@ Json::Value DatabaseConnectionInfo::toJson(bool forJaspFile) const
 	out["database"]		= fq(_database);
 	out["hostname"]		= fq(_hostname);
 	out["query"]		= fq(_query);
+	out["incrementalColumn"]	= fq(_incrementalColumn);
 	out["port"]			= _port;
 	out["interval"]		= _interval;
 	out["rememberMe"]	= _rememberMe;
@@ -35,6 +37,7 @@ void DatabaseConnectionInfo::fromJson(const Json::Value & json)
 	_database		= tq(				json["database"]	.asString() )	;
 	_hostname		= tq(				json["hostname"]	.asString() )	;
 	_query			= tq(				json["query"]		.asString() )	;
+	_incrementalColumn	= tq(			json["incrementalColumn"].asString())	;
 	_port			=					json["port"]		.asUInt()		;
 	_interval		=					json["interval"]	.asInt()		;
 	_rememberMe		=					json["rememberMe"]	.asBool()		;
@@ -73,15 +76,37 @@ QString DatabaseConnectionInfo::lastError() const
 	return QSqlDatabase::database().lastError().text();
 }
 
-QSqlQuery DatabaseConnectionInfo::runQuery() const
+QSqlQuery DatabaseConnectionInfo::runQuery(const QVariant & incrementalAfter) const
 {
 	if(!QSqlDatabase::database().isOpen())
 		throw std::runtime_error(fq(QObject::tr("JASP thinks it's connected to the database but the QSqlDatabase isn't opened...")));
 	
 	QSqlQuery query;
-	query.setForwardOnly(true);
+	query.setForwardOnly(true); //This lets the drivers that can stream the rows to us instead of buffering the whole result first
 
-	if(!query.exec(_query))
+	bool ok;
+
+	if(!incrementalAfter.isValid())
+		ok = query.exec(_query);
+	else
+	{
+		//Wrap the users query so we dont have to understand it, a trailing ; would break the subquery though
+		QString	userQuery	= _query.trimmed();
+		while(userQuery.endsWith(';'))
+			userQuery.chop(1);
+
+		QString	column		= QSqlDatabase::database().driver()->escapeIdentifier(_incrementalColumn, QSqlDriver::FieldName);
+
+		ok = query.prepare("SELECT * FROM (" + userQuery + ") AS jaspIncremental WHERE " + column + " > ? ORDER BY " + column);
+
+		if(ok)
+		{
+			query.addBindValue(incrementalAfter);
+			ok = query.exec();
+		}
+	}
+
+	if(!ok)
 		throw std::runtime_error(fq(QObject::tr("Query failed with: '%1'").arg(query.lastError().text())));
 
 	if(!query.isSelect())
@@ -20,7 +20,7 @@ public:
 	void		close()		const;
 	
 	QString		lastError() const;
-	QSqlQuery	runQuery()	const;
+	QSqlQuery	runQuery(const QVariant & incrementalAfter = QVariant())	const; ///< If incrementalAfter is valid only the rows with a higher value in _incrementalColumn are returned, in that order
 	
 	
 	DbType  _dbType			= DbType::NOTCHOSEN;
@@ -28,7 +28,8 @@ public:
 			_password		= "",
 			_database		= "",
 			_hostname		= "",
-			_query			= "";
+			_query			= "",
+			_incrementalColumn	= ""; ///< A numeric column that only ever increases for new rows (like an autoincrement id), when set a sync only fetches the rows after it
 	int		_port			= 0,
 			_interval		= 0;
 	bool	_rememberMe		= false,
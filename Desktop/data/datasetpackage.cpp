@@ -32,6 +32,9 @@
 #include "modules/ribbonmodel.h"
 #include "filtermodel.h"
 #include <ranges>
+#include <atomic>
+#include <future>
+#include <thread>
 #include "variableinfo.h"
 
 //Im having problems getting the proxy models to play nicely with beginRemoveRows etc
@@ -48,6 +51,7 @@ DataSetPackage::DataSetPackage(QObject * parent) : QAbstractItemModel(parent)
 	
 	_db			= new DatabaseInterface(true);
 
+	DataSet::setPublishesColumnarSegment(true); //Desktop is the only one writing to the dataset, so it makes the values available to the engines
 	_dataSet	= new DataSet(); //We create one here to make sure filter() etc can actually work
 	setDefaultWorkspaceEmptyValues();
 	
@@ -519,6 +523,8 @@ QVariant DataSetPackage::data(const QModelIndex &index, int role) const
 		case int(specialRoles::valuesDblList):					return getColumnValuesAsDoubleList(getColumnIndex(column->name()));
 		case int(specialRoles::nonFilteredNumericValuesCount):	return column->nonFilteredNumericsCount();
 		case int(specialRoles::nonFilteredLevels):				return tql(column->nonFilteredLevels());
+		case int(specialRoles::totalLevels):					return int(column->nonFilteredLevels().size());
+		case int(specialRoles::statistics):						return columnStatistics(column);
 		case int(specialRoles::computedColumnType):				return int(column->codeType());
 		case int(specialRoles::columnPkgIndex):					return index.column();
 		case int(specialRoles::lines):
@@ -552,6 +558,8 @@ QVariant DataSetPackage::data(const QModelIndex &index, int role) const
 		{
 		case int(specialRoles::nonFilteredNumericValuesCount):	return column->nonFilteredNumericsCount();
 		case int(specialRoles::nonFilteredLevels):				return tql(column->nonFilteredLevels());
+		case int(specialRoles::totalLevels):					return int(column->nonFilteredLevels().size());
+		case int(specialRoles::statistics):						return columnStatistics(column);
 		case int(specialRoles::valuesDblList):					return getColumnValuesAsDoubleList(getColumnIndex(column->name()));
 		case int(specialRoles::description):					return index.row() >= labels.size() ? "" : tq(labels[index.row()]->description());
 		case int(specialRoles::filter):							return index.row() >= labels.size() || labels[index.row()]->filterAllows();
@@ -1477,6 +1485,24 @@ bool DataSetPackage::initColumnWithStrings(QVariant colId, const std::string & n
 {
 	JASPTIMER_SCOPE(DataSetPackage::initColumnWithStrings);
 	
+	return _initColumn(colId, newName, title, desiredType, emptyValues, [&](Column * column, int threshold, bool * anyChanges)
+	{
+		return column->setValues(values, labels, threshold, anyChanges);  //If less unique integers than the thresholdScale then we think it must be ordinal: https://github.com/jasp-stats/INTERNAL-jasp/issues/270
+	});
+}
+
+bool DataSetPackage::initColumnWithTypedValues(QVariant colId, const std::string & newName, const doublevec & dbls, const intvec & labelIndices, const stringvec & labelDictionary, bool onlyInts, const std::string & title, columnType desiredType, const stringset & emptyValues)
+{
+	JASPTIMER_SCOPE(DataSetPackage::initColumnWithTypedValues);
+	
+	return _initColumn(colId, newName, title, desiredType, emptyValues, [&](Column * column, int threshold, bool * anyChanges)
+	{
+		return column->setValues(dbls, labelIndices, labelDictionary, onlyInts, threshold, anyChanges);
+	});
+}
+
+bool DataSetPackage::_initColumn(QVariant colId, const std::string & newName, const std::string & title, columnType desiredType, const stringset & emptyValues, std::function<columnType (Column *, int, bool *)> setValues)
+{
 	int			colIndex		=	getColIndex(colId),
 				threshold		=	Settings::value(Settings::THRESHOLD_SCALE).toInt();
 	Column	*	column			=	_dataSet->columns()[colIndex];
@@ -1486,15 +1512,85 @@ bool DataSetPackage::initColumnWithStrings(QVariant colId, const std::string & n
 				column			->	setTitle(title);
 				column			->	beginBatchedLabelsDB();
 	bool		anyChanges		=	title != column->title() || newName != column->name();
-	columnType	prevType		=	column->type(),
-				suggestedType	=	column->setValues(values, labels,	threshold, &anyChanges);  //If less unique integers than the thresholdScale then we think it must be ordinal: https://github.com/jasp-stats/INTERNAL-jasp/issues/270
-				column			->	setType(column->type() != columnType::unknown ? column->type() : desiredType == columnType::unknown ? suggestedType : desiredType);
-				column			->	endBatchedLabelsDB();
+	columnType	prevType		=	column->type();
+
+	if(_initColumnsDeferred)
+	{
+		_deferredColumnInits.push_back({ column, threshold, desiredType, columnType::unknown, setValues });
+		return true; //We cannot know yet, but this is only used while loading anyway
+	}
+
+	columnType	suggestedType	=	setValues(column, threshold, &anyChanges);
+	_initColumnFinish(column, desiredType, suggestedType);
+	
+	return anyChanges || column->type() != prevType;
+}
+
+void DataSetPackage::_initColumnFinish(Column * column, columnType desiredType, columnType suggestedType)
+{
+	column->setType(column->type() != columnType::unknown ? column->type() : desiredType == columnType::unknown ? suggestedType : desiredType);
+	column->endBatchedLabelsDB();
 				
-                                if(PreferencesModel::prefs()->orderByValueByDefault())
+	if(PreferencesModel::prefs()->orderByValueByDefault())
 		column->labelsOrderByValue();
+}
+
+void DataSetPackage::beginInitColumns()
+{
+	assert(!_initColumnsDeferred && _dataSet->writeBatchedToDB());
+	_initColumnsDeferred = true;
+}
+
+void DataSetPackage::endInitColumns(std::function<void(float)> progressCallback)
+{
+	JASPTIMER_SCOPE(DataSetPackage::endInitColumns);
 	
-	return anyChanges || column->type() != prevType;
+	assert(_initColumnsDeferred && _dataSet->writeBatchedToDB());
+	_initColumnsDeferred = false;
+
+	std::vector<DeferredColumnInit> inits;
+	inits.swap(_deferredColumnInits);
+
+	//As long as the dataset and the labels are batched filling a column only touches that column itself, so they can be done concurrently.
+	//Every worker just takes the next column nobody took yet, that way they all stay busy even when some columns are a lot more work than others.
+	std::atomic<size_t>	nextInit(0),
+						initsDone(0);
+
+	auto initColumns = [&]()
+	{
+		for(size_t i = nextInit++; i < inits.size(); i = nextInit++)
+		{
+			inits[i].suggestedType = inits[i].setValues(inits[i].column, inits[i].threshold, nullptr);
+			initsDone++;
+		}
+	};
+
+#ifdef PROFILE_JASP
+	const size_t workerCount = 1; //The timers are not threadsafe
+#else
+	const size_t workerCount = std::min(inits.size(), size_t(std::max(1u, std::thread::hardware_concurrency())));
+#endif
+
+	std::vector<std::future<void>> workers;
+	for(size_t w=0; w<workerCount; w++)
+		workers.push_back(std::async(std::launch::async, initColumns));
+
+	for(std::future<void> & worker : workers)
+		while(worker.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+			progressCallback(float(initsDone) / inits.size());
+
+	for(std::future<void> & worker : workers)
+		worker.get();
+
+	//Types and labels go to the database, so that is done here, all in one go
+	_db->transactionWriteBegin();
+
+	for(DeferredColumnInit & init : inits)
+		_initColumnFinish(init.column, init.desiredType, init.suggestedType);
+
+	_db->transactionWriteEnd();
+	
+	progressCallback(1);
 }
 
 void DataSetPackage::initializeComputedColumns()
@@ -1850,6 +1946,25 @@ QList<QVariant> DataSetPackage::getColumnValuesAsDoubleList(size_t columnIndex)
 	return list;
 }
 
+QVariantMap DataSetPackage::columnStatistics(Column * column) const
+{
+	const ColumnStatistics & stats = column->statistics();
+
+	QVariantList histogram;
+	for(size_t count : stats.histogram)
+		histogram.append(qsizetype(count));
+
+	return QVariantMap({
+		{ "rows",		qsizetype(stats.rows)			},
+		{ "missing",	qsizetype(stats.missing)		},
+		{ "numerics",	qsizetype(stats.numerics)		},
+		{ "levels",		qsizetype(stats.levels.size())	},
+		{ "min",		stats.min						},
+		{ "max",		stats.max						},
+		{ "histogram",	histogram						}
+	});
+}
+
 bool DataSetPackage::labelNeedsFilter(size_t columnIndex) const
 {
 	if(columnIndex < 0 || columnIndex >= dataColumnCount()) 
@@ -1977,10 +2092,12 @@ void DataSetPackage::pasteSpreadsheet(size_t row, size_t col, const std::vector<
 	
 	stringvec changed;
 	strstrmap changeNameColumns;
+	Columns	  pastedInto;
 
 	for(int c=0; c<colMax; c++)
 	{
 		Column	*	column		= _dataSet->column(c + col);
+					pastedInto.push_back(column);
 		columnType	desiredType	= coltypes.size() > c ? columnType(coltypes[c]) : column->type();
 					desiredType = desiredType == columnType::unknown ? columnType::scale : desiredType;
 		std::string colName		= (colNames.size() > c && !colNames[c].isEmpty()) ? fq(colNames[c]) : column->name();
@@ -2006,7 +2123,8 @@ void DataSetPackage::pasteSpreadsheet(size_t row, size_t col, const std::vector<
 		}
 	}
 
-	_dataSet->endBatchedToDB();
+	//If the size stayed the same only the columns pasted into need to be written, and reloaded by the engines
+	_dataSet->endBatchedToDB(colCountChanged || rowCountChanged ? Columns() : pastedInto);
 	
 	stringvec		missingColumns;
 
@@ -2573,7 +2691,7 @@ void DataSetPackage::checkDataSetForUpdates()
 					<< "' | " << (newCols ? " has new cols" : "") << (rowCountChanged ? "| rowcount changed |" : "|") << std::endl;
 		refresh();
 
-		emit datasetChanged(tq(changedCols), tq(missingCols), {}, newCols, rowCountChanged);
+		emit datasetChanged(tq(changedCols), tq(missingCols), {}, rowCountChanged, newCols);
 	}
 }
 
@@ -161,6 +161,7 @@ public:
 				bool				dataFileReadOnly()					const	{ return _dataFileReadOnly;						}
 				bool				currentFileIsExample()				const;
 				long				dataFileTimestamp()					const	{ return _dataSet ? _dataSet->dataFileTimestamp() : 0;	}
+				std::string			dataFileFingerprint()				const	{ return _dataSet ? _dataSet->dataFileFingerprint() : "";	}
 				bool				isDatabaseSynching()				const	{ return _databaseIntervalSyncher.isActive();	}
 				bool				filterShouldRunInit()				const	{ return _filterShouldRunInit;					}
 
@@ -172,6 +173,7 @@ public:
 				void				updateDbToCurrentVersion();							///< Should be ran immediately after loading the jasp file
 				void				setWarningMessage(std::string message)				{ _warningMessage				= message;			}
 				void				setDataFilePath(std::string filePath, long timestamp = 0);
+				void				setDataFileFingerprint(const std::string & fingerprint)	{ if(_dataSet) _dataSet->setDataFileFingerprint(fingerprint);	}
 				void				setDatabaseJson(const Json::Value & dbInfo);
 				void				setInitialMD5(std::string initialMD5)				{ _initialMD5					= initialMD5;		}
 				void				setDataFileReadOnly(bool readOnly)					{ _dataFileReadOnly				= readOnly;			}
@@ -187,6 +189,9 @@ public:
 				void				setDescription(const QString& description);
 				
 				bool						initColumnWithStrings(			QVariant			colId,		const std::string & newName, const stringvec	& values, const stringvec	& labels=stringvec(),	const std::string & title = "", columnType desiredType = columnType::unknown, const stringset & emptyValues = stringset());
+				bool						initColumnWithTypedValues(		QVariant			colId,		const std::string & newName, const doublevec	& dbls,	  const intvec		& labelIndices, const stringvec & labelDictionary, bool onlyInts, const std::string & title = "", columnType desiredType = columnType::unknown, const stringset & emptyValues = stringset()); ///< See Column::setValues(const doublevec &...)
+				void						beginInitColumns();												///< Until endInitColumns the initColumnWith* functions only set name, title and empty values, the values are kept for later
+				void						endInitColumns(std::function<void(float)> progressCallback);	///< Fills values, labels and types of all columns initialized since beginInitColumns concurrently. Only call this while the dataset is writing batched to DB!
 				void						initializeComputedColumns();
 				
 				void						pasteSpreadsheet(size_t row, size_t column, const std::vector<std::vector<QString>> & values, const std::vector<std::vector<QString>> & labels, const intvec & colTypes, const QStringList & colNames, const std::vector<boolvec> & selected = {}); ///< If selected.size() >0 it is assumed to be the same size as labels/values. And it will make sure that it will only overwrite values where it is `true`
@@ -245,6 +250,7 @@ public:
 				stringvec					getColumnLabelsAsStrVec(			size_t				columnIndex)				const;
 				boolvec						getColumnFilterAllows(				size_t				columnIndex)				const;
 				QList<QVariant>				getColumnValuesAsDoubleList(		size_t				columnIndex)				const;
+				QVariantMap					columnStatistics(					Column			*	column)						const;
 				Json::Value					serializeColumn(					const std::string & columnName)					const;
 				void						deserializeColumn(					const std::string & columnName, const Json::Value& col);
 
@@ -342,6 +348,17 @@ private:
 				int					getColIndex(QVariant colID);
 				void				columnsApply(intset columnIndexes, std::function<bool (Column *)> applyThis);
 				void				columnsApply(intset columnIndexes, std::function<bool (Column *, int)> applyThis);
+				bool				_initColumn(QVariant colId, const std::string & newName, const std::string & title, columnType desiredType, const stringset & emptyValues, std::function<columnType (Column *, int, bool *)> setValues);
+				void				_initColumnFinish(Column * column, columnType desiredType, columnType suggestedType);
+
+	struct DeferredColumnInit
+	{
+		Column												*	column;
+		int														threshold;
+		columnType												desiredType,
+																suggestedType;
+		std::function<columnType (Column *, int, bool *)>		setValues;		///< Refers to the values given to initColumnWith*, so those must outlive endInitColumns
+	};
 
 private:
 	static DataSetPackage	*	_singleton;
@@ -371,7 +388,9 @@ private:
 	Version						_archiveVersion,
 								_jaspVersion;
 
-	bool						_synchingData				= false;
+	bool						_synchingData				= false,
+								_initColumnsDeferred		= false;
+	std::vector<DeferredColumnInit>	_deferredColumnInits;
 	std::map<std::string, bool> _columnNameUsedInEasyFilter;
 
 	SubNodeModel			*	_dataSubModel,
@@ -35,7 +35,8 @@ DECLARE_ENUM(
 		totalLevels,
 		previewScale,
 		previewOrdinal,
-		previewNominal
+		previewNominal,
+		statistics
 );
 
 #endif // DATASETPACKAGEENUMS_H
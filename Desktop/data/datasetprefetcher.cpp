@@ -0,0 +1,426 @@
+#include "datasetprefetcher.h"
+#include "datasettablemodel.h"
+#include "columnutils.h"
+#include "timers.h"
+#include "utilities/qutils.h"
+#include <QTimer>
+#include <cmath>
+#include <algorithm>
+
+DataSetPrefetcher::DataSetPrefetcher(DataSetTableModel * model)
+	: QObject(model), _model(model)
+{
+	_ring.resize(ringBlocks);
+
+	//These are connected before any view gets to see the model, so the cache is always cleared before a view asks for the new data
+	connect(_model, &QAbstractItemModel::dataChanged,			this, &DataSetPrefetcher::dataChanged);
+	connect(_model, &QAbstractItemModel::headerDataChanged,		this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::modelReset,			this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::layoutChanged,			this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::rowsInserted,			this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::rowsRemoved,			this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::columnsInserted,		this, &DataSetPrefetcher::clear);
+	connect(_model, &QAbstractItemModel::columnsRemoved,		this, &DataSetPrefetcher::clear);
+	connect(_model, &DataSetTableModel::labelChanged,			this, &DataSetPrefetcher::clear);
+	connect(_model, &DataSetTableModel::labelsReordered,		this, &DataSetPrefetcher::clear);
+	connect(_model, &DataSetTableModel::emptyValuesChanged,		this, &DataSetPrefetcher::clear);
+
+#ifndef PROFILE_JASP //The timers are not threadsafe, so then everything is formatted on the GUI thread as soon as it is requested
+	_worker = std::thread(&DataSetPrefetcher::_work, this);
+#endif
+}
+
+DataSetPrefetcher::~DataSetPrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(_jobsLock);
+		_stop = true;
+	}
+
+	_jobsWaiting.notify_all();
+
+	if(_worker.joinable())
+		_worker.join();
+}
+
+bool DataSetPrefetcher::handles(int row, int col) const
+{
+	return row >= 0 && col >= 0 && row < _model->rowCount() && col < _model->columnCount();
+}
+
+const DataSetPrefetcher::Cell * DataSetPrefetcher::cell(int row, int col)
+{
+	if(!handles(row, col))
+		return nullptr;
+
+	BlockKey	key(col, row / blockRows);
+	auto		found = _ringIndex.find(key);
+
+	if(found == _ringIndex.end())
+	{
+		_request(key, true);
+
+		found = _ringIndex.find(key); //Could be there already when there is no worker
+
+		if(found == _ringIndex.end())
+		{
+			_missed = true;
+			return nullptr;
+		}
+	}
+
+	const Block & block = _ring[found->second];
+	size_t		  inBlock = row % blockRows;
+
+	return inBlock < block.cells.size() ? &block.cells[inBlock] : nullptr;
+}
+
+void DataSetPrefetcher::viewportMoved(int rowMin, int rowMax, int colMin, int colMax)
+{
+	JASPTIMER_SCOPE(DataSetPrefetcher::viewportMoved);
+
+	if(rowMin < 0 || colMin < 0 || rowMax <= rowMin || colMax <= colMin)
+		return;
+
+	//A view that only rebuilds its cells must not look like a scroll that stopped, nor drop what is being formatted ahead
+	if(rowMin == _lastRowMin && rowMax == _lastRowMax && colMin == _lastColMin && colMax == _lastColMax)
+		return;
+
+	if(!_sinceLastMove.isValid() || _lastRowMin == -1)
+		_sinceLastMove.start();
+	else
+	{
+		double seconds = std::max(0.001, _sinceLastMove.restart() / 1000.0);
+
+		//Somebody that stopped scrolling for a bit will probably not continue at the same speed
+		_rowsPerSecond = seconds > 0.5 ? 0 : 0.5 * _rowsPerSecond + 0.5 * ((rowMin - _lastRowMin) / seconds);
+	}
+
+	_lastRowMin = rowMin;
+	_lastRowMax = rowMax;
+	_lastColMin = colMin;
+	_lastColMax = colMax;
+
+	//Whatever was still waiting for where the viewport was before is not interesting anymore, what is visible gets requested by cell() anyway
+	{
+		std::lock_guard<std::mutex> lock(_jobsLock);
+
+		for(auto job = _jobs.begin(); job != _jobs.end();)
+			if(job->urgent)
+				job++;
+			else
+			{
+				_requested.erase(job->key);
+				job = _jobs.erase(job);
+			}
+	}
+
+	const int	columns		= colMax - colMin,
+				firstBlock	= rowMin / blockRows,
+				lastBlock	= (rowMax - 1) / blockRows,
+				maxAhead	= std::max(1, ringBlocks / (4 * columns)), //Never let prefetching push what is visible out of the ring
+				ahead		= std::clamp(int(std::abs(_rowsPerSecond) * 0.5 / blockRows) + 1, 1, maxAhead); //About half a second of scrolling
+
+	for(int a=1; a<=ahead; a++)
+		for(int col=colMin; col<colMax; col++)
+		{
+			if(_rowsPerSecond >= 0)	_request(BlockKey(col, lastBlock  + a), false);
+			if(_rowsPerSecond <= 0)	_request(BlockKey(col, firstBlock - a), false);
+		}
+}
+
+void DataSetPrefetcher::clear()
+{
+	_generation++;
+
+	for(Block & block : _ring)
+	{
+		block.key = { -1, -1 };
+		block.cells.clear();
+	}
+
+	_ringIndex		.clear();
+	_requested		.clear();
+	_labelsPerColumn.clear();
+	_ringNext		= 0;
+
+	std::lock_guard<std::mutex> lock(_jobsLock);
+	_jobs.clear();
+}
+
+void DataSetPrefetcher::dataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight)
+{
+	if(!topLeft.isValid() || !bottomRight.isValid())
+	{
+		clear();
+		return;
+	}
+
+	JASPTIMER_SCOPE(DataSetPrefetcher::dataChanged);
+
+	const int	colMin		= topLeft.column(),
+				colMax		= bottomRight.column(),
+				blockMin	= topLeft.row()		/ blockRows,
+				blockMax	= bottomRight.row()	/ blockRows;
+
+	auto changedColumn	= [&](const BlockKey & key) { return key.first >= colMin && key.first <= colMax; };
+	auto changedBlock	= [&](const BlockKey & key) { return changedColumn(key) && key.second >= blockMin && key.second <= blockMax; };
+
+	for(Block & block : _ring)
+		if(block.key.first != -1 && changedBlock(block.key))
+		{
+			_ringIndex.erase(block.key);
+			block.key = { -1, -1 };
+			block.cells.clear();
+		}
+
+	//Whatever is being formatted for these columns right now is thrown away when it comes back, so it must be requested again
+	for(int col=colMin; col<=colMax; col++)
+		_columnGenerations[col]++;
+
+	for(auto key = _requested.begin(); key != _requested.end();)
+		if(changedColumn(*key))	key = _requested.erase(key);
+		else					key++;
+
+	//An edit can add a label, the tables are rebuilt for any column on demand
+	_labelsPerColumn.clear();
+
+	std::lock_guard<std::mutex> lock(_jobsLock);
+
+	for(auto job = _jobs.begin(); job != _jobs.end();)
+		if(changedColumn(job->key))	job = _jobs.erase(job);
+		else						job++;
+}
+
+void DataSetPrefetcher::_request(const BlockKey & key, bool urgent)
+{
+	if(_ringIndex.count(key))
+		return;
+
+	if(_requested.count(key))
+	{
+		if(urgent) //It is visible now, so move it to the front
+		{
+			std::lock_guard<std::mutex> lock(_jobsLock);
+
+			for(auto job = _jobs.begin(); job != _jobs.end(); job++)
+				if(job->key == key)
+				{
+					Job moved = std::move(*job);
+					moved.urgent = true;
+					_jobs.erase(job);
+					_jobs.push_front(std::move(moved));
+					break;
+				}
+		}
+
+		return;
+	}
+
+	Job job;
+
+	if(!_makeJob(key, job))
+		return;
+
+	job.urgent = urgent;
+	_requested.insert(key);
+
+#ifdef PROFILE_JASP
+	_store(job.generation, job.columnGeneration, key, _format(job));
+#else
+	{
+		std::lock_guard<std::mutex> lock(_jobsLock);
+
+		if(urgent)	_jobs.push_front(std::move(job));
+		else		_jobs.push_back(std::move(job));
+	}
+
+	_jobsWaiting.notify_one();
+#endif
+}
+
+bool DataSetPrefetcher::_makeJob(const BlockKey & key, Job & job)
+{
+	const int	col			= key.first,
+				rowMin		= key.second * blockRows,
+				rowMax		= std::min(rowMin + blockRows, _model->rowCount());
+	DataSet	*	dataSet		= DataSetPackage::pkg()->dataSet();
+
+	if(!dataSet || !handles(rowMin, col))
+		return false;
+
+	JASPTIMER_SCOPE(DataSetPrefetcher::_makeJob);
+
+	const int	pkgCol		= _model->data(_model->index(0, col), int(DataSetPackage::specialRoles::columnPkgIndex)).toInt();
+	Column	*	column		= dataSet->column(pkgCol);
+
+	if(!column)
+		return false;
+
+	const std::vector<bool> &	filtered	= dataSet->filter()->filtered();
+	const bool					lastColumn	= pkgCol == dataSet->columnCount() - 1;
+
+	//Same as DataSetPackage::getRowFilter
+	auto rowActive = [&](size_t row) { return row >= filtered.size() || filtered[row]; };
+
+	auto & labels = _labelsPerColumn[pkgCol];
+
+	if(!labels)
+	{
+		auto table = std::make_shared<std::map<int, Job::LabelStrings>>();
+
+		for(const Label * label : column->labels())
+			(*table)[label->intsId()] = { label->labelDisplay(), label->labelIgnoreEmpty(), label->originalValueAsString(true) };
+
+		labels = table;
+	}
+
+	job.generation			= _generation;
+	job.columnGeneration	= _columnGenerations[col];
+	job.key					= key;
+	job.type				= column->type();
+	job.labels				= labels;
+	job.emptyDisplay		= EmptyValues::displayString();
+
+	job.dbls	.reserve(rowMax - rowMin);
+	job.ints	.reserve(rowMax - rowMin);
+	job.empty	.reserve(rowMax - rowMin);
+	job.lines	.reserve(rowMax - rowMin);
+
+	for(int row=rowMin; row<rowMax; row++)
+	{
+		size_t source = _model->mapToSource(_model->index(row, col)).row();
+
+		if(source < column->rowCount())
+		{
+			job.dbls .push_back(column->dbls()[source]);
+			job.ints .push_back(column->ints()[source]);
+			job.empty.push_back(column->isEmptyValue(column->dbls()[source]));
+		}
+		else
+		{
+			job.dbls .push_back(EmptyValues::missingValueDouble);
+			job.ints .push_back(EmptyValues::missingValueInteger);
+			job.empty.push_back(true);
+		}
+
+		//Same as specialRoles::lines in DataSetPackage::data, but without asking the model about the row below
+		bool	iAmActive		= rowActive(source),
+				belowMeIsActive = source + 1 < column->rowCount() && rowActive(source + 1);
+
+		job.lines.push_back(DataSetPackage::getDataSetViewLines(iAmActive, iAmActive, iAmActive && !belowMeIsActive, iAmActive && lastColumn).toInt());
+	}
+
+	return true;
+}
+
+std::vector<DataSetPrefetcher::Cell> DataSetPrefetcher::_format(const Job & job)
+{
+	JASPTIMER_SCOPE(DataSetPrefetcher::_format);
+
+	auto labelFor = [&](int intsId) -> const Job::LabelStrings *
+	{
+		auto found = job.labels->find(intsId);
+		return found == job.labels->end() ? nullptr : &found->second;
+	};
+
+	//The following three are Column::doubleToDisplayString, Column::getValue and Column::getLabel with fancyEmptyValue
+	auto dblString = [&](size_t i, bool ignoreEmptyValue) -> std::string
+	{
+		ignoreEmptyValue = ignoreEmptyValue && !std::isnan(job.dbls[i]);
+
+		return job.empty[i] && !ignoreEmptyValue ? job.emptyDisplay : ColumnUtils::doubleToString(job.dbls[i]);
+	};
+
+	auto value = [&](size_t i, bool ignoreEmptyValue) -> std::string
+	{
+		if(job.type == columnType::scale || job.ints[i] == Label::DOUBLE_LABEL_VALUE)
+			return dblString(i, ignoreEmptyValue);
+
+		if(job.ints[i] != EmptyValues::missingValueInteger)
+			if(const Job::LabelStrings * label = labelFor(job.ints[i]))
+				return label->value;
+
+		return job.emptyDisplay;
+	};
+
+	auto label = [&](size_t i, bool ignoreEmptyValue) -> std::string
+	{
+		if(job.ints[i] == Label::DOUBLE_LABEL_VALUE)
+			return dblString(i, ignoreEmptyValue);
+
+		if(job.ints[i] == EmptyValues::missingValueInteger)
+			return job.emptyDisplay;
+
+		if(const Job::LabelStrings * label = labelFor(job.ints[i]))
+			return ignoreEmptyValue ? label->ignoreEmpty : label->display;
+
+		return std::to_string(job.ints[i]);
+	};
+
+	std::vector<Cell> cells(job.dbls.size());
+
+	for(size_t i=0; i<cells.size(); i++)
+	{
+		//Column::getDisplay and Column::getShadow
+		cells[i].display	= tq(job.type == columnType::scale ? value(i, false) : label(i, false));
+		cells[i].shadow		= tq(job.type != columnType::scale ? value(i, true)  : label(i, true));
+		cells[i].lines		= job.lines[i];
+	}
+
+	return cells;
+}
+
+void DataSetPrefetcher::_work()
+{
+	for(;;)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(_jobsLock);
+			_jobsWaiting.wait(lock, [&]() { return _stop || !_jobs.empty(); });
+
+			if(_stop)
+				return;
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		std::vector<Cell> cells = _format(job);
+
+		QMetaObject::invokeMethod(this, [this, generation = job.generation, columnGeneration = job.columnGeneration, key = job.key, cells = std::move(cells)]() mutable { _store(generation, columnGeneration, key, std::move(cells)); }, Qt::QueuedConnection);
+	}
+}
+
+void DataSetPrefetcher::_store(size_t generation, size_t columnGeneration, const BlockKey & key, std::vector<Cell> && cells)
+{
+	if(generation != _generation || columnGeneration != _columnGenerations[key.first]) //The data changed while it was being formatted
+		return;
+
+	_requested.erase(key);
+
+	Block & block = _ring[_ringNext];
+
+	if(block.key.first != -1)
+		_ringIndex.erase(block.key);
+
+	block.key		= key;
+	block.cells		= std::move(cells);
+	_ringIndex[key]	= _ringNext;
+	_ringNext		= (_ringNext + 1) % _ring.size();
+
+	//Blocks tend to come in quick succession, let the views only look once per frame or so
+	if(_missed && !_readyPending)
+	{
+		_readyPending = true;
+
+		QTimer::singleShot(16, this, [this]()
+		{
+			_readyPending	= false;
+			_missed			= false;
+			emit cellsReady();
+		});
+	}
+}
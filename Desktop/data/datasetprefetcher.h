@@ -0,0 +1,115 @@
+#ifndef DATASETPREFETCHER_H
+#define DATASETPREFETCHER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <set>
+#include "column.h"
+
+class DataSetTableModel;
+
+///
+/// Formats the display and shadow strings of the cells DataSetView is about to show on a worker thread, so scrolling through a couple of million rows does not have the GUI thread waiting on Column::getDisplay.
+///
+/// The worker never touches a Column, that would race with every edit. Instead the GUI thread copies the raw values of a block of rows of a column together with the strings of its labels, which is cheap, and the worker turns those into text the same way Column::getDisplay and Column::getShadow do.
+/// The results go into a ring of blocks of fixed size, the oldest block gets overwritten first. A change to some values only forgets the blocks they are in, any other change to the model clears it. Results still underway for the old data are thrown away when they come back.
+///
+/// Which blocks are formatted follows the viewport: whatever is visible first and then as far ahead in the direction of scrolling as the speed of scrolling suggests.
+class DataSetPrefetcher : public QObject
+{
+	Q_OBJECT
+
+public:
+	struct Cell
+	{
+		QString			display,
+						shadow;
+		unsigned char	lines	= 0;	///< As DataSetPackage::getDataSetViewLines
+	};
+
+							DataSetPrefetcher(DataSetTableModel * model);
+							~DataSetPrefetcher();
+
+	bool					handles(int row, int col)	const;	///< Whether the cell is in the model at all, the virtual ones ExpandDataProxyModel adds aren't
+	const Cell			*	cell(	int row, int col);			///< nullptr if it isnt formatted yet, the block it is in will then be done before anything else. cellsReady is emitted once it is there.
+	void					viewportMoved(int rowMin, int rowMax, int colMin, int colMax);
+
+	static const int		blockRows		= 32,
+							ringBlocks		= 8192;
+
+signals:
+	void					cellsReady();
+
+public slots:
+	void					clear();
+	void					dataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight);	///< Forgets only the blocks in the changed range
+
+private:
+	typedef std::pair<int, int>	BlockKey; ///< col, row / blockRows
+
+	///What the worker needs to format a block, copied from the Column on the GUI thread
+	struct Job
+	{
+		struct LabelStrings
+		{
+			std::string		display,
+							ignoreEmpty,
+							value;
+		};
+
+		size_t									generation,
+												columnGeneration;
+		BlockKey								key;
+		bool									urgent			= false;	///< Visible and not there yet
+		columnType								type;
+		doublevec								dbls;
+		intvec									ints;
+		boolvec									empty;			///< Column::isEmptyValue for each of dbls
+		std::vector<unsigned char>				lines;
+		std::shared_ptr<const std::map<int, LabelStrings>>	labels;
+		std::string								emptyDisplay;	///< EmptyValues::displayString()
+	};
+
+	struct Block
+	{
+		BlockKey								key		= { -1, -1 };
+		std::vector<Cell>						cells;
+	};
+
+	void					_request(			const BlockKey & key, bool urgent);
+	bool					_makeJob(			const BlockKey & key, Job & job);
+	void					_store(				size_t generation, size_t columnGeneration, const BlockKey & key, std::vector<Cell> && cells);
+	void					_work();
+
+	static std::vector<Cell>	_format(		const Job & job);
+
+	DataSetTableModel									*	_model;
+	std::vector<Block>										_ring;
+	std::map<BlockKey, size_t>								_ringIndex;
+	size_t													_ringNext		= 0,
+															_generation		= 0;
+	std::set<BlockKey>										_requested;
+	std::map<int, std::shared_ptr<const std::map<int, Job::LabelStrings>>>	_labelsPerColumn;
+	std::map<int, size_t>									_columnGenerations;	///< Increased by dataChanged, so blocks of a changed column that were still being formatted get thrown away
+	bool													_missed			= false,
+															_readyPending	= false;
+
+	int														_lastRowMin		= -1,
+															_lastRowMax		= -1,
+															_lastColMin		= -1,
+															_lastColMax		= -1;
+	double													_rowsPerSecond	= 0;
+	QElapsedTimer											_sinceLastMove;
+
+	std::mutex												_jobsLock;
+	std::condition_variable									_jobsWaiting;
+	std::deque<Job>											_jobs;
+	bool													_stop			= false;
+	std::thread												_worker;
+};
+
+#endif // DATASETPREFETCHER_H
@@ -17,6 +17,7 @@
 //
 
 #include "datasettablemodel.h"
+#include "datasetprefetcher.h"
 #include "utilities/qutils.h"
 #include "log.h"
 
@@ -47,6 +48,14 @@ void DataSetTableModel::setShowInactive(bool showInactive)
 	endResetModel();
 }
 
+DataSetPrefetcher * DataSetTableModel::prefetcher()
+{
+	if(!_prefetcher)
+		_prefetcher = new DataSetPrefetcher(this);
+
+	return _prefetcher;
+}
+
 bool DataSetTableModel::filterAcceptsRow(int source_row, const QModelIndex & source_parent)	const
 {
 	return (_showInactive || DataSetPackage::pkg()->getRowFilter(source_row));
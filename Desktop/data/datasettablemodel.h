@@ -21,6 +21,8 @@
 
 #include "datasettableproxy.h"
 
+class DataSetPrefetcher;
+
 
 ///
 /// Makes sure that the data from DataSetPackage is properly filtered (and possible sorted) and then passed on as a normal table-model to QML
@@ -51,6 +53,8 @@ public:
 
 	QString					insertColumnSpecial(int column, const QMap<QString, QVariant>& props);
 
+	DataSetPrefetcher	*	prefetcher(); ///< Made the first time somebody asks, views that use it should do so before connecting to this model
+
 signals:
 	void					columnsFilteredCountChanged();
 	void					showInactiveChanged(bool showInactive);
@@ -68,6 +72,7 @@ public slots:
 
 private:
 	bool					_showInactive;
+	DataSetPrefetcher	*	_prefetcher = nullptr;
 
 };
 
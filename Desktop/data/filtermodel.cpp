@@ -1,5 +1,6 @@
 #include "filtermodel.h"
 #include "jsonutilities.h"
+#include "filterevaluator.h"
 #include "columnencoder.h"
 #include "timers.h"
 
@@ -184,7 +185,7 @@ void FilterModel::processFilterResult(int requestId)
 	if(DataSetPackage::pkg()->dataSet()->filter()->dbLoadResultAndError())
 	{
 		emit filterErrorMsgChanged();
-		emit refreshAllAnalyses();
+		emit refreshAnalysesUsingFilter();
 		emit filterUpdated();
 		updateStatusBar();
 	}
@@ -201,7 +202,17 @@ void FilterModel::sendGeneratedAndRFilter()
 	JASPTIMER_SCOPE(FilterModel::sendGeneratedAndRFilter);
 
 	setFilterErrorMsg("");
-	_lastSentRequestId = emit sendFilter(generatedFilter(), rFilter());
+	_lastSentRequestId = emit sendFilter(generatedFilter(), rFilter(), _canRunWithoutR() ? constructorJson() : "");
+}
+
+bool FilterModel::_canRunWithoutR()
+{
+	JASPTIMER_SCOPE(FilterModel::_canRunWithoutR);
+
+	//The generatedFilter must still match the labels and the drag&drop filter, as that is what FilterEvaluator looks at instead
+	return	DataSetPackage::pkg()->dataSet() &&
+			generatedFilter() == tq(_labelFilterGenerator->generateFilter()) &&
+			FilterEvaluator(DataSetPackage::pkg()->dataSet()).canEvaluate(fq(rFilter()), fq(constructorJson()));
 }
 
 void FilterModel::updateStatusBar()
@@ -279,7 +290,7 @@ void FilterModel::datasetChanged(	QStringList             changedColumns,
 		if(DataSetPackage::filter())
 			DataSetPackage::filter()->reset();
 
-		emit refreshAllAnalyses();
+		emit refreshAnalysesUsingFilter();
 		emit filterUpdated();
 		updateStatusBar();
 
@@ -79,16 +79,17 @@ signals:
 
 	void updateColumnsUsedInConstructedFilter(std::set<std::string> columnNames);
 
-	void refreshAllAnalyses();
+	void refreshAnalysesUsingFilter();
 	void filterUpdated();
 
-	int sendFilter(QString generatedFilter, QString rFilter);
+	int sendFilter(QString generatedFilter, QString rFilter, QString nativeConstructorJson); ///< nativeConstructorJson is only set when FilterEvaluator can run the filter instead of R
 
 	void defaultRFilterChanged(); //Will never be called
 
 private:
 	bool _setGeneratedFilter(const QString& newGeneratedFilter);
 	bool _setRFilter(const QString& newRFilter);
+	bool _canRunWithoutR();
 
 private:
 	labelFilterGenerator	*	_labelFilterGenerator	= nullptr;
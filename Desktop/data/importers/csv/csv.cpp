@@ -18,12 +18,17 @@
 #include "csv.h"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include "utilities/codepageswindows.h"
 
 #include <cstring>
 #include <stdexcept>
+#include <atomic>
+#include <future>
 
 #include "utils.h"
+#include "log.h"
 #include "utilities/qutils.h"
 #include "utilities/settings.h"
 
@@ -43,7 +48,7 @@ CSV::CSV(const string &path)
 }
 
 
-void CSV::open()
+void CSV::open(bool countRows)
 {
 	_fileSize = Utils::getFileSize(_path);
 
@@ -60,6 +65,11 @@ void CSV::open()
 	_rawBufferEndPos = 0;
 	_utf8BufferStartPos = 0;
 	_utf8BufferEndPos = 0;
+	_filePosition = 0;
+	_eof = false;
+
+	if(_stream.is_open())
+		_stream.close();
 
 	_stream.open(_path.c_str(), ios::in);
 
@@ -72,7 +82,8 @@ void CSV::open()
 	if (readRaw())
 	{
 		determineEncoding();
-		determineNumRows();
+		if(countRows) //Not needed when reading in parallel, the chunks are simply concatenated afterwards
+			determineNumRows();
 		readUtf8();
 		determineDelimiters();
 	}
@@ -545,6 +556,189 @@ bool CSV::readLine(vector<string> &items)
 	return true;
 }
 
+void CSV::readLinesParallel(size_t chunkCount, ProcessLine processLine, std::function<void(long bytesRead)> progress, bool skipHeader, size_t fromByte, std::function<void(const char * data, size_t size)> mapped)
+{
+	using namespace boost::interprocess;
+
+	//A file of 0 bytes cannot be mapped, and it might have been emptied since open() when it is being synchronized
+	if(Utils::getFileSize(_path) <= 0)
+	{
+		Log::log() << "CSV::readLinesParallel found '" << _path << "' to be empty, there is nothing to read." << std::endl;
+		return;
+	}
+
+	file_mapping	mapping	(_path.c_str(), read_only);
+	mapped_region	region	(mapping, read_only);
+
+	const char	*	data	= static_cast<const char*>(region.get_address());
+	const size_t	size	= region.get_size();
+	size_t			start	= size >= 3 && data[0] == -17 && data[1] == -69 && data[2] == -65 ? 3 : 0; //skip the BOM
+
+	start = std::min(size, std::max(start, fromByte));
+
+	chunkCount = std::max(size_t(1), std::min(chunkCount, (size - start) / 4096 + 1)); //No use in spinning up threads for a handful of lines
+
+	// Find the start of each chunk: the first line after size/chunkCount * chunk that does not start in the middle of a quoted value.
+	// Whether we are inside a quote can only be known by scanning from the start, but that is a lot cheaper than the actual tokenizing.
+	std::vector<size_t>	bounds	= { start };
+	bool				inQuote	= false;
+	size_t				pos		= start;
+
+	for(size_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		size_t target = start + ((size - start) * chunk) / chunkCount;
+
+		for(; pos < target; pos++)
+			if(data[pos] == '"')
+				inQuote = !inQuote;
+
+		for(; pos < size; pos++)
+			if(data[pos] == '"')
+				inQuote = !inQuote;
+			else if(!inQuote && (data[pos] == '\r' || data[pos] == '\n'))
+				break;
+
+		while(pos < size && (data[pos] == '\r' || data[pos] == '\n'))
+			pos++;
+
+		bounds.push_back(pos);
+	}
+	bounds.push_back(size);
+
+	std::vector<std::future<void>>	chunks;
+	std::atomic<long>				bytesRead(start);
+
+	for(size_t chunk = 0; chunk < chunkCount; chunk++)
+		chunks.push_back(std::async(std::launch::async, [&, chunk]()
+		{
+			readChunk(data + bounds[chunk], data + bounds[chunk + 1], chunk, processLine, skipHeader && chunk == 0);
+			bytesRead += bounds[chunk + 1] - bounds[chunk];
+		}));
+
+	if(mapped)
+		mapped(data, size);
+
+	// Progress is reported from the calling thread, so the callback need not care about threads
+	for(std::future<void> & chunk : chunks)
+		while(chunk.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+			progress(bytesRead);
+
+	for(std::future<void> & chunk : chunks)
+		chunk.get(); //rethrows whatever went wrong in the chunk
+
+	_filePosition	= _fileSize;
+	_eof			= true;
+
+	progress(bytesRead);
+}
+
+void CSV::readChunk(const char * begin, const char * end, size_t chunk, ProcessLine & processLine, bool skipFirstLine) const
+{
+	// Same rules as readLine, but on a piece of memory that always ends on a line ending.
+	vector<string>	items;
+	bool			inQuote		= false;
+	const char	*	tokenStart	= begin;
+
+	auto addToken = [&](const char * tokenEnd)
+	{
+		std::string token(tokenStart, tokenEnd - tokenStart);
+		trim(token);
+		items.push_back(token);
+	};
+
+	auto finishLine = [&]()
+	{
+		for(std::string & item : items)
+			finishItem(item);
+
+		if(skipFirstLine)	skipFirstLine = false;
+		else				processLine(chunk, items);
+
+		items.clear();
+	};
+
+	for(const char * i = begin; i < end; i++)
+	{
+		char ch = *i;
+
+		if (ch == '"')
+		{
+			if (inQuote && i + 1 < end && i[1] == '"')
+				i++;
+			else
+				inQuote = !inQuote;
+		}
+
+		if (inQuote)
+		{
+			// do nothing
+		}
+		else if (ch == _delim)
+		{
+			addToken(i);
+			tokenStart = i + 1;
+		}
+		else if (ch == '\r' || ch == '\n')
+		{
+			if (items.size() > 0 || i > tokenStart)
+				addToken(i);
+
+			if (ch == '\r' && i + 1 < end && i[1] == '\n')
+				i++;
+
+			tokenStart = i + 1;
+
+			if (items.size() > 0)
+				finishLine();
+		}
+	}
+
+	if (items.size() > 0 || end > tokenStart)
+	{
+		addToken(end);
+		finishLine();
+	}
+}
+
+void CSV::finishItem(std::string & item)
+{
+	sanitizeUtf8(item);
+	boost::algorithm::replace_all(item, "\n", " ");
+	if (item.size() >= 2 && item[0] == '"' && item[item.size()-1] == '"')
+		item = item.substr(1, item.size()-2);
+}
+
+void CSV::sanitizeUtf8(std::string & item)
+{
+	// Same as the check at the end of readUtf8, the mapped file is never written to so it is done per value here.
+	const size_t size = item.size();
+
+	for (size_t i = 0 ; i < size; i++)
+	{
+		unsigned char ch = item[i];
+
+		if (ch < 0x80) // ascii
+			continue;
+
+		size_t follows = ch < 0xC0 ? 0 : ch < 0xE0 ? 1 : ch < 0xF0 ? 2 : ch < 0xF8 ? 3 : 0;
+
+		if (follows == 0) // illegal
+		{
+			item[i] = '.';
+			continue;
+		}
+
+		bool ascii = true;
+		for (size_t f = 1; f <= follows && i + f < size; f++)
+			ascii = ascii && (unsigned char)item[i + f] < 0x80;
+
+		if (ascii)
+			item[i] = '.';
+		else
+			i += follows;
+	}
+}
+
 long CSV::pos()
 {
 	return _filePosition;
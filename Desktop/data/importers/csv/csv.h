@@ -23,6 +23,7 @@
 #include <string>
 #include <stdint.h>
 #include <fstream>
+#include <functional>
 
 ///
 /// This files is used to read CSV files
@@ -30,13 +31,20 @@
 /// And otherwise it just looks at the characters and sees if any of the codes for multiple bytes etc are present.
 /// It also tries to determine the delimiter by looking at the first line and trying some fun heuristics.
 /// If it finds nothing (one column for instance, or something crazy) it defaults to comma
+///
+/// UTF8 files can also be read with readLinesParallel, which maps the file into memory and splits it into chunks on line endings outside of quotes.
+/// Each chunk is then tokenized on its own thread, following the same rules as readLine.
 class CSV
 {
 public:
 	CSV(const std::string &path);
 
-	void open();
+	typedef std::function<void(size_t chunk, std::vector<std::string> & items)> ProcessLine;
+
+	void open(bool countRows = true);
 	bool readLine(std::vector<std::string> &items);
+	bool canReadParallel() const { return _encoding == UTF8 && _fileSize > 0; }
+	void readLinesParallel(size_t chunkCount, ProcessLine processLine, std::function<void(long bytesRead)> progress, bool skipHeader = true, size_t fromByte = 0, std::function<void(const char * data, size_t size)> mapped = nullptr);	///< processLine is called from several threads at once, but for one chunk always from the same thread and in order of the lines in the file. fromByte should be the start of a line. mapped gets the whole file on the calling thread while the chunks are being read.
 	long pos();
 	long size();
 	long numRows();
@@ -64,6 +72,11 @@ private:
 	void determineDelimiters(size_t fromHere = 0);
 	void determineNumRows();
 
+	void readChunk(const char * begin, const char * end, size_t chunk, ProcessLine & processLine, bool skipFirstLine) const;
+
+	static void finishItem(std::string & item);
+	static void sanitizeUtf8(std::string & item);
+
 private:
 
 	Status _status;
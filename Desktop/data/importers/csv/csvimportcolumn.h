@@ -1,26 +1,16 @@
 #ifndef CSVIMPORTCOLUMN_H
 #define CSVIMPORTCOLUMN_H
 
-#include "../importcolumn.h"
+#include "../typedimportcolumn.h"
 
 ///
 /// Storing a column during import of a CSV
-class CSVImportColumn : public ImportColumn
+/// Each value is parsed as it is read, see TypedImportColumn
+class CSVImportColumn : public TypedImportColumn
 {
 public:
-							CSVImportColumn(ImportDataSet* importDataSet, std::string name);
-							CSVImportColumn(ImportDataSet* importDataSet, std::string name, long reserve);
-							~CSVImportColumn()	override;
-
-			size_t			size()									const	override;
-	const	stringvec	&	allValuesAsStrings()					const	override { return  _data; }
-			void			addValue(const std::string &value);
-	const	stringvec	&	getValues()								const;
-
-
-private:
-	stringvec _data;
-
+	CSVImportColumn(ImportDataSet* importDataSet, std::string name)					: TypedImportColumn(importDataSet, name)			{}
+	CSVImportColumn(ImportDataSet* importDataSet, std::string name, long reserve)	: TypedImportColumn(importDataSet, name, reserve)	{}
 };
 
 #endif // CSVIMPORTCOLUMN_H
@@ -18,7 +18,10 @@
 #include "csvimporter.h"
 #include "csv/csvimportcolumn.h"
 #include "csv/csv.h"
+#include "datafilefingerprint.h"
+#include "../datasetpackage.h"
 #include "timers.h"
+#include <thread>
 
 using namespace std;
 
@@ -29,12 +32,55 @@ CSVImporter::CSVImporter() : Importer()
 
 ImportDataSet* CSVImporter::loadFile(const string &locator, std::function<void(int)> progressCallback)
 {
+	_fingerprint.clear();
+
+	return _loadFile(locator, 0, progressCallback);
+}
+
+ImportDataSet* CSVImporter::loadAppendedRows(const string &locator, std::function<void(int)> progressCallback)
+{
+	DataSetPackage	*	pkg				= DataSetPackage::pkg();
+	size_t				unchangedBytes	= 0;
+
+	_fingerprintComplete = false;
+
+	//compare fills _fingerprint with the old part of the file, reading the new rows then adds the rest
+	switch(DataFileFingerprint::compare(pkg->dataFileFingerprint(), locator, pkg->dataRowCount(), unchangedBytes, _fingerprint))
+	{
+	case DataFileFingerprint::Change::None:		_fingerprintComplete = true; return new ImportDataSet(this);
+	case DataFileFingerprint::Change::Appended:	return _loadFile(locator, unchangedBytes, progressCallback);
+	case DataFileFingerprint::Change::Other:	break;
+	}
+
+	return nullptr;
+}
+
+void CSVImporter::dataSourceWasRead(const string &locator)
+{
+	const size_t rowCount = DataSetPackage::pkg()->dataRowCount();
+
+	DataSetPackage::pkg()->setDataFileFingerprint(_fingerprintComplete ? _fingerprint.toString(rowCount) : DataFileFingerprint::create(locator, rowCount));
+}
+
+ImportDataSet* CSVImporter::_loadFile(const string &locator, size_t fromByte, std::function<void(int)> progressCallback)
+{
+	CSV csv(locator);
+	csv.open(false);
+
+	const bool parallel = csv.canReadParallel();
+
+	_fingerprintComplete = false;
+
+	if(fromByte > 0 && !parallel) //Only the memory mapped reader can start somewhere in the middle
+		return nullptr;
+
 	JASPTIMER_RESUME(CSVImporter::loadFile);
-	
+
+	if(!parallel)
+		csv.open(); //Read line by line, so count the rows first to be able to reserve the columns
+
 	ImportDataSet* result = new ImportDataSet(this);
 	stringvec colNames;
-	CSV csv(locator);
-    csv.open();
 
 	csv.readLine(colNames);
 	vector<CSVImportColumn *> importColumns;
@@ -71,8 +117,51 @@ ImportDataSet* CSVImporter::loadFile(const string &locator, std::function<void(i
 
 	size_t columnCount = colNames.size();
 
+	if(parallel)
+	{
+		// Each chunk of the file gets its own set of columns to fill, these are appended to importColumns in the order of the file afterwards
+		const size_t								chunkCount = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<std::vector<CSVImportColumn *>>	chunkColumns(chunkCount);
+
+		for(std::vector<CSVImportColumn *> & columns : chunkColumns)
+			for(size_t i = 0; i<columnCount; i++)
+				columns.push_back(new CSVImportColumn(result, colNames[i]));
+
+		csv.readLinesParallel(chunkCount,
+			[&](size_t chunk, stringvec & line)
+			{
+				for(size_t i = 0; i<columnCount; i++)
+					chunkColumns[chunk][i]->addValue(i < line.size() ? line[i] : ""); //add components and add empty vals for missing columns
+			},
+			[&](long bytesRead)
+			{
+				progress = 50 * bytesRead / csv.size();
+				if (progress != lastProgress)
+				{
+					progressCallback(progress);
+					lastProgress = progress;
+				}
+			},
+			fromByte == 0, fromByte,
+			[&](const char * data, size_t size)
+			{
+				if(size < _fingerprint.size()) //Shrunk since it was compared
+					return;
+
+				_fingerprint.add(data + _fingerprint.size(), size - _fingerprint.size());
+				_fingerprintComplete = true;
+			});
+
+		for(std::vector<CSVImportColumn *> & columns : chunkColumns)
+			for(size_t i = 0; i<columnCount; i++)
+			{
+				importColumns[i]->append(*columns[i]);
+				delete columns[i];
+			}
+	}
+
 	stringvec line;
-	bool success = csv.readLine(line);
+	bool success = !parallel && csv.readLine(line);
 
 	while (success)
 	{
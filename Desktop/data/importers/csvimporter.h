@@ -19,6 +19,7 @@
 #define CSVIMPORTER_H
 
 #include "importer.h"
+#include "datafilefingerprint.h"
 #include <QCoreApplication>
 #include "timers.h"
 
@@ -29,12 +30,20 @@ class CSVImporter : public Importer
 public:
 	CSVImporter();
 
-	bool importerDeliversLabels() const override { return false; } 
+	bool importerDeliversLabels()		const override { return false; } 
+	bool importerCanReadAppendedRows()	const override { return true; }
 	
 protected:
-	ImportDataSet* loadFile(const std::string &locator, std::function<void(int)> progressCallback) override;
+	ImportDataSet* loadFile(			const std::string &locator,					std::function<void(int)> progressCallback) override;
+	ImportDataSet* loadAppendedRows(	const std::string &locator,					std::function<void(int)> progressCallback) override;
+	void		   dataSourceWasRead(	const std::string &locator)																override;
 
 private:
+	ImportDataSet* _loadFile(			const std::string &locator, size_t fromByte,	std::function<void(int)> progressCallback);
+
+	DataFileFingerprint	_fingerprint;					///< Of the file as it was last read, filled while reading so dataSourceWasRead need not read it again
+	bool				_fingerprintComplete = false;	///< False when the file was read without memory mapping it
+
 	JASPTIMER_CLASS(CSVImporter);
 };
 
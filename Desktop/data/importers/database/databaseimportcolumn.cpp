@@ -1,37 +1,56 @@
 #include "databaseimportcolumn.h"
 #include "utilities/qutils.h"
 
-DatabaseImportColumn::DatabaseImportColumn(ImportDataSet* importDataSet, std::string name, QMetaType type) 
-	: ImportColumn(importDataSet, name), _type(type)
+DatabaseImportColumn::DatabaseImportColumn(ImportDataSet* importDataSet, const std::string & name) 
+	: TypedImportColumn(importDataSet, name)
 {
 }
 
-DatabaseImportColumn::~DatabaseImportColumn()
+void DatabaseImportColumn::addValue(const QVariant & value)
 {
-}
+	if(value.isNull())
+	{
+		addEmpty();
+		return;
+	}
 
-size_t DatabaseImportColumn::size() const
-{
-	return _data.size();
-}
+	switch(value.typeId())
+	{
+	case QMetaType::Long:
+	case QMetaType::ULong:
+	case QMetaType::LongLong:
+	case QMetaType::ULongLong:
+		addInteger(value);
+		break;
 
-const stringvec & DatabaseImportColumn::allValuesAsStrings() const 
-{ 
-	static stringvec strs;
-	strs.resize(_data.size());
-	
-	for(size_t i=0; i<_data.size(); i++)
-		strs[i] = fq(_data[i].toString());
-	
-	return  strs;
-}
+	case QMetaType::Short:
+	case QMetaType::UShort:
+	case QMetaType::Int:
+	case QMetaType::UInt:
+	case QMetaType::Float:
+	case QMetaType::Double:
+		addValue(value.toDouble());
+		break;
 
-void DatabaseImportColumn::addValue(const QVariant & value)
-{
-	_data.push_back(value);
+	default: //Text, but also dates, booleans and whatever the driver hands us as a string (like DECIMAL for some)
+		addValue(fq(value.toString()));
+		break;
+	}
 }
 
-const std::vector<QVariant> &DatabaseImportColumn::getValues() const
+void DatabaseImportColumn::addInteger(const QVariant & value)
 {
-	return _data;
+	const bool			isSigned	= value.typeId() == QMetaType::Long || value.typeId() == QMetaType::LongLong;
+	const qlonglong		asSigned	= value.toLongLong();
+	const qulonglong	asUnsigned	= value.toULongLong();
+	const bool			exact		= isSigned ? asSigned >= -_maxExactInteger && asSigned <= _maxExactInteger : asUnsigned <= qulonglong(_maxExactInteger);
+
+	if(!exact && !_integersAsText)
+	{
+		_integersAsText = true;
+		numbersToLabels();
+	}
+
+	if(_integersAsText)	addLabel(isSigned ? std::to_string(asSigned) : std::to_string(asUnsigned));
+	else				addValue(isSigned ? double(asSigned) : double(asUnsigned));
 }
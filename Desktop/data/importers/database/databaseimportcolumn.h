@@ -1,27 +1,26 @@
-#ifndef CSVIMPORTCOLUMN_H
-#define CSVIMPORTCOLUMN_H
+#ifndef DATABASEIMPORTCOLUMN_H
+#define DATABASEIMPORTCOLUMN_H
+
+#include "../typedimportcolumn.h"
+#include <QVariant>
 
-#include "../importcolumn.h"
-#include <QMetaType>
 ///
 /// Storing a column during import from a database
-class DatabaseImportColumn : public ImportColumn
+/// Numeric fields are stored as they come in, everything else is parsed like text, see TypedImportColumn
+/// 64-bit integers are only stored as a double while that holds them exactly, once one does not fit the whole column is kept as text so ids and such are not rounded
+class DatabaseImportColumn : public TypedImportColumn
 {
 public:
-									DatabaseImportColumn(ImportDataSet* importDataSet, std::string name, QMetaType type);
-									~DatabaseImportColumn()	override;
-
-	size_t							size()									const	override;
-	const stringvec				&	allValuesAsStrings()					const	override;
-	void							addValue(const QVariant & value);
-	const std::vector<QVariant> &	getValues()								const;
-	QMetaType						type()									const { return _type; }
+	DatabaseImportColumn(ImportDataSet* importDataSet, const std::string & name);
 
+	using TypedImportColumn::addValue;
+	void addValue(const QVariant & value);
 
 private:
-	std::vector<QVariant>	_data;
-	QMetaType				_type;
+	void addInteger(const QVariant & value);
 
+	static const qlonglong	_maxExactInteger	= 1LL << 53;
+	bool					_integersAsText		= false;
 };
 
-#endif // CSVIMPORTCOLUMN_H
+#endif // DATABASEIMPORTCOLUMN_H
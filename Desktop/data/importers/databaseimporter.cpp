@@ -2,11 +2,13 @@
 #include <QSqlRecord>
 #include <QSqlField>
 #include "database/databaseimportcolumn.h"
+#include "../datasetpackage.h"
 #include "utils.h"
 #include "timers.h"
 #include "utilities/qutils.h"
+#include <cmath>
 
-ImportDataSet * DatabaseImporter::loadFile(const std::string &locator, std::function<void(int)> progressCallback)
+void DatabaseImporter::_connect(const std::string &locator)
 {
 	// locator is the result of DatabaseConnectionInfo::toJson, so:
 	Json::Value json;
@@ -21,36 +23,98 @@ ImportDataSet * DatabaseImporter::loadFile(const std::string &locator, std::func
 										.arg(_info._hostname + ":" + tq(std::to_string(_info._port)))
 										.arg(_info._username)
 										.arg(_info.lastError())));
+}
+
+ImportDataSet * DatabaseImporter::loadFile(const std::string &locator, std::function<void(int)> progressCallback)
+{
+	_connect(locator);
 	
+	QSqlQuery		query	= _info.runQuery();
+	ImportDataSet * data	= _readQuery(query, progressCallback);
+
+	_info.close();
 	
-	
-	QSqlQuery	query	= _info.runQuery();
-	float		progDiv	= 100.0f / float(query.size());
-	QSqlRecord  record	= query.record();
-	
-	ImportDataSet * data = new ImportDataSet(this);
+	return data;
+}
 
-	for(int i=0; i<record.count(); i++)
-		data->addColumn(new DatabaseImportColumn(data, fq(record.fieldName(i)), record.field(i).metaType()));
-												
-	long lastProgress = Utils::currentMillis();	
-		
-	do
+ImportDataSet * DatabaseImporter::loadAppendedRows(const std::string &locator, std::function<void(int)> progressCallback)
+{
+	JASPTIMER_SCOPE(DatabaseImporter::loadAppendedRows);
+
+	_connect(locator);
+
+	Column * keyColumn = _info._incrementalColumn.isEmpty() ? nullptr : DataSetPackage::pkg()->dataSet()->column(fq(_info._incrementalColumn));
+
+	if(!keyColumn)
 	{
-		if(lastProgress + 1000 < Utils::currentMillis())
+		_info.close();
+		return nullptr;
+	}
+
+	//The key has to be numeric in every row, otherwise we cant tell which rows are new and a normal sync is needed
+	const intvec	&	ints	= keyColumn->ints();
+	const doublevec	&	dbls	= keyColumn->dbls();
+	double				lastKey	= NAN;
+
+	for(size_t r=0; r<dbls.size(); r++)
+		if(!std::isnan(dbls[r]))
+			lastKey = std::isnan(lastKey) ? dbls[r] : std::max(lastKey, dbls[r]);
+		else if(ints[r] != Label::DOUBLE_LABEL_VALUE)
 		{
-			progressCallback(int(progDiv * query.at()));
-			lastProgress = Utils::currentMillis();	
+			_info.close();
+			return nullptr;
 		}
 
-		if(query.isValid())
-			for(int i=0; i<record.count(); i++)
-				static_cast<DatabaseImportColumn*>(data->getColumn(i))->addValue(query.value(i));
+	if(std::isnan(lastKey))
+	{
+		_info.close();
+		return nullptr;
 	}
-	while(query.next());
+
+	QSqlQuery		query	= _info.runQuery(lastKey);
+	ImportDataSet * data	= _readQuery(query, progressCallback);
 
 	_info.close();
-	
+
+	Log::log() << "Database query returned " << data->rowCount() << " rows after " << fq(_info._incrementalColumn) << " = " << lastKey << std::endl;
+
+	return data;
+}
+
+ImportDataSet * DatabaseImporter::_readQuery(QSqlQuery & query, std::function<void(int)> progressCallback)
+{
+	JASPTIMER_SCOPE(DatabaseImporter::_readQuery);
+
+	const int		rowsExpected	= query.size(); //-1 when the driver cannot tell, which is usual for forward only queries
+	QSqlRecord		record			= query.record();
+	ImportDataSet * data			= new ImportDataSet(this);
+
+	std::vector<DatabaseImportColumn*> columns;
+
+	for(int i=0; i<record.count(); i++)
+	{
+		columns.push_back(new DatabaseImportColumn(data, fq(record.fieldName(i))));
+		data->addColumn(columns.back());
+	}
+
+	//The rows come in one by one from the driver's cursor and go straight into the typed columns
+	long	rowsRead		= 0,
+			lastProgress	= Utils::currentMillis();
+
+	while(query.next())
+	{
+		for(size_t i=0; i<columns.size(); i++)
+			columns[i]->addValue(query.value(i));
+
+		rowsRead++;
+
+		if(rowsExpected > 0 && lastProgress + 1000 < Utils::currentMillis())
+		{
+			progressCallback(int(50.0 * rowsRead / rowsExpected));
+			lastProgress = Utils::currentMillis();
+		}
+	}
+
 	data->buildDictionary(); //Not necessary for reading from database but synching will break otherwise...
 	
 	return data;
@@ -59,11 +123,10 @@ ImportDataSet * DatabaseImporter::loadFile(const std::string &locator, std::func
 void DatabaseImporter::initColumn(QVariant colId, ImportColumn *importColumn)
 {
 	JASPTIMER_SCOPE(DatabaseImporter::initColumn);
-	
-	typedef QMetaType::Type MT;
-	
-	DatabaseImportColumn * col = static_cast<DatabaseImportColumn*>(importColumn);
-	
-	initColumnWithStrings(colId, col->name(), col->allValuesAsStrings());
-	
+
+	//Only a fresh load can take the typed values, when synching the values are compared as strings like before
+	if(!_synching && importColumn->hasTypedValues())
+		Importer::initColumn(colId, importColumn);
+	else
+		initColumnWithStrings(colId, importColumn->name(), importColumn->allValuesAsStrings());
 }
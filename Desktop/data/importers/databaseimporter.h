@@ -4,6 +4,8 @@
 #include "importer.h"
 #include "data/databaseconnectioninfo.h"
 
+class QSqlQuery;
+
 class DatabaseImporter : public Importer
 {
 	Q_DECLARE_TR_FUNCTIONS(DatabaseImporter)
@@ -12,11 +14,18 @@ class DatabaseImporter : public Importer
 	
 public:
 	DatabaseImporter() : Importer() {}
+
+	bool importerCanReadAppendedRows()	const override { return true; } ///< Only does something if DatabaseConnectionInfo::_incrementalColumn is set though
 	
-	ImportDataSet* loadFile(const std::string &locator, std::function<void(int)> progressCallback) override;
+	ImportDataSet* loadFile(			const std::string &locator, std::function<void(int)> progressCallback) override;
+	ImportDataSet* loadAppendedRows(	const std::string &locator, std::function<void(int)> progressCallback) override;
 	void initColumn(QVariant colId, ImportColumn * importColumn) override;
 	
 	DatabaseConnectionInfo _info;
+
+private:
+	void			_connect(	const std::string &locator);
+	ImportDataSet *	_readQuery(	QSqlQuery & query, std::function<void(int)> progressCallback);
 };
 
 #endif // DATABASEIMPORTER_H
@@ -0,0 +1,136 @@
+#include "datafilefingerprint.h"
+#include "timers.h"
+#include "log.h"
+#include <json/json.h>
+#include <fstream>
+#include <algorithm>
+#include <zlib.h>
+
+const size_t DataFileFingerprint::_blockSize = 1 << 20;
+
+void DataFileFingerprint::clear()
+{
+	_blocks.clear();
+	_size = 0;
+}
+
+void DataFileFingerprint::add(const char * data, size_t bytes)
+{
+	JASPTIMER_SCOPE(DataFileFingerprint::add);
+
+	while(bytes > 0)
+	{
+		const size_t inLastBlock = _size % _blockSize;
+
+		if(inLastBlock == 0)
+			_blocks.push_back(crc32(0, nullptr, 0));
+
+		//crc32 continues from the crc of what came before, so a block that was only partly there need not be read again
+		const size_t fill = std::min(bytes, _blockSize - inLastBlock);
+		_blocks.back() = crc32(_blocks.back(), reinterpret_cast<const Bytef*>(data), fill);
+
+		_size	+= fill;
+		data	+= fill;
+		bytes	-= fill;
+	}
+}
+
+std::string DataFileFingerprint::toString(size_t rowCount) const
+{
+	Json::Value	fingerprint	= Json::objectValue,
+				blocks		= Json::arrayValue;
+
+	for(uint32_t block : _blocks)
+		blocks.append(Json::UInt64(block));
+
+	fingerprint["blockSize"]	= Json::UInt64(_blockSize);
+	fingerprint["size"]			= Json::UInt64(_size);
+	fingerprint["rows"]			= Json::UInt64(rowCount);
+	fingerprint["blocks"]		= blocks;
+
+	return fingerprint.toStyledString();
+}
+
+std::string DataFileFingerprint::create(const std::string & path, size_t rowCount)
+{
+	JASPTIMER_SCOPE(DataFileFingerprint::create);
+
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+
+	if(!file.is_open())
+		return "";
+
+	DataFileFingerprint	fingerprint;
+	std::vector<char>	block(_blockSize);
+
+	while(file.read(block.data(), _blockSize) || file.gcount() > 0)
+		fingerprint.add(block.data(), file.gcount());
+
+	return fingerprint.toString(rowCount);
+}
+
+DataFileFingerprint::Change DataFileFingerprint::compare(const std::string & fingerprintStr, const std::string & path, size_t rowCount, size_t & unchangedBytes, DataFileFingerprint & unchanged)
+{
+	JASPTIMER_SCOPE(DataFileFingerprint::compare);
+
+	unchangedBytes = 0;
+	unchanged.clear();
+
+	Json::Value fingerprint;
+
+	if(fingerprintStr.empty() || !Json::Reader().parse(fingerprintStr, fingerprint) || !fingerprint.isObject())
+		return Change::Other;
+
+	if(fingerprint["blockSize"].asUInt64() != _blockSize || fingerprint["rows"].asUInt64() != rowCount)
+		return Change::Other;
+
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+	if(!file.is_open())
+		return Change::Other;
+
+	const size_t	oldSize		= fingerprint["size"].asUInt64(),
+					newSize		= file.tellg();
+	const Json::Value & blocks	= fingerprint["blocks"];
+
+	if(oldSize == 0 || newSize < oldSize || blocks.size() != (oldSize + _blockSize - 1) / _blockSize)
+		return Change::Other;
+
+	file.seekg(0);
+
+	std::vector<char>	block(_blockSize);
+	size_t				read = 0;
+
+	for(const Json::Value & blockCrc : blocks)
+	{
+		const size_t blockBytes = std::min(_blockSize, oldSize - read);
+
+		if(!file.read(block.data(), blockBytes) || crc32(0, reinterpret_cast<const Bytef*>(block.data()), blockBytes) != blockCrc.asUInt64())
+		{
+			unchanged.clear();
+			return Change::Other;
+		}
+
+		unchanged._blocks.push_back(blockCrc.asUInt64());
+		read += blockBytes;
+	}
+
+	unchanged._size = oldSize;
+
+	if(newSize == oldSize)
+		return Change::None;
+
+	//The last row of the old file might have been continued, we can only be sure it wasnt if it ended the line
+	const char lastChar = block[(oldSize - 1) % _blockSize];
+
+	if(lastChar != '\n' && lastChar != '\r')
+	{
+		unchanged.clear();
+		return Change::Other;
+	}
+
+	Log::log() << "Datafile '" << path << "' only had " << (newSize - oldSize) << " bytes appended to it." << std::endl;
+
+	unchangedBytes = oldSize;
+	return Change::Appended;
+}
@@ -0,0 +1,40 @@
+#ifndef DATAFILEFINGERPRINT_H
+#define DATAFILEFINGERPRINT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// Describes a datafile as it was when it was last read, so that a synchronisation can see what actually changed
+/// The file is cut into blocks of a fixed size and a crc32 is kept of each of them, together with the size of the file and the number of rows read from it.
+/// The fingerprint is stored as json in DataSet::dataFileFingerprint().
+///
+/// If every block of the old file is still the same and the old file ended on a line ending then rows were only appended to it.
+/// Importers that can read from an offset (see Importer::importerCanReadAppendedRows) then only need to parse the new part.
+/// For anything else we just go through the normal synchronisation.
+///
+/// A fingerprint can be extended with add(), so an importer that has the bytes of the file at hand anyway never needs to read it again just for this.
+/// After compare() found the file unchanged or only appended to it already holds the old part, and only the appended bytes need to be added.
+class DataFileFingerprint
+{
+public:
+	enum class Change { None, Appended, Other };
+
+	void				clear();
+	void				add(const char * data, size_t bytes);	///< The next bytes of the file
+	size_t				size()					const { return _size; }
+	std::string			toString(size_t rowCount)	const;
+
+	static std::string	create(	const std::string & path, size_t rowCount);	///< Reads the whole file, only for importers that never had its bytes at hand
+	static Change		compare(const std::string & fingerprint, const std::string & path, size_t rowCount, size_t & unchangedBytes, DataFileFingerprint & unchanged); ///< rowCount is the current number of rows in the data, unchangedBytes is set to the size of the old file if rows were only appended. Unless the Change is Other unchanged is then the fingerprint of those bytes.
+
+private:
+	static const size_t		_blockSize;
+
+	std::vector<uint32_t>	_blocks;
+	size_t					_size = 0;
+};
+
+#endif // DATAFILEFINGERPRINT_H
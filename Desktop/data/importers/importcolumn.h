@@ -23,6 +23,13 @@ public:
 	virtual const	stringvec		&	allLabelsAsStrings()					const	{ return allValuesAsStrings(); };
 	virtual const	stringset		&	allEmptyValuesAsStrings()				const	{ static stringset a; return a; }
 	virtual			columnType			getColumnType()							const	{ return columnType::unknown; }
+
+	//Importers that already parse their values while reading can offer them typed, Importer::initColumn then skips the strings entirely:
+	virtual			bool				hasTypedValues()						const	{ return false; }							///< If true the typed* functions below can be used instead of allValuesAsStrings()
+	virtual const	doublevec		&	typedDoubles()							const	{ static doublevec	a; return a; }			///< Per row the parsed double, or NaN for empty and non-numeric rows
+	virtual const	intvec			&	typedLabelIndices()						const	{ static intvec		a; return a; }			///< Per row an index into typedLabelDictionary() or negative if the row is a (possibly empty) double
+	virtual const	stringvec		&	typedLabelDictionary()					const	{ static stringvec	a; return a; }			///< The unique non-numeric values in order of appearance
+	virtual			bool				typedOnlyInts()							const	{ return false; }							///< Whether all non-empty rows were written as integers
 			const	std::string		&	title()									const;
 			const	std::string		&	name()									const;
 			void						setName(const std::string & name);
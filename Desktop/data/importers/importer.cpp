@@ -37,19 +37,26 @@ void Importer::loadDataSet(const std::string &locator, std::function<void(int)>
 		DataSetPackage::pkg()->setDataSetSize(columnCount, rowCount);
 
 
+		//The columns are only really filled by endInitColumns, all at once and spread over some threads
+		DataSetPackage::pkg()->beginInitColumns();
+
 		int colNo = 0;
+		for (ImportColumn * importColumn : *importDataSet)
+			initColumn(colNo++, importColumn);
+
+		DataSetPackage::pkg()->endInitColumns([&](float f){ progressCallback(50 + f * 25); });
+
 		for (ImportColumn *& importColumn : *importDataSet)
 		{
-			progressCallback(50 + 25 * colNo / columnCount);
-			initColumn(colNo, importColumn);
 			delete importColumn;
 			importColumn = nullptr;
-			colNo++;
 		}
 
 		DataSetPackage::pkg()->dataSet()->endBatchedToDB([&](float f){ progressCallback(75 + f * 25); });
 	}
 	JASPTIMER_STOP(Importer::loadDataSet createDataSetAndLoad);
+
+	dataSourceWasRead(locator);
 	
 	importDataSet->clearColumns();
 	delete importDataSet;
@@ -67,7 +74,11 @@ void Importer::initColumn(QVariant colId, ImportColumn *importColumn)
 	
 	static stringvec dummyLabels;
 	
-	initColumnWithStrings(colId, importColumn->name(),  importColumn->allValuesAsStrings(), doLabels ? importColumn->allLabelsAsStrings() : dummyLabels, importColumn->title(), importColumn->getColumnType(), importColumn->allEmptyValuesAsStrings());
+	//When not synching there are no user edited labels to take into account, so typed values can go straight into the column
+	if(!_synching && importColumn->hasTypedValues())
+		DataSetPackage::pkg()->initColumnWithTypedValues(colId, importColumn->name(), importColumn->typedDoubles(), importColumn->typedLabelIndices(), importColumn->typedLabelDictionary(), importColumn->typedOnlyInts(), importColumn->title(), importColumn->getColumnType(), importColumn->allEmptyValuesAsStrings());
+	else
+		initColumnWithStrings(colId, importColumn->name(),  importColumn->allValuesAsStrings(), doLabels ? importColumn->allLabelsAsStrings() : dummyLabels, importColumn->title(), importColumn->getColumnType(), importColumn->allEmptyValuesAsStrings());
 }
 
 void Importer::initColumnWithStrings(QVariant colId, const std::string &newName, const std::vector<std::string> &values, const std::vector<std::string> &labels, const std::string & title, columnType desiredType, const stringset & emptyValues) 
@@ -79,6 +90,13 @@ void Importer::syncDataSet(const std::string &locator, std::function<void(int)>
 {
 	_synching = true;
 	long timeBeginS = Utils::currentSeconds();
+
+	if(_syncAppendedRows(locator, progress))
+	{
+		long totalS = (Utils::currentSeconds() - timeBeginS);
+		Log::log() << "Synching appended rows of '" << locator << "' took " << totalS << "s or " << (totalS / 60) << "m" << std::endl;
+		return;
+	}
 	
 	ImportDataSet *	importDataSet	= loadFile(locator, progress);
 	bool			rowCountChanged	= importDataSet->rowCount() != DataSetPackage::pkg()->dataRowCount();
@@ -136,17 +154,86 @@ void Importer::syncDataSet(const std::string &locator, std::function<void(int)>
 	for (auto & changeNameColumnIt : changeNameColumns)
 		missingColumns.erase(changeNameColumnIt.first);
 
+	bool synched = true;
+
 	if (newColumns.size() > 0 || changedColumns.size() > 0 || missingColumns.size() > 0 || changeNameColumns.size() > 0 || orgColumnNames != newOrder || rowCountChanged)
-			_syncPackage(importDataSet, newColumns, changedColumns, missingColumns, changeNameColumns, newOrder, rowCountChanged);
+			synched = _syncPackage(importDataSet, newColumns, changedColumns, missingColumns, changeNameColumns, newOrder, rowCountChanged);
 
 	DataSetPackage::pkg()->setManualEdits(false);
 	delete importDataSet;
+
+	if(synched)
+		dataSourceWasRead(locator);
 	
 	long totalS = (Utils::currentSeconds() - timeBeginS);
 	Log::log() << "Synching '" << locator << "' took " << totalS << "s or " << (totalS / 60) << "m" << std::endl;
 }
 
-void Importer::_syncPackage(
+bool Importer::_syncAppendedRows(const std::string & locator, std::function<void(int)> progressCallback)
+{
+	//Manual edits would be overwritten by a normal sync, so those need to go through that
+	if(!importerCanReadAppendedRows() || DataSetPackage::pkg()->manualEdits())
+		return false;
+
+	DataSetPackage	*	pkg				= DataSetPackage::pkg();
+	DataSet			*	data			= pkg->dataSet();
+	const size_t		oldRowCount		= pkg->dataRowCount();
+	ImportDataSet	*	appended		= loadAppendedRows(locator, progressCallback);
+
+	if(!appended)
+		return false;
+
+	if(appended->rowCount() == 0) //Nothing was added to the source
+	{
+		delete appended;
+		return true;
+	}
+
+	for(ImportColumn * importColumn : *appended)
+		if(!data->column(importColumn->name()))
+		{
+			delete appended;
+			return false;
+		}
+
+	if( ! emit pkg->checkDoSync())
+	{
+		delete appended;
+		return true;
+	}
+
+	stringvec	changedColumns;
+	Columns		columns;
+
+	pkg->beginSynchingData();
+	pkg->setDataSetRowCount(oldRowCount + appended->rowCount()); //Not batched, so every column gets its new (empty) rows here
+
+	data->beginBatchedToDB();
+
+	for(ImportColumn * importColumn : *appended)
+	{
+		Column * column = data->column(importColumn->name());
+
+		column->beginBatchedLabelsDB();
+		column->setValuesFrom(oldRowCount, importColumn->allValuesAsStrings()); //Labels are ignored just like in the normal sync of csv
+		column->endBatchedLabelsDB();
+
+		columns			.push_back(column);
+		changedColumns	.push_back(column->name());
+	}
+
+	data->endBatchedToDB([&](float f){ progressCallback(50 + f * 50); }, columns);
+
+	pkg->endSynchingData(changedColumns, {}, {}, true, false);
+
+	delete appended;
+
+	dataSourceWasRead(locator);
+
+	return true;
+}
+
+bool Importer::_syncPackage(
 		ImportDataSet									*	syncDataSet,
 		const std::vector<std::pair<std::string, int>>	&	newColumns,
 		const std::vector<std::pair<int, std::string>>	&	changedColumns, // import col index and original (old) col name
@@ -157,7 +244,7 @@ void Importer::_syncPackage(
 
 {
 	if( ! emit DataSetPackage::pkg()->checkDoSync())
-		return;
+		return false;
 
 	DataSetPackage::pkg()->beginSynchingData();
 
@@ -211,4 +298,6 @@ void Importer::_syncPackage(
 	
 	if(newColumnOrder.size() > 0)
 		DataSetPackage::pkg()->columnsReorder(newColumnOrder);
+
+	return true;
 }
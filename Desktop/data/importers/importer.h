@@ -21,9 +21,12 @@ public:
     void syncDataSet(const std::string &locator, std::function<void (int)> progressCallback);
 	
 	virtual bool importerDeliversLabels() const { return true; } //They all do except csv, so for synchronization to work we want labels to be ignored for csv when synching, this to allow people to enter better labels and not lose them on every sync
+	virtual bool importerCanReadAppendedRows() const { return false; } ///< If true loadAppendedRows is implemented, so a sync of a source that only grew just reads the new rows
 
 protected:
     virtual ImportDataSet* loadFile(const std::string &locator, std::function<void(int)> progressCallback) = 0;
+	virtual ImportDataSet* loadAppendedRows(const std::string &locator, std::function<void(int)> progressCallback) { return nullptr; } ///< Should read only the rows added since the source was last read, with the columns named as loadFile would. An empty ImportDataSet means nothing was added, nullptr that a normal sync is needed.
+	virtual void dataSourceWasRead(const std::string &locator) {} ///< Called after the source was loaded or synched, so an importer can remember what it looked like
 
 	///colID can be either an integer (the column index in the data) or a string (the (old) name of the column in the data)
 	virtual void initColumn(QVariant colId, ImportColumn *importColumn);
@@ -33,7 +36,9 @@ protected:
 	bool	_synching = false;
 
 private:
-	void _syncPackage(
+	bool _syncAppendedRows(const std::string & locator, std::function<void(int)> progressCallback);
+
+	bool _syncPackage(
 			ImportDataSet									*	syncDataSet,
 			const std::vector<std::pair<std::string, int>>	&	newColumns,
 			const std::vector<std::pair<int, std::string>>	&	changedColumns,
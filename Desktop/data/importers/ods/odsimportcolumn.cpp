@@ -53,24 +53,22 @@ const
 
 const stringvec & ODSImportColumn::allValuesAsStrings() const
 {
-	static stringvec values;
-	values.resize(_rows.size());
+	_valuesCache.resize(_rows.size());
 	
 	for(size_t i=0; i<_rows.size(); i++)
-		values[i] = _rows[i].valueAsString();
+		_valuesCache[i] = _rows[i].valueAsString();
 
-	return values;
+	return _valuesCache;
 }
 
 const stringvec & ODSImportColumn::allLabelsAsStrings() const
 {
-	static stringvec labels;
-	labels.resize(_rows.size());
+	_labelsCache.resize(_rows.size());
 	
 	for(size_t i=0; i<_rows.size(); i++)
-		labels[i] = _rows[i].labelAsString();
+		_labelsCache[i] = _rows[i].labelAsString();
 
-	return labels;
+	return _labelsCache;
 }
 
 void insert(int row, const std::string& data);
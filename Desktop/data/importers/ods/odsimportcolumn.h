@@ -70,6 +70,8 @@ public:
 
 private:
 	Cases				_rows;
+	mutable stringvec	_valuesCache,	///< Owned by the column because DataSetPackage::endInitColumns only reads them after all columns were initialized
+						_labelsCache;
 
 	
 	CellIndex			_index;		///< cell indexes indexed by row.
@@ -55,15 +55,13 @@ std::string ReadStatImportColumn::readstatValueToString(const readstat_value_t &
 
 const stringvec &ReadStatImportColumn::labels() const
 {
-	static stringvec local;
-	
-	local = _values;
+	_labelsCache = _values;
 	
 	for(size_t i=0; i<_values.size(); i++)
 		if(_strLabels.count(_values[i]))
-			local[i] = _strLabels.at(_values[i]);
+			_labelsCache[i] = _strLabels.at(_values[i]);
 	
-	return local;
+	return _labelsCache;
 }
 
 void ReadStatImportColumn::addValue(const readstat_value_t & value)
@@ -52,6 +52,7 @@ private:
 	stringvec					_values;
 	stringset					_missing;
 	strstrmap					_strLabels;
+	mutable stringvec			_labelsCache;		///< Owned by the column because DataSetPackage::endInitColumns only reads it after all columns were initialized
 };
 
 #endif // ReadStatImportColumn_H
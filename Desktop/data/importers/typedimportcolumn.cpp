@@ -0,0 +1,147 @@
+#include "typedimportcolumn.h"
+#include "columnutils.h"
+#include "emptyvalues.h"
+#include "timers.h"
+#include <cmath>
+
+TypedImportColumn::TypedImportColumn(ImportDataSet *importDataSet, const std::string & name, long reserve) : ImportColumn(importDataSet, name)
+{
+	_dbls			.reserve(reserve);
+	_labelIndices	.reserve(reserve);
+}
+
+TypedImportColumn::~TypedImportColumn()
+{
+	JASPTIMER_SCOPE(TypedImportColumn::~TypedImportColumn());
+	_dbls			.clear();
+	_labelIndices	.clear();
+	_stringsCache	.clear();
+}
+
+size_t TypedImportColumn::size() const
+{
+	return _dbls.size();
+}
+
+void TypedImportColumn::addValue(const std::string &value)
+{
+	int		intValue;
+	double	dblValue;
+
+	if(value.empty())
+		addEmpty();
+	else if(ColumnUtils::getIntValue(value, intValue))
+		addNumber(intValue, true);
+	else if(ColumnUtils::getDoubleValue(value, dblValue))
+		addNumber(dblValue, false); //"1.0" is not an int as far as Column::setValues is concerned
+	else
+		addLabel(value);
+}
+
+void TypedImportColumn::addValue(double value)
+{
+	int intValue;
+
+	if(std::isnan(value))	addEmpty();
+	else					addNumber(value, ColumnUtils::getIntValue(value, intValue));
+}
+
+void TypedImportColumn::addNumber(double value, bool isInt)
+{
+	_dbls			.push_back(value);
+	_labelIndices	.push_back(_numericRow);
+	_numericRows++;
+
+	if(!isInt)
+		_onlyInts = false;
+}
+
+void TypedImportColumn::addEmpty()
+{
+	_dbls			.push_back(EmptyValues::missingValueDouble);
+	_labelIndices	.push_back(_emptyRow);
+}
+
+void TypedImportColumn::addLabel(const std::string & value)
+{
+	_dbls			.push_back(EmptyValues::missingValueDouble);
+	_labelIndices	.push_back(dictionaryIndex(value));
+	_onlyInts = false;
+}
+
+void TypedImportColumn::numbersToLabels()
+{
+	JASPTIMER_SCOPE(TypedImportColumn::numbersToLabels);
+
+	for(size_t row=0; row<_dbls.size(); row++)
+		if(_labelIndices[row] == _numericRow)
+		{
+			_labelIndices[row]	= dictionaryIndex(ColumnUtils::doubleToStringMaxPrec(_dbls[row])); //Same text as allValuesAsStrings would have given
+			_dbls[row]			= EmptyValues::missingValueDouble;
+		}
+
+	_numericRows	= 0;
+	_onlyInts		= _dictionary.empty();
+	_stringsCache	.clear();
+}
+
+int TypedImportColumn::dictionaryIndex(const std::string & value)
+{
+	auto found = _dictionaryIndex.find(value);
+
+	if(found == _dictionaryIndex.end())
+	{
+		found = _dictionaryIndex.insert({value, _dictionary.size()}).first;
+		_dictionary.push_back(value);
+	}
+
+	return found->second;
+}
+
+void TypedImportColumn::append(const TypedImportColumn & other)
+{
+	intvec remap(other._dictionary.size());
+
+	for(size_t i=0; i<other._dictionary.size(); i++)
+	{
+		auto found = _dictionaryIndex.find(other._dictionary[i]);
+
+		if(found == _dictionaryIndex.end())
+		{
+			found = _dictionaryIndex.insert({other._dictionary[i], _dictionary.size()}).first;
+			_dictionary.push_back(other._dictionary[i]);
+		}
+
+		remap[i] = found->second;
+	}
+
+	_dbls			.insert(_dbls.end(), other._dbls.begin(), other._dbls.end());
+	_labelIndices	.reserve(_labelIndices.size() + other._labelIndices.size());
+
+	for(int labelIndex : other._labelIndices)
+		_labelIndices.push_back(labelIndex < 0 ? labelIndex : remap[labelIndex]);
+
+	_numericRows	+= other._numericRows;
+	_onlyInts		 = _onlyInts && other._onlyInts;
+	_stringsCache	.clear();
+}
+
+const stringvec & TypedImportColumn::allValuesAsStrings() const
+{
+	JASPTIMER_SCOPE(TypedImportColumn::allValuesAsStrings);
+
+	if(_stringsCache.size() != _dbls.size())
+	{
+		_stringsCache.resize(_dbls.size());
+
+		for(size_t row=0; row<_dbls.size(); row++)
+			switch(_labelIndices[row])
+			{
+			case _emptyRow:		_stringsCache[row] = "";												break;
+			case _numericRow:	_stringsCache[row] = ColumnUtils::doubleToStringMaxPrec(_dbls[row]);	break;
+			default:			_stringsCache[row] = _dictionary[_labelIndices[row]];					break;
+			}
+	}
+
+	return _stringsCache;
+}
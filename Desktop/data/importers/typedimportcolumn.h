@@ -0,0 +1,49 @@
+#ifndef TYPEDIMPORTCOLUMN_H
+#define TYPEDIMPORTCOLUMN_H
+
+#include "importcolumn.h"
+#include <unordered_map>
+
+///
+/// Base for import columns that parse their values as they are added, so only doubles and an index per row are kept. 
+/// Non-numeric values are stored once in a dictionary, which is all that is needed for nominal columns.
+/// allValuesAsStrings() is only built when something asks for it, for instance when synching or when the column turns out to be mixed.
+class TypedImportColumn : public ImportColumn
+{
+public:
+							TypedImportColumn(ImportDataSet* importDataSet, const std::string & name, long reserve = 0);
+							~TypedImportColumn()	override;
+
+			size_t			size()									const	override;
+	const	stringvec	&	allValuesAsStrings()					const	override;
+			void			addValue(const std::string &value);						///< Parses value the same way Column::setValues would
+			void			addValue(double value);									///< NaN is taken as empty
+			void			addLabel(const std::string & value);					///< Stores value as text, even if it looks like a number
+			void			addEmpty();
+			void			numbersToLabels();										///< Turns the numbers added so far into text, for when a column turns out to hold values a double cannot represent exactly
+			void			append(const TypedImportColumn & other);				///< Adds the rows of other after those of this column, remapping its dictionary
+
+			bool			hasTypedValues()						const	override { return !(_numericRows && _dictionary.size()); }	///< Columns that mix numbers and text go through the strings instead
+	const	doublevec	&	typedDoubles()							const	override { return _dbls;			}
+	const	intvec		&	typedLabelIndices()						const	override { return _labelIndices;	}
+	const	stringvec	&	typedLabelDictionary()					const	override { return _dictionary;		}
+			bool			typedOnlyInts()							const	override { return _onlyInts;		}
+
+private:
+			void			addNumber(double value, bool isInt);
+			int				dictionaryIndex(const std::string & value);
+
+private:
+	static const int							_emptyRow	= -2,
+												_numericRow	= -1;
+
+	doublevec									_dbls;
+	intvec										_labelIndices;
+	stringvec									_dictionary;
+	std::unordered_map<std::string, int>		_dictionaryIndex;
+	size_t										_numericRows	= 0;
+	bool										_onlyInts		= true;
+	mutable stringvec							_stringsCache;
+};
+
+#endif // TYPEDIMPORTCOLUMN_H
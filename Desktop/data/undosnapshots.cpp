@@ -0,0 +1,302 @@
+#include "undosnapshots.h"
+#include "tempfiles.h"
+#include "log.h"
+#include "timers.h"
+#include "utilities/qutils.h"
+#include <QFile>
+#include <QDataStream>
+#include <QHash>
+#include <cstring>
+
+std::map<int, std::weak_ptr<const ColumnSnapshot::Values>>	ColumnSnapshot::_bases;
+
+static std::string undoSpillFile()
+{
+	static int nextSpillId = 0;
+
+	return TempFiles::createSpecific("undo", std::to_string(nextSpillId++) + ".bin");
+}
+
+ColumnSnapshot::ColumnSnapshot(const Column * column)
+	: _properties(column->serialize(false)), _columnId(column->id())
+{
+	JASPTIMER_SCOPE(ColumnSnapshot::ColumnSnapshot);
+
+	const doublevec	&	dbls = column->dbls();
+	const intvec	&	ints = column->ints();
+
+	_base = _bases[_columnId].lock();
+
+	if(_base && dbls.size() == ints.size() && _base->dbls.size() == dbls.size() && _base->ints.size() == ints.size())
+	{
+		const size_t maxDelta = dbls.size() / maxDeltaFraction;
+
+		//memcmp instead of == because missing values are NaN and those are never equal to anything
+		for(size_t r=0; r<dbls.size() && _deltaRows.size() <= maxDelta; r++)
+			if(ints[r] != _base->ints[r] || std::memcmp(&dbls[r], &_base->dbls[r], sizeof(double)) != 0)
+			{
+				_deltaRows	.push_back(r);
+				_delta.dbls	.push_back(dbls[r]);
+				_delta.ints	.push_back(ints[r]);
+			}
+
+		if(_deltaRows.size() <= maxDelta)
+			return;
+
+		_deltaRows.clear();
+		_delta = Values();
+	}
+
+	_base				= std::make_shared<const Values>(Values{dbls, ints});
+	_bases[_columnId]	= _base;
+}
+
+ColumnSnapshot::~ColumnSnapshot()
+{
+	if(spilled())
+		QFile::remove(tq(_spillFile));
+
+	_releaseBase();
+}
+
+void ColumnSnapshot::_releaseBase()
+{
+	_base.reset();
+
+	auto base = _bases.find(_columnId);
+
+	if(base != _bases.end() && base->second.expired())
+		_bases.erase(base);
+}
+
+ColumnSnapshot::Values ColumnSnapshot::_values() const
+{
+	Values values = *_base;
+
+	for(size_t i=0; i<_deltaRows.size(); i++)
+	{
+		values.dbls[_deltaRows[i]] = _delta.dbls[i];
+		values.ints[_deltaRows[i]] = _delta.ints[i];
+	}
+
+	return values;
+}
+
+bool ColumnSnapshot::restore(Column * column)
+{
+	JASPTIMER_SCOPE(ColumnSnapshot::restore);
+
+	if(!spilled())
+	{
+		Values values = _values();
+		column->deserialize(_properties, std::move(values.dbls), std::move(values.ints));
+		return true;
+	}
+
+	QFile file(tq(_spillFile));
+
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		Log::log() << "ColumnSnapshot could not read back '" << _spillFile << "', the column is left as it is." << std::endl;
+		return false;
+	}
+
+	const qint64	headerBytes	= sizeof(quint64);
+	quint64			rows		= 0;
+
+	if(		file.read(reinterpret_cast<char*>(&rows), headerBytes) != headerBytes
+		||	rows > quint64(file.size())
+		||	file.size() != headerBytes + qint64(rows * (sizeof(double) + sizeof(int))))
+	{
+		Log::log() << "ColumnSnapshot found '" << _spillFile << "' to be " << file.size() << " bytes, which does not fit the rows it says it has. The column is left as it is." << std::endl;
+		return false;
+	}
+
+	Values values;
+	values.dbls.resize(rows);
+	values.ints.resize(rows);
+
+	const qint64	dblBytes	= rows * sizeof(double),
+					intBytes	= rows * sizeof(int);
+
+	if(		file.read(reinterpret_cast<char*>(values.dbls.data()), dblBytes) != dblBytes
+		||	file.read(reinterpret_cast<char*>(values.ints.data()), intBytes) != intBytes)
+	{
+		Log::log() << "ColumnSnapshot could not read all values back from '" << _spillFile << "', the column is left as it is." << std::endl;
+		return false;
+	}
+
+	column->deserialize(_properties, std::move(values.dbls), std::move(values.ints));
+
+	return true;
+}
+
+size_t ColumnSnapshot::memoryUsed() const
+{
+	size_t labels = _properties["labels"].size() * 128; //Rough, but they are small compared to the values anyway
+
+	if(spilled())
+		return labels;
+
+	const size_t	baseBytes	= _base->dbls.size() * sizeof(double) + _base->ints.size() * sizeof(int),
+					deltaBytes	= _deltaRows.size() * (sizeof(size_t) + sizeof(double) + sizeof(int));
+
+	return labels + baseBytes / _base.use_count() + deltaBytes;
+}
+
+void ColumnSnapshot::spill()
+{
+	if(spilled())
+		return;
+
+	JASPTIMER_SCOPE(ColumnSnapshot::spill);
+
+	std::string	path = undoSpillFile();
+	QFile		file(tq(path));
+
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		Log::log() << "ColumnSnapshot could not spill to '" << path << "', keeping it in memory." << std::endl;
+		return;
+	}
+
+	const Values	values		= _values();
+	const quint64	rows		= values.dbls.size();
+	const qint64	dblBytes	= rows * sizeof(double),
+					intBytes	= rows * sizeof(int);
+
+	if(		file.write(reinterpret_cast<const char*>(&rows),				sizeof(rows))	!= qint64(sizeof(rows))
+		||	file.write(reinterpret_cast<const char*>(values.dbls.data()),	dblBytes)		!= dblBytes
+		||	file.write(reinterpret_cast<const char*>(values.ints.data()),	intBytes)		!= intBytes)
+	{
+		Log::log() << "ColumnSnapshot could not write everything to '" << path << "', keeping it in memory." << std::endl;
+		file.remove();
+		return;
+	}
+
+	_spillFile = path;
+	_releaseBase();
+	_deltaRows.clear();
+	_deltaRows.shrink_to_fit();
+	_delta = Values();
+}
+
+CellsSnapshot::CellsSnapshot(const Cells & cells)
+{
+	QHash<QString, uint32_t> stringIndex;
+
+	_indices.resize(cells.size());
+
+	for(size_t c=0; c<cells.size(); c++)
+	{
+		_indices[c].reserve(cells[c].size());
+
+		for(const QString & cell : cells[c])
+		{
+			auto found = stringIndex.find(cell);
+
+			if(found == stringIndex.end())
+			{
+				found = stringIndex.insert(cell, _strings.size());
+				_strings.append(cell);
+			}
+
+			_indices[c].push_back(found.value());
+		}
+	}
+}
+
+CellsSnapshot::~CellsSnapshot()
+{
+	if(spilled())
+		QFile::remove(tq(_spillFile));
+}
+
+CellsSnapshot::Cells CellsSnapshot::cells()
+{
+	if(spilled())
+	{
+		QFile file(tq(_spillFile));
+
+		if(file.open(QIODevice::ReadOnly))
+		{
+			QDataStream in(&file);
+			quint64		columns;
+
+			in >> _strings >> columns;
+			_indices.resize(columns);
+
+			for(auto & column : _indices)
+			{
+				quint64 rows;
+				in >> rows;
+				column.resize(rows);
+
+				for(uint32_t & index : column)
+					in >> index;
+			}
+		}
+		else
+			Log::log() << "CellsSnapshot could not read back '" << _spillFile << "'." << std::endl;
+
+		QFile::remove(tq(_spillFile));
+		_spillFile.clear();
+	}
+
+	Cells cells(_indices.size());
+
+	for(size_t c=0; c<_indices.size(); c++)
+	{
+		cells[c].reserve(_indices[c].size());
+
+		for(uint32_t index : _indices[c])
+			cells[c].push_back(index < _strings.size() ? _strings[index] : QString());
+	}
+
+	return cells;
+}
+
+size_t CellsSnapshot::memoryUsed() const
+{
+	size_t bytes = 0;
+
+	for(const QString & string : _strings)
+		bytes += sizeof(QString) + string.size() * sizeof(QChar);
+
+	for(const auto & column : _indices)
+		bytes += column.size() * sizeof(uint32_t);
+
+	return bytes;
+}
+
+void CellsSnapshot::spill()
+{
+	if(spilled())
+		return;
+
+	std::string	path = undoSpillFile();
+	QFile		file(tq(path));
+
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		Log::log() << "CellsSnapshot could not spill to '" << path << "', keeping it in memory." << std::endl;
+		return;
+	}
+
+	QDataStream out(&file);
+
+	out << _strings << quint64(_indices.size());
+
+	for(const auto & column : _indices)
+	{
+		out << quint64(column.size());
+
+		for(uint32_t index : column)
+			out << index;
+	}
+
+	_spillFile = path;
+	_strings.clear();
+	_indices.clear();
+	_indices.shrink_to_fit();
+}
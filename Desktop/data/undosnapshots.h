@@ -0,0 +1,75 @@
+#ifndef UNDOSNAPSHOTS_H
+#define UNDOSNAPSHOTS_H
+
+#include <QStringList>
+#include <memory>
+#include <json/json.h>
+#include "column.h"
+
+///
+/// Everything of a column an undo command needs to put it back the way it was.
+/// The values are stored as a delta: the rows that differ from a base that is shared by the snapshots of the same column.
+/// When more than a maxDeltaFraction of the rows differ from the current base the snapshot becomes the new base instead,
+/// so changing the type or sorting of a column with a million rows a couple of times does not keep a copy of all its values per change.
+/// When the undo history gets too big UndoStack asks the oldest ones to spill() their values to a file in the session folder.
+class ColumnSnapshot
+{
+public:
+					ColumnSnapshot(const Column * column);
+					~ColumnSnapshot();
+
+	bool			restore(Column * column);	///< False if the values could not be read back, the column is left alone then
+	size_t			memoryUsed()	const;		///< A base shared with other snapshots is divided evenly between them
+	void			spill();
+	bool			spilled()		const { return !_spillFile.empty(); }
+
+	static constexpr size_t maxDeltaFraction = 8; ///< A delta of more than 1/8th of the rows is bigger than it is worth
+
+private:
+	struct Values
+	{
+		doublevec	dbls;
+		intvec		ints;
+	};
+
+	void							_releaseBase();
+	Values							_values()		const;	///< The base with the delta applied, only when not spilled
+
+	Json::Value						_properties;	///< Column::serialize(false)
+	std::shared_ptr<const Values>	_base;
+	std::vector<size_t>				_deltaRows;		///< The rows where the column differs from _base
+	Values							_delta;			///< And what it holds there
+	std::string						_spillFile;
+	int								_columnId = -1;
+
+	static std::map<int, std::weak_ptr<const Values>>	_bases; ///< Per column id, entries are removed as soon as the last snapshot using them is gone
+};
+
+///
+/// A block of cells as text, for instance what was pasted over and what replaced it.
+/// Each distinct string is stored once and the cells refer to it, which is a lot smaller than a QString per cell when values repeat.
+class CellsSnapshot
+{
+public:
+	typedef std::vector<std::vector<QString>> Cells; ///< Per column, per row
+
+										CellsSnapshot() {}
+										CellsSnapshot(const Cells & cells);
+										CellsSnapshot(CellsSnapshot && other)				= default;
+										CellsSnapshot(const CellsSnapshot &)				= delete; ///< Two of them would remove the same spill file
+										~CellsSnapshot();
+
+	CellsSnapshot					&	operator=(CellsSnapshot && other)					= default;
+
+	Cells								cells();
+	size_t								memoryUsed()	const;
+	void								spill();
+	bool								spilled()		const { return !_spillFile.empty(); }
+
+private:
+	QStringList							_strings;
+	std::vector<std::vector<uint32_t>>	_indices;
+	std::string							_spillFile;
+};
+
+#endif // UNDOSNAPSHOTS_H
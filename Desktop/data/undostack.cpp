@@ -5,6 +5,8 @@
 #include "filtermodel.h"
 #include "computedcolumnmodel.h"
 #include "utilities/qutils.h"
+#include "utilities/settings.h"
+#include <functional>
 
 UndoStack* UndoStack::_undoStack = nullptr;
 
@@ -18,7 +20,10 @@ UndoStack::UndoStack(QObject* parent) : QUndoStack(parent)
 void UndoStack::pushCommand(UndoModelCommand *command)
 {
 	if (!_parentCommand) // Push to the stack only when no macro is started: in this case the command is autmatically added to the _parentCommand
+	{
 		push(command);
+		keepWithinMemoryBudget();
+	}
 }
 
 void UndoStack::startMacro(const QString &text)
@@ -48,6 +53,39 @@ void UndoStack::endMacro(UndoModelCommand *command)
 		push(_parentCommand);
 
 	_parentCommand = nullptr;
+
+	keepWithinMemoryBudget();
+}
+
+void UndoStack::keepWithinMemoryBudget()
+{
+	const size_t	budget	= Settings::value(Settings::UNDO_MEMORY_BUDGET_MB).toULongLong() * 1024 * 1024;
+	size_t			used	= 0;
+
+	std::function<void(const QUndoCommand *)> spillWhenOverBudget = [&](const QUndoCommand * command)
+	{
+		//QUndoStack only hands out const commands, but they are all ours to spill
+		UndoModelCommand * ours = dynamic_cast<UndoModelCommand*>(const_cast<QUndoCommand*>(command));
+
+		if(ours)
+		{
+			used += ours->memoryUsed();
+
+			if(used > budget)
+			{
+				used -= ours->memoryUsed();
+				ours->spill();
+				used += ours->memoryUsed();
+			}
+		}
+
+		for(int i=0; i<command->childCount(); i++)
+			spillWhenOverBudget(command->child(i));
+	};
+
+	//Newest first, so whatever is undone first stays in memory the longest
+	for(int i=count()-1; i>=0; i--)
+		spillWhenOverBudget(command(i));
 }
 
 SetDataCommand::SetDataCommand(QAbstractItemModel *model, int row, int col, const QVariant &value, int role)
@@ -216,30 +254,49 @@ PasteSpreadsheetCommand::PasteSpreadsheetCommand(QAbstractItemModel *model, int
 		return _selected.size() == 0 || _selected[C][R];
 	};
 
-	for (int c = 0; c < _newValues.size(); c++)
+	CellsSnapshot::Cells	oldValues,
+							oldLabels;
+
+	for (int c = 0; c < values.size(); c++)
 	{
-		_oldValues.push_back({});
-		_oldLabels.push_back({});
+		oldValues.push_back({});
+		oldLabels.push_back({});
 		
 		_oldColNames.push_back(_model->headerData(_col + c, Qt::Horizontal).toString());
-		for (int r = 0; r < _newValues[c].size(); r++)
+		for (int r = 0; r < values[c].size(); r++)
 		{
-			_oldValues[c].push_back(!isSelected(r,c) ? "" : _model->data(_model->index(_row + r, _col + c),	int(DataSetPackage::specialRoles::value)).toString());
-			_oldLabels[c].push_back(!isSelected(r,c) ? "" : _model->data(_model->index(_row + r, _col + c),	int(DataSetPackage::specialRoles::label)).toString());
+			oldValues[c].push_back(!isSelected(r,c) ? "" : _model->data(_model->index(_row + r, _col + c),	int(DataSetPackage::specialRoles::value)).toString());
+			oldLabels[c].push_back(!isSelected(r,c) ? "" : _model->data(_model->index(_row + r, _col + c),	int(DataSetPackage::specialRoles::label)).toString());
 		}
 	}
+
+	_oldValues = CellsSnapshot(oldValues);
+	_oldLabels = CellsSnapshot(oldLabels);
 }
 
 void PasteSpreadsheetCommand::undo()
 {
 	if (_dataSetTableModel)
-		_dataSetTableModel->pasteSpreadsheet(_row, _col, _oldValues, _oldLabels, {}, _oldColNames, _selected);
+		_dataSetTableModel->pasteSpreadsheet(_row, _col, _oldValues.cells(), _oldLabels.cells(), {}, _oldColNames, _selected);
 }
 
 void PasteSpreadsheetCommand::redo()
 {
 	if (_dataSetTableModel)
-		_dataSetTableModel->pasteSpreadsheet(_row, _col, _newValues, _newLabels, {}, _newColNames, _selected);
+		_dataSetTableModel->pasteSpreadsheet(_row, _col, _newValues.cells(), _newLabels.cells(), {}, _newColNames, _selected);
+}
+
+size_t PasteSpreadsheetCommand::memoryUsed() const
+{
+	return _newValues.memoryUsed() + _newLabels.memoryUsed() + _oldValues.memoryUsed() + _oldLabels.memoryUsed();
+}
+
+void PasteSpreadsheetCommand::spill()
+{
+	_newValues.spill();
+	_newLabels.spill();
+	_oldValues.spill();
+	_oldLabels.spill();
 }
 
 
@@ -301,21 +358,35 @@ UndoModelCommandMultipleColumns::UndoModelCommandMultipleColumns(QAbstractItemMo
 : UndoModelCommand(model), _cols{cols}
 {
 	for(int col : _cols)
-		_serializedColumns[col] = DataSetPackage::pkg()->dataSet()->column(col) ? DataSetPackage::pkg()->dataSet()->column(col)->serialize() : Json::nullValue;
+		if(DataSetPackage::pkg()->dataSet()->column(col))
+			_snapshots[col] = std::make_unique<ColumnSnapshot>(DataSetPackage::pkg()->dataSet()->column(col));
 }
 
 void UndoModelCommandMultipleColumns::undo()
 {
-	QStringList changed;
-	
-	for(int col : _cols)
-		if(!_serializedColumns[col].isNull())
-			DataSetPackage::pkg()->dataSet()->column(col)->deserialize(_serializedColumns[col]);
-
+	for(auto & colSnapshot : _snapshots)
+		if(!colSnapshot.second->restore(DataSetPackage::pkg()->dataSet()->column(colSnapshot.first)))
+			Log::log() << "Undo could not restore column " << colSnapshot.first << ", its spilled values are damaged." << std::endl;
 	
 	DataSetPackage::pkg()->refresh();
 }
 
+size_t UndoModelCommandMultipleColumns::memoryUsed() const
+{
+	size_t bytes = 0;
+
+	for(const auto & colSnapshot : _snapshots)
+		bytes += colSnapshot.second->memoryUsed();
+
+	return bytes;
+}
+
+void UndoModelCommandMultipleColumns::spill()
+{
+	for(auto & colSnapshot : _snapshots)
+		colSnapshot.second->spill();
+}
+
 SetColumnPropertyCommand::SetColumnPropertyCommand(QAbstractItemModel *model, QVariant newValue, ColumnProperty prop)
 	: UndoModelCommand(model), _prop(prop), _newValue{newValue}
 {
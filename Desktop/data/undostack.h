@@ -5,6 +5,7 @@
 #include <QAbstractItemModel>
 #include <json/json.h>
 #include "stringutils.h"
+#include "undosnapshots.h"
 
 class ColumnModel;
 class FilterModel;
@@ -18,6 +19,9 @@ public:
 	QString		columnName(int colIndex = -1)		const;
 	QString		rowName(int rowIndex)				const;
 
+	virtual size_t	memoryUsed()					const	{ return 0; }	///< Roughly how much memory the command keeps for undo/redo, see UndoStack::keepWithinMemoryBudget
+	virtual void	spill()									{}				///< Move whatever is big to disk, it will be read back when needed
+
 protected:
 	QAbstractItemModel*	_model = nullptr;
 };
@@ -225,13 +229,15 @@ class UndoModelCommandMultipleColumns : public UndoModelCommand
 public:
 	UndoModelCommandMultipleColumns(QAbstractItemModel *model, intset cols);
 
-	void undo()					override;
+	void	undo()					override;
+	size_t	memoryUsed()	const	override;
+	void	spill()					override;
 
 protected:
 	intset						_cols;
 
 private:
-	std::map<int, Json::Value>	_serializedColumns;
+	std::map<int, std::unique_ptr<ColumnSnapshot>>	_snapshots;
 };
 
 class DataSetTableModel;
@@ -240,12 +246,14 @@ class PasteSpreadsheetCommand : public UndoModelCommand
 public:
 	PasteSpreadsheetCommand(QAbstractItemModel *model, int row, int col, const std::vector<std::vector<QString>>& values, const std::vector<std::vector<QString>>& labels, const std::vector<boolvec> & selected, const QStringList & colNames);
 
-	void undo()					override;
-	void redo()					override;
+	void	undo()					override;
+	void	redo()					override;
+	size_t	memoryUsed()	const	override;
+	void	spill()					override;
 
 private:
 	DataSetTableModel					*	_dataSetTableModel;
-	std::vector<std::vector<QString>>		_newValues,
+	CellsSnapshot							_newValues,
 											_newLabels,
 											_oldValues,
 											_oldLabels;
@@ -444,6 +452,8 @@ public:
 	QUndoCommand*		parentCommand()		{ return _parentCommand; }
 	
 private:
+	void				keepWithinMemoryBudget();	///< Spills the oldest commands once everything together uses more than Settings::UNDO_MEMORY_BUDGET_MB
+
 
 	UndoModelCommand*			_parentCommand			= nullptr;
 
@@ -4,6 +4,8 @@
 #include "utilities/qutils.h"
 #include "utils.h"
 #include "log.h"
+#include "timers.h"
+#include "jsonutilities.h"
 
 EngineRepresentation::EngineRepresentation(size_t channelNumber, QProcess * slaveProcess, QObject * parent)
 	: QObject(parent), _channelNumber(channelNumber)
@@ -27,6 +29,7 @@ EngineRepresentation::~EngineRepresentation()
 {
 	Log::log() << "~EngineRepresentation() Engine #" << _channelNumber << std::endl;
 
+	stopReplyReader();
 
 	if(_slaveProcess && _slaveProcess->state() == QProcess::ProcessState::Running)
 	{
@@ -62,6 +65,13 @@ void EngineRepresentation::cleanUpAfterClose(bool forgetAnalyses)
 	_abortAndRestart	= false;
 	_lastCompColName	= "???";
 
+	//Whatever the old process still said doesnt matter anymore, the reader is stopped meanwhile so it cannot push a stale reply after the clear
+	bool readerWasRunning = _replyReader.joinable();
+	stopReplyReader();
+	clearReplies();
+
+	if(readerWasRunning)
+		startReplyReader();
 
 	if(_dynModName != "")
 		emit unregisterForModule(this, _dynModName);
@@ -73,12 +83,23 @@ void EngineRepresentation::cleanUpAfterClose(bool forgetAnalyses)
 		runMeLater->run();
 }
 
-void EngineRepresentation::sendString(std::string str)
+void EngineRepresentation::sendMessage(const Json::Value & message)
 {
 #ifdef PRINT_ENGINE_MESSAGES
-	Log::log() << "sending to jaspEngine: " << str << "\n" << std::endl;
+	if(Log::isActive())
+		Log::log() << "sending to jaspEngine: " << message.toStyledString() << "\n" << std::endl;
 #endif
-	channel()->send(str);
+	if(!channel()->sendMessage(message))
+		engineStoppedReading();
+}
+
+void EngineRepresentation::engineStoppedReading()
+{
+	Log::log() << "Engine #" << channelNumber() << " did not read what was sent to it for too long, so it is killed and whatever it was doing gets an error." << std::endl;
+
+	//processFinished then treats it as a crash, which also restarts it
+	if(_slaveProcess)
+		_slaveProcess->kill();
 }
 
 
@@ -208,6 +229,69 @@ void EngineRepresentation::moduleLoad()
 	runModuleLoadRequestOnProcess(Modules::DynamicModules::dynMods()->dynamicModule(_dynModName)->requestJsonForPackageLoadingRequest());
 }
 
+void EngineRepresentation::startReplyReader()
+{
+	IPCChannel * replyChannel = channel(); //channel() can only be asked from the main thread
+
+	if(!replyChannel || _replyReader.joinable())
+		return;
+
+	_replyReaderStop = false;
+	_replyReader	 = std::thread([this, replyChannel]()
+	{
+		std::string data;
+
+		while(!_replyReaderStop)
+			try
+			{
+				//This waits on the semaphore of the channel, the timeout is only there to notice _replyReaderStop
+				if(replyChannel->receive(data, 100))
+				{
+					{
+						std::lock_guard<std::mutex> lock(_repliesMutex);
+						_replies.push(std::move(data));
+					}
+
+					emit replyReceived();
+				}
+			}
+			catch(std::exception & e)
+			{
+				Log::log() << "Reading a reply from engine #" << _channelNumber << " failed with: " << e.what() << std::endl;
+			}
+	});
+}
+
+void EngineRepresentation::stopReplyReader()
+{
+	_replyReaderStop = true;
+
+	if(_replyReader.joinable())
+		_replyReader.join();
+}
+
+bool EngineRepresentation::nextReply(std::string & data)
+{
+	std::lock_guard<std::mutex> lock(_repliesMutex);
+
+	if(_replies.empty())
+		return false;
+
+	data = std::move(_replies.front());
+	_replies.pop();
+
+	if(!_replies.empty()) //We handle one per processReplies, so make sure the rest gets picked up too
+		emit replyReceived();
+
+	return true;
+}
+
+void EngineRepresentation::clearReplies()
+{
+	std::lock_guard<std::mutex> lock(_repliesMutex);
+	_replies = std::queue<std::string>();
+}
+
 void EngineRepresentation::processReplies()
 {
 	if(!channel())
@@ -235,12 +319,15 @@ void EngineRepresentation::processReplies()
 
 	std::string data;
 
-	if (channel()->receive(data))
+	if (nextReply(data))
 	{
 #ifdef PRINT_ENGINE_MESSAGES
 		{
 			const int _maxDataChars = 300;//I do not want to keep scrolling forever all the time...
-			if(data != "")	Log::log() << "message received from engine #" << channelNumber() << ": " << (data.size() < _maxDataChars ? data : data.substr(0, _maxDataChars)) + "..." << std::endl;
+			if(data != "" && data[0] == MessageCodec::binaryMarker)
+							Log::log() << "binary message of " << data.size() << " bytes received from engine #" << channelNumber() << std::endl;
+			else if(data != "")
+							Log::log() << "message received from engine #" << channelNumber() << ": " << (data.size() < _maxDataChars ? data : data.substr(0, _maxDataChars)) + "..." << std::endl;
 			else			Log::log() << "Engine #" << channelNumber() << " cleared its send-buffer." << std::endl;
 		}
 #endif
@@ -255,10 +342,7 @@ void EngineRepresentation::processReplies()
 
 		try
 		{
-			Json::Reader reader;
-			jsonIsOK = reader.parse(data, json);
-
-			jsonParseError = reader.getFormattedErrorMessages();
+			jsonIsOK = MessageCodec::decode(data, json, &jsonParseError);
 
 			jsonMakesSense = jsonIsOK && (json.get("typeRequest", Json::nullValue).isString() || _engineState == engineState::analysis);
 		}
@@ -336,7 +420,7 @@ void EngineRepresentation::runScriptOnProcess(RFilterStore * filterStore)
 
 	Log::log() << "sending filter with requestID " << filterStore->requestId << " to engine" << std::endl;
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 void EngineRepresentation::runScriptOnProcess(RFilterByNameStore *filterStore)
@@ -348,7 +432,7 @@ void EngineRepresentation::runScriptOnProcess(RFilterByNameStore *filterStore)
 	json["typeRequest"]		= engineStateToString(_engineState);
 	json["name"]			= filterStore->name.toStdString();
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 void EngineRepresentation::processFilterReply(Json::Value & json)
@@ -418,7 +502,7 @@ void EngineRepresentation::runScriptOnProcess(RScriptStore * scriptStore)
 
 		_lastRequestId			= scriptStore->requestId;
 
-		sendString(json.toStyledString());
+		sendMessage(json);
 
 		return;
 	}
@@ -463,7 +547,7 @@ void EngineRepresentation::runScriptOnProcess(RComputeColumnStore * computeColum
 
 	_lastCompColName		= json["columnName"].asString();
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 
@@ -494,10 +578,12 @@ void EngineRepresentation::runAnalysisOnProcess(Analysis *analysis)
 	Json::Value json(analysis->createAnalysisRequestJson());
 
 #ifdef PRINT_ENGINE_MESSAGES
-	Log::log() << "sending: " << json.toStyledString() << std::endl;
+	if(Log::isActive())
+		Log::log() << "sending: " << json.toStyledString() << std::endl;
 #endif
 
-	channel()->send(json.toStyledString());
+	if(!channel()->sendMessage(json))
+		engineStoppedReading();
 
 }
 
@@ -520,9 +606,13 @@ void EngineRepresentation::analysisRemoved(Analysis * analysis)
 void EngineRepresentation::processAnalysisReply(Json::Value & json)
 {
 #ifdef PRINT_ENGINE_MESSAGES
-	Log::log() << "Analysis reply: " << json.toStyledString() << std::endl;
+	if(Log::isActive())
+		Log::log() << "Analysis reply: " << json.toStyledString() << std::endl;
 #endif
 
+	if(!applyResultsPatch(json))
+		return;
+
 	if(_engineState == engineState::paused || _engineState == engineState::resuming || _engineState == engineState::idle)
 	{
 		Log::log() << "Do not process analysis reply because engineState is paused, resuming or idle" << std::endl;
@@ -644,6 +734,44 @@ void EngineRepresentation::processAnalysisReply(Json::Value & json)
 	}
 }
 
+bool EngineRepresentation::applyResultsPatch(Json::Value & json)
+{
+	JASPTIMER_SCOPE(EngineRepresentation::applyResultsPatch);
+
+	if(!json.isMember("resultsSequence"))
+	{
+		if(json.isMember("results"))
+			_engineResultsSeq = -1;
+
+		return true;
+	}
+
+	const int sequence = json["resultsSequence"].asInt();
+
+	if(json.isMember("resultsPatch"))
+	{
+		Json::Value results = std::move(_engineResults);
+
+		if(json["resultsPatchBase"].asInt() != _engineResultsSeq || !JsonUtilities::applyJsonPatch(results, json["resultsPatch"]))
+		{
+			//Only intermediate results are sent as patch, so we just skip these until the engine sends full results again
+			Log::log() << "Results patch #" << sequence << " does not fit the results we have (#" << _engineResultsSeq << "), so it is ignored." << std::endl;
+			_engineResultsSeq = -1;
+			return false;
+		}
+
+		json.removeMember("resultsPatch");
+		json["results"] = results;
+		_engineResults	= std::move(results);
+	}
+	else
+		_engineResults	= json["results"];
+
+	_engineResultsSeq = sequence;
+
+	return true;
+}
+
 void EngineRepresentation::checkForComputedColumns(const Json::Value & results)
 {
 	if(results.isArray())
@@ -763,7 +891,7 @@ void EngineRepresentation::sendStopEngine()
 
 	Log::log() << "informing engine #" << channelNumber() << " that it ought to stop" << std::endl;
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 void EngineRepresentation::restartEngine(QProcess * jaspEngineProcess)
@@ -785,9 +913,14 @@ void EngineRepresentation::restartEngine(QProcess * jaspEngineProcess)
 			Log::log() << "EngineRepresentation::restartEngine says: Engine already had jaspEngine process that is now replaced!" << std::endl;
 	}
 
-	sendString("");
+	//The new engine shouldn't get what was meant for the old one, nor should we take what the old one sent as coming from the new one
+	//_replyReader is the only one allowed to receive on the channel, so it has to be stopped before the incoming side is touched here
+	stopReplyReader();
+	channel()->discardUnreadOut();
+	channel()->discardUnreadIn();
 	cleanUpAfterClose();
 	setSlaveProcess(jaspEngineProcess);
+	startReplyReader();
 
 	setState(engineState::initializing);
 }
@@ -837,7 +970,7 @@ void EngineRepresentation::sendPauseEngine()
 
 	Log::log() << "informing engine #" << channelNumber() << " that it ought to pause for a bit" << std::endl;
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 void EngineRepresentation::resumeEngine(bool setResuming)
@@ -856,7 +989,7 @@ void EngineRepresentation::resumeEngine(bool setResuming)
 
 	Log::log() << "informing engine #" << channelNumber() << " that it may resume." << std::endl;
 
-	sendString(json.toStyledString());
+	sendMessage(json);
 }
 
 void EngineRepresentation::processEnginePausedReply()
@@ -907,7 +1040,7 @@ void EngineRepresentation::runModuleInstallRequestOnProcess(Json::Value request)
 
 	_requestModName	= request["moduleName"].asString();
 
-	sendString(request.toStyledString());
+	sendMessage(request);
 }
 
 void EngineRepresentation::runModuleLoadRequestOnProcess(Json::Value request)
@@ -918,7 +1051,7 @@ void EngineRepresentation::runModuleLoadRequestOnProcess(Json::Value request)
 
 	_requestModName	= request["moduleName"].asString();
 
-	sendString(request.toStyledString());
+	sendMessage(request);
 }
 
 void EngineRepresentation::processModuleRequestReply(Json::Value & json)
@@ -972,7 +1105,7 @@ void EngineRepresentation::sendLogCfg()
 	Json::Value msg		= Log::createLogCfgMsg();
 	msg["typeRequest"]	= engineStateToString(_engineState);
 
-	sendString(msg.toStyledString());
+	sendMessage(msg);
 }
 
 void EngineRepresentation::processLogCfgReply()
@@ -1073,7 +1206,7 @@ void EngineRepresentation::sendSettings()
 	Json::Value msg			= Json::objectValue;
 	msg["typeRequest"]		= engineStateToString(_engineState);
 	addSettingsToJson(msg);
-	sendString(msg.toStyledString());
+	sendMessage(msg);
 
 	_settingsChanged = false;
 }
@@ -1089,7 +1222,7 @@ void EngineRepresentation::sendReloadData()
 	Json::Value msg			= Json::objectValue;
 	msg["typeRequest"]		= engineStateToString(_engineState);
 
-	sendString(msg.toStyledString());
+	sendMessage(msg);
 }
 
 void EngineRepresentation::addSettingsToJson(Json::Value & msg)
@@ -11,6 +11,9 @@
 #include "ipcchannel.h"
 #include "data/datasetpackage.h"
 #include <queue>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include "enginedefinitions.h"
 #include "rscriptstore.h"
 #include "modules/dynamicmodules.h"
@@ -103,6 +106,8 @@ public:
 	bool			jaspEngineStillRunning() { return  _slaveProcess != nullptr && !killed() && !stopped(); }
 
 	void			processReplies();
+	void			startReplyReader();	///< Starts a thread that waits for replies from the engine, so that replyReceived() can be emitted as soon as one arrives
+	void			stopReplyReader();
 	void			restartAbortedAnalysis();
 	void			checkIfExpectedReplyType(engineState expected) { unexpectedEngineReply::checkIfExpected(expected, _engineState, channelNumber()); }
 	bool			willProcessAnalysis(Analysis * analysis);
@@ -134,7 +139,7 @@ protected:
 	void			processLogCfgReply();
 	void			processSettingsReply();
 
-	void			sendString(std::string str);
+	void			sendMessage(const Json::Value & message);
 
 public slots:
 	void			analysisRemoved(Analysis * analysis);
@@ -189,6 +194,7 @@ signals:
 	void			moduleChanged();
 
 	IPCChannel	*	channelSignal(size_t channelNumber);
+	void			replyReceived(); ///< Emitted from the reader thread, so connect it queued
 
 
 
@@ -197,11 +203,15 @@ private:
 	void			sendStopEngine();
 	void			setSlaveProcess(QProcess * slaveProcess);
 	void			checkForComputedColumns(const Json::Value & results);
+	bool			applyResultsPatch(Json::Value & json);	///< Turns the "resultsPatch" the engine may have sent back into "results", returns false if that patch did not fit
 	void			handleEngineCrash();
+	void			engineStoppedReading();	///< When a message could not be sent, the engine is then killed so it goes through handleEngineCrash
 	void			abortAnalysisInProgress(bool restartAfterwards);
 	void			addSettingsToJson(Json::Value & msg);
 
 	IPCChannel	*	channel() { return emit channelSignal(_channelNumber); }
+	bool			nextReply(std::string & data);
+	void			clearReplies();
 
 
 private:
@@ -215,7 +225,8 @@ private:
 	int				_idRemovedAnalysis	= -1,		///<If the analysis was deleted we should ignore its results
 					_lastRequestId		= -1,		///<for R code requests from qml components, so that we can send it back to the right element
 					_abortTime			= -1,		///<When did we tell the analysis to abort? So that we can kill it if it takes too long
-					_idleStartSecs		= -1;
+					_idleStartSecs		= -1,
+					_engineResultsSeq	= -1;		///<The "resultsSequence" of _engineResults, -1 if we do not know what the engine has
 	bool			_pauseRequested		= false,	///<should tell the engine to pause as soon as possible
 					_stopRequested		= false,	///<should tell the engine to stop as soon as possible
 					_slaveCrashed		= false,	///<My slave crashed
@@ -228,6 +239,7 @@ private:
 					_pauseUnloadData	= false,
 					_reloadData			= false,	///<when the idle is engine and this true, it should reload the data
 					_moduleLoaded		= false;	///<If _dynModName is set but this is false the engine should still load the module.
+	Json::Value		_engineResults;					///<The last results the engine sent, it sends intermediate results as a patch on these
 	std::string		_lastCompColName	= "???",
 					_dynModName			= "",		///<If filled: refers to the particular dynamic module this engine was meant for.
 					_requestModName		= "";		///<To keep track of which engine is handling a request for a module
@@ -235,6 +247,11 @@ private:
 	QMetaObject::Connection	_slaveFinishedConnection,
 							_analysisInProgressStatusConnection;
 
+	std::thread				_replyReader;
+	std::atomic<bool>		_replyReaderStop	= false;
+	std::mutex				_repliesMutex;
+	std::queue<std::string>	_replies;			///< Filled by _replyReader, emptied by processReplies() on the main thread
+
 };
 
 #endif // ENGINEREPRESENTATION_H
@@ -40,6 +40,8 @@
 #include "log.h"
 #include "utilities/processhelper.h"
 #include "dirs.h"
+#include "filterevaluator.h"
+#include "databaseinterface.h"
 
 using namespace boost::interprocess;
 
@@ -91,6 +93,13 @@ EngineSync::EngineSync(QObject *parent)
 
 EngineSync::~EngineSync()
 {
+	//The channels are deleted below, so nobody should be waiting on them anymore
+	for(EngineRepresentation * engine : _engines)
+		engine->stopReplyReader();
+
+	if(_rCmder)
+		_rCmder->stopReplyReader();
+
 	if(!_stopProcessing)
 	{
 		for(EngineRepresentation * engine : _engines)
@@ -281,6 +290,9 @@ EngineRepresentation * EngineSync::createNewEngine(bool addToEngines, int overri
 
 		connect(engine,						&EngineRepresentation::stateChanged,					this,					&EngineSync::resetListModel,					Qt::QueuedConnection	);
 		connect(engine,						&EngineRepresentation::analysisStatusChanged,			this,					&EngineSync::resetListModel,					Qt::QueuedConnection	);
+		connect(engine,						&EngineRepresentation::replyReceived,					this,					&EngineSync::wakeUp,							Qt::QueuedConnection	);
+
+		engine->startReplyReader();
 
 		resetListModel();
 
@@ -318,10 +330,12 @@ void EngineSync::start(int )
 	QTimer	*timerProcess	= new QTimer(this),
 			*timerBeat		= new QTimer(this);
 
-	connect(timerProcess,	&QTimer::timeout, this, &EngineSync::process,				Qt::QueuedConnection);
-	connect(timerBeat,		&QTimer::timeout, this, &EngineSync::heartbeatTempFiles,	Qt::QueuedConnection);
+	connect(timerProcess,			&QTimer::timeout,					this, &EngineSync::process,				Qt::QueuedConnection);
+	connect(timerBeat,				&QTimer::timeout,					this, &EngineSync::heartbeatTempFiles,	Qt::QueuedConnection);
+	connect(Analyses::analyses(),	&Analyses::analysisStatusChanged,	this, &EngineSync::wakeUp,				Qt::QueuedConnection);
 
-	timerProcess->start(50);
+	//Replies from engines and new work call wakeUp(), the timer is just a watchdog for timeouts, cooldowns and bored engines
+	timerProcess->start(ENGINE_WATCHDOG_INTERVAL);
 	timerBeat->start(50);
 }
 
@@ -394,11 +408,15 @@ void EngineSync::shutdownBoredEngines()
  * 
  * Each engine can be registered for a module, which should b e combined with a module load if rscripts or analyses need to be ran on it.
  * This allows for clean separation of R-libraries per module (as they each get their own engine and thus R)
+ * When all engines of a module are busy with analyses and there is still one waiting another engine is added to its pool (if allowed by maxEngineCount())
+ * Those extra engines shut down again once they are bored.
  * 
- * It gets runs every 50ms, if it can anyway.
+ * It runs whenever wakeUp() is called, because an engine replied or new work came in, and otherwise every ENGINE_WATCHDOG_INTERVAL ms.
  */
 void EngineSync::process()
 {
+	_processScheduled = false;
+
 	if(_stopProcessing && !_dataMode)
 		return;
 		
@@ -446,7 +464,7 @@ void EngineSync::process()
 	
 	//So we try to distribute some work to each engine as below:
 	stringset	notEnoughIdlesForScript		=	processRCodeQueue();
-	bool		notEnoughIdlesForCompCol	=	processComputedColumnQueue();
+	size_t		notEnoughIdlesForCompCol	=	processComputedColumnQueue();
 	stringset	notEnoughIdlesForModule		=	processDynamicModules();
 	auto		notEnoughIdlesForAnalysis	=	processAnalysisRequests();
 	bool		notEnoughIdles				=	notEnoughIdlesForCompCol || notEnoughIdlesForScript.size() || notEnoughIdlesForModule.size() || notEnoughIdlesForAnalysis.size();
@@ -456,10 +474,10 @@ void EngineSync::process()
 	stringset notEnoughIdlesSet(notEnoughIdlesForModule);
 	notEnoughIdlesSet.merge(notEnoughIdlesForScript);
 	
-	int			wantThisManyEngines			=	notEnoughIdlesSet.size();
+	int			wantThisManyEngines			=	notEnoughIdlesSet.size() + std::min(notEnoughIdlesForCompCol, enginesStartableCount()); //Computed columns only get engines that can be started without killing anything
 
 	if(notEnoughIdles)
-		Log::log() << "Not enough idle engines! Need " << (notEnoughIdlesForScript.size() ? " one for script" : "") << (notEnoughIdlesForCompCol ? " one for compcol" : "") << (notEnoughIdlesForModule.size() ? std::to_string(notEnoughIdlesForModule.size()) + " for installing modules" : "") <<  (notEnoughIdlesForAnalysis.size() ? std::to_string(notEnoughIdlesForAnalysis.size()) + " for analysis" : "") << ", one will " << ( !anEngineIdleSoon() ? "NOT " : "")  << "be idle soon..." << std::endl;
+		Log::log() << "Not enough idle engines! Need " << (notEnoughIdlesForScript.size() ? " one for script" : "") << (notEnoughIdlesForCompCol ? " " + std::to_string(notEnoughIdlesForCompCol) + " for compcols" : "") << (notEnoughIdlesForModule.size() ? std::to_string(notEnoughIdlesForModule.size()) + " for installing modules" : "") <<  (notEnoughIdlesForAnalysis.size() ? std::to_string(notEnoughIdlesForAnalysis.size()) + " for analysis" : "") << ", one will " << ( !anEngineIdleSoon() ? "NOT " : "")  << "be idle soon..." << std::endl;
 	
 	//First try to find or start some engines specifically for waiting analyses, and we assign them to the module immediately
 	if(notEnoughIdlesForAnalysis.size())
@@ -470,7 +488,8 @@ void EngineSync::process()
 		for(const std::string & modName : notEnoughIdlesForAnalysis)
 			if(!notEnoughIdlesSet.count(modName))
 			{
-				bool foundAnEngineAnyway = false;
+				bool	foundAnEngineAnyway = false,
+						growingPool			= moduleHasEngine(modName);
 				//Can we use an existing engine?
 				for(auto * engine : _engines)
 					if(engine->module() == "" && engine->idleSoon())
@@ -486,8 +505,8 @@ void EngineSync::process()
 					auto * engine = createNewEngine();
 					registerEngineForModule(engine, modName);
 				}
-				else
-					wantThisManyEngines++; //Otherwise just try later with idle killings
+				else if(!growingPool)
+					wantThisManyEngines++; //Otherwise just try later with idle killings, but not just to make a pool bigger as that would cost some other module its engine
 			}
 	}
 
@@ -508,17 +527,26 @@ void EngineSync::process()
 		startExtraEngines();*/
 }
 
-int EngineSync::sendFilter(const QString & generatedFilter, const QString & filter)
+void EngineSync::wakeUp()
+{
+	if(_processScheduled)
+		return;
+
+	_processScheduled = true;
+	QMetaObject::invokeMethod(this, &EngineSync::process, Qt::QueuedConnection);
+}
+
+int EngineSync::sendFilter(const QString & generatedFilter, const QString & filter, const QString & nativeConstructorJson)
 {
 	JASPTIMER_SCOPE(EngineSync::sendFilter);
 	
-	bool filterTheSame = _waitingFilter && (_waitingFilter->generatedfilter == generatedFilter && _waitingFilter->script == filter);
+	bool filterTheSame = _waitingFilter && (_waitingFilter->generatedfilter == generatedFilter && _waitingFilter->script == filter && _waitingFilter->constructorJson == nativeConstructorJson);
 
 	if(!filterTheSame)
 	{
 		delete _waitingFilter;
 	
-		_waitingFilter = new RFilterStore(generatedFilter, filter, ++_filterCurrentRequestID);
+		_waitingFilter = new RFilterStore(generatedFilter, filter, ++_filterCurrentRequestID, nativeConstructorJson);
 		Log::log() << "waiting filter with requestid: " << _filterCurrentRequestID << " is now:\n" << generatedFilter.toStdString() << "\n" << filter.toStdString() << std::endl;
 	}
 	else
@@ -527,6 +555,8 @@ int EngineSync::sendFilter(const QString & generatedFilter, const QString & filt
 		Log::log() << "waiting filter requestid increased to " << _filterCurrentRequestID << std::endl;
 	}
 
+	wakeUp();
+
 	return _filterCurrentRequestID;
 }
 
@@ -544,11 +574,13 @@ void EngineSync::sendFilterByName(const QString & name, const QString & module)
 		}
 					
 	_waitingScripts.push(new RFilterByNameStore(name, module));
+	wakeUp();
 }
 
 void EngineSync::sendRCode(const QString & rCode, int requestId, bool whiteListedVersion, QString module)
 {
 	_waitingScripts.push(new RScriptStore(requestId, rCode, module, engineState::rCode, whiteListedVersion));
+	wakeUp();
 }
 
 void EngineSync::computeColumn(const QString & columnName, const QString & computeCode, columnType colType)
@@ -566,6 +598,7 @@ void EngineSync::computeColumn(const QString & columnName, const QString & compu
 	}
 
 	_waitingCompCols.push(new RComputeColumnStore(columnName, computeCode, colType));
+	wakeUp();
 }
 
 void EngineSync::processFilterScript()
@@ -575,6 +608,18 @@ void EngineSync::processFilterScript()
 
 	JASPTIMER_SCOPE(EngineSync::processFilterScript);
 
+	//A filter that doesn't need R is run right here, unless an engine is still busy with an earlier filter because that would overwrite our result when done
+	bool engineRunsFilter = false;
+	for (auto *engine : _engines)
+		if(engine->state() == engineState::filter)
+			engineRunsFilter = true;
+
+	if(!_waitingFilter->constructorJson.isEmpty() && !engineRunsFilter)
+	{
+		processFilterNatively();
+		return;
+	}
+
 	//First we make sure nothing else is running before we ask the engine to run the filter
 	if(!_dataMode && !_filterRunning)
 	{
@@ -598,6 +643,49 @@ void EngineSync::processFilterScript()
 	}
 }
 
+void EngineSync::processFilterNatively()
+{
+	JASPTIMER_SCOPE(EngineSync::processFilterNatively);
+
+	RFilterStore	*	filterStore	= _waitingFilter;
+	DataSet			*	data		= DataSetPackage::pkg()->dataSet();
+	DatabaseInterface	&	db		= *DatabaseInterface::singleton();
+
+	_waitingFilter = nullptr;
+
+	if(data && data->filter())
+	{
+		int filterId = data->filter()->id();
+
+		//The results go into the database just like Engine::runFilter does it, so FilterModel loads them as if an engine had run the filter
+		try
+		{
+			boolvec filterResult = FilterEvaluator(data).evaluate(fq(filterStore->constructorJson));
+
+			db.transactionWriteBegin();
+			db.filterWrite(filterId, filterResult);
+			db.filterUpdateErrorMsg(filterId, "");
+			db.filterIncRevision(filterId);
+			db.transactionWriteEnd();
+
+			Log::log() << "Filter with request " << filterStore->requestId << " was run without R" << std::endl;
+
+			emit processNewFilterResult(filterStore->requestId);
+		}
+		catch(std::runtime_error & e)
+		{
+			db.transactionWriteBegin();
+			db.filterUpdateErrorMsg(filterId, e.what());
+			db.filterIncRevision(filterId);
+			db.transactionWriteEnd();
+
+			emit processFilterErrorMsg(tq(e.what()), filterStore->requestId);
+		}
+	}
+
+	delete filterStore;
+}
+
 void EngineSync::filterDone(int requestID)
 {
 	if(requestID != _filterCurrentRequestID)
@@ -664,13 +752,16 @@ stringset EngineSync::processRCodeQueue()
 							
 							if(!engine->moduleLoaded() && !engine->moduleLoading())
 								engine->moduleLoad();
+
+							break; //One is enough, registering more would make it a pool
 						}
 				}
 				else 
 				{
 					foundEngine = true;
-					if(!_moduleEngines[mod]->idle())	engineNotIdle = true;
-					else								_moduleEngines[mod]->runScriptOnProcess(waiting);
+					auto * engine = idleModuleEngine(mod);
+					if(!engine)		engineNotIdle = true;
+					else			engine->runScriptOnProcess(waiting);
 				}
 			
 				
@@ -698,9 +789,9 @@ stringset EngineSync::processRCodeQueue()
 	return {};
 }
 
-bool EngineSync::processComputedColumnQueue()
+size_t EngineSync::processComputedColumnQueue()
 {
-	bool needEngine = false;
+	//ComputedColumnModel only sends columns whose inputs are up to date, so whatever is waiting here can run side by side on as many engines as are idle
 	try
 	{
 		std::queue<RComputeColumnStore*>	newWaiting;
@@ -708,8 +799,6 @@ bool EngineSync::processComputedColumnQueue()
 		while(_waitingCompCols.size() > 0)
 		{
 			RComputeColumnStore * waiting = _waitingCompCols.front();
-								
-			needEngine = true;
 			bool foundOne = false;
 			
 			for(auto * engine : _engines)
@@ -720,7 +809,6 @@ bool EngineSync::processComputedColumnQueue()
 					delete waiting;
 					_waitingCompCols.pop();
 					foundOne = true;
-					needEngine = false;
 					break;
 				}
 		
@@ -738,7 +826,7 @@ bool EngineSync::processComputedColumnQueue()
 		Log::log() << "Exception thrown in processComputedColumnQueue" << std::endl;
 	}
 	
-	return needEngine;
+	return _waitingCompCols.size();
 }
 
 
@@ -755,7 +843,13 @@ stringset EngineSync::processDynamicModules()
 		{
 			if(moduleHasEngine(mod))
 			{
-				auto * engine = _moduleEngines[mod];
+				//Only one engine can install the module, the rest of the pool shouldnt have it loaded meanwhile
+				const std::vector<EngineRepresentation *> pool = _moduleEngines[mod];
+
+				for(size_t i=1; i<pool.size(); i++)
+					stopAndDestroyEngine(pool[i]);
+
+				auto * engine = pool[0];
 
 				if(engine->analysisInProgress())
 					engine->killEngine();
@@ -764,14 +858,21 @@ stringset EngineSync::processDynamicModules()
 					engine->runModuleInstallRequestOnProcess(DynMods::dynMods()->getJsonForPackageInstallationRequest(mod));
 			}
 			else
+			{
+				bool installing = false;
+
 				for(auto & engine : _engines)
 					if(engine->idle() && engine->runsUtility()) //We don't care if the engine is meant for some module or other. We restart afterwards anyway
 					{
 						registerEngineForModule(engine, mod);
 						engine->runModuleInstallRequestOnProcess(DynMods::dynMods()->getJsonForPackageInstallationRequest(mod));
+						installing = true;
+						break; //Only one engine should install it
 					}
-					else
-						stillWantTo.insert(mod);
+
+				if(!installing)
+					stillWantTo.insert(mod);
+			}
 		}
 		
 		return stillWantTo;
@@ -799,27 +900,44 @@ std::set<std::string> EngineSync::processAnalysisRequests()
 			{
 				const std::string modName = analysis->dynamicModule()->name();
 
-				//First check if we already have an engine for this module
+				//First check if we already have engines for this module, the analysis goes to whichever of them is free
 				if(moduleHasEngine(modName))
 				{
-					auto * engine = _moduleEngines[modName];
+					bool	running		= false,
+							aFreeSoon	= false;
 
-					if(engine->willProcessAnalysis(analysis))
-						engine->runAnalysisOnProcess(analysis);
-
-					else if(engine->stopped())
-						startStoppedEngine(engine);
+					for(auto * engine : _moduleEngines[modName])
+						if(engine->willProcessAnalysis(analysis))
+						{
+							engine->runAnalysisOnProcess(analysis);
+							running = true;
+							break;
+						}
 
-					else if(engine->idle())
-					{
-						if(!engine->moduleLoaded())
+					if(!running)
+						for(auto * engine : _moduleEngines[modName])
 						{
-							if(!engine->moduleLoading())
-								engine->moduleLoad();
+							if(engine->stopped())
+								startStoppedEngine(engine);
+
+							else if(engine->idle())
+							{
+								if(!engine->moduleLoaded())
+								{
+									if(!engine->moduleLoading())
+										engine->moduleLoad();
+								}
+								//else
+								// If the engine is being stopped it might be here	throw std::runtime_error("An engine is meant for module " + modName + " but won't process analysis " + analysis->name() + " and is also loaded, which does not make any sense.");
+							}
+
+							if(!engine->analysisInProgress())
+								aFreeSoon = true;
 						}
-						//else
-						// If the engine is being stopped it might be here	throw std::runtime_error("An engine is meant for module " + modName + " but won't process analysis " + analysis->name() + " and is also loaded, which does not make any sense.");
-					}
+
+					//All engines of the pool are busy running analyses, so another one would help
+					if(!running && !aFreeSoon)
+						modulesNeedingEngines.insert(modName);
 				}
 				else
 				{
@@ -1234,6 +1352,8 @@ void EngineSync::logCfgRequest()
 {
 	for(EngineRepresentation * e : _engines)
 		_logCfgRequested.insert(e);
+
+	wakeUp();
 }
 
 void EngineSync::logCfgReplyReceived(EngineRepresentation * engine)
@@ -1243,41 +1363,65 @@ void EngineSync::logCfgReplyReceived(EngineRepresentation * engine)
 
 void EngineSync::registerEngineForModule(EngineRepresentation * engine, std::string modName)
 {
-	if(_moduleEngines.count(modName) > 0 && _moduleEngines[modName] != engine)
-		throw std::runtime_error("Trying to register module '" + modName + "' to engine #" +
-								 std::to_string(engine->channelNumber()) + " but it is already registered to " +
-								 std::to_string(_moduleEngines[modName]->channelNumber()));
+	if(engine->module() != "" && engine->module() != modName)
+		unregisterEngineForModule(engine, engine->module());
 
-	Log::log() << "Registering engine #" << engine->channelNumber() << " for module '" << modName << "'" << std::endl;
+	std::vector<EngineRepresentation *> & pool = _moduleEngines[modName];
 
-	_moduleEngines[modName] = engine;
+	if(std::find(pool.begin(), pool.end(), engine) == pool.end())
+	{
+		Log::log() << "Registering engine #" << engine->channelNumber() << " for module '" << modName << "', it now has " << pool.size() + 1 << " engine(s)" << std::endl;
+		pool.push_back(engine);
+	}
 
 	engine->setDynamicModule(modName);
 }
 
 void EngineSync::unregisterEngineForModule(EngineRepresentation * engine, std::string modName)
 {
-	if(_moduleEngines.count(modName) > 0 && _moduleEngines[modName] != engine)
+	if(!_moduleEngines.count(modName))
+		return;
+
+	std::vector<EngineRepresentation *> & pool		= _moduleEngines[modName];
+	auto								  engineIt	= std::find(pool.begin(), pool.end(), engine);
+
+	if(engineIt == pool.end())
 		return;
 
 	Log::log() << "Unregistering engine #" << engine->channelNumber() << " for module '" << modName << "'" << std::endl;
-	_moduleEngines.erase(modName); //We only erase it when it is the exact same engine + modName combo
+	pool.erase(engineIt); //We only erase it when it is the exact same engine + modName combo
+
+	if(pool.empty())
+		_moduleEngines.erase(modName);
+
 	engine->setDynamicModule("");
 	//engine->shutEngineDown(); this function is triggered by closing the engine anyway
 }
 
+EngineRepresentation * EngineSync::idleModuleEngine(const std::string & modName)
+{
+	if(_moduleEngines.count(modName))
+		for(auto * engine : _moduleEngines[modName])
+			if(engine->idle())
+				return engine;
+
+	return nullptr;
+}
+
 void EngineSync::stopModuleEngine(QString moduleName)
 {
 	const std::string modName = fq(moduleName);
 	if(_moduleEngines.count(modName))
-		_moduleEngines[modName]->shutEngineDown();
+		for(auto * engine : std::vector<EngineRepresentation *>(_moduleEngines[modName])) //copy because shutting down might unregister it
+			engine->shutEngineDown();
 }
 
 void EngineSync::moduleInstallationFailedHandler(const QString &moduleName, const QString &)
 {
 	const std::string modName = fq(moduleName);
 	if(_moduleEngines.count(modName))
-		unregisterEngineForModule(_moduleEngines[modName], modName);
+		for(auto * engine : std::vector<EngineRepresentation *>(_moduleEngines[modName]))
+			unregisterEngineForModule(engine, modName);
 }
 
 void EngineSync::killModuleEngine(Modules::DynamicModule * mod)
@@ -1285,7 +1429,8 @@ void EngineSync::killModuleEngine(Modules::DynamicModule * mod)
 	if(!_moduleEngines.count(mod->name()))
 		return;
 
-	_moduleEngines[mod->name()]->shutEngineDown();
+	for(auto * engine : std::vector<EngineRepresentation *>(_moduleEngines[mod->name()]))
+		engine->shutEngineDown();
 }
 
 void EngineSync::killEngine(int channelNumber)
@@ -1405,16 +1550,15 @@ void EngineSync::destroyEngine(EngineRepresentation * engine)
 		});
 	}
 
-	if(engine->module() != "")	_moduleEngines.erase(engine->module());
-	else
+	//The engine might have been unregistered from its module before, so check every pool
+	for(auto nameEngines = _moduleEngines.begin(); nameEngines != _moduleEngines.end(); )
 	{
-		std::string modName = "";
+		std::vector<EngineRepresentation *> & pool = nameEngines->second;
 
-		for(const auto & nameEngine : _moduleEngines)
-			if(nameEngine.second == engine)
-				modName = nameEngine.first;
+		pool.erase(std::remove(pool.begin(), pool.end(), engine), pool.end());
 
-		_moduleEngines.erase(modName);
+		if(pool.empty())	nameEngines = _moduleEngines.erase(nameEngines);
+		else				nameEngines++;
 	}
 
 	_engines.erase(engine);
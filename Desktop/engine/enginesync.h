@@ -65,7 +65,7 @@ public:
 public slots:
 	void		destroyEngine(EngineRepresentation * engine);
 	void		stopAndDestroyEngine(EngineRepresentation * engine);
-	int			sendFilter(			const QString & generatedFilter,	const QString & filter);
+	int			sendFilter(			const QString & generatedFilter,	const QString & filter,			const QString & nativeConstructorJson = "");
 	void		sendFilterByName(	const QString & name,				const QString & module);
 	void		sendRCode(			const QString & rCode,				int requestId,					bool whiteListedVersion, QString module);
 	void		computeColumn(		const QString & columnName,			const QString & computeCode,	columnType columnType);
@@ -117,12 +117,13 @@ signals:
 private:
 	//These process functions can request a new engine to be started:
 	stringset	processRCodeQueue();
-	bool		processComputedColumnQueue();
+	size_t		processComputedColumnQueue();	///< Returns how many computed columns are still waiting for an engine
 	stringset	processDynamicModules();
 	stringset	processAnalysisRequests();	///< Returns modules that still need an engine
 	
 	void		processLogCfgRequests();
 	void		processFilterScript();
+	void		processFilterNatively();
 	void		processSettingsChanged();
 	void		processReloadData();
 	
@@ -132,6 +133,8 @@ private:
 	bool		allEnginesResumed(	std::set<EngineRepresentation *> these = {}); ///< If `these` isn't filled all engines are checked
 	QProcess*	startSlaveProcess(int channelNumber);
 
+	EngineRepresentation * idleModuleEngine(const std::string & modName); ///< Returns nullptr if all engines for the module are busy
+
 	bool		moduleInstallRunning()				const;
 	size_t		enginesStartableCount()				const;
 	bool		channelFree(size_t channel)			const;
@@ -150,6 +153,7 @@ private slots:
 	void	heartbeatTempFiles();
 
 	void	process();
+	void	wakeUp(); ///< Runs process() as soon as the eventloop gets to it, instead of waiting for the watchdog
 
 	void	restartEngineAfterCrash(EngineRepresentation * engine);
 
@@ -163,7 +167,7 @@ private slots:
 	void	maxEngineCountChanged();
 	void	startExtraEngines(size_t num=1);
 	bool	anEngineIdleSoon() const;
-	bool	moduleHasEngine(const std::string & name) { return _moduleEngines.count(name); }
+	bool	moduleHasEngine(const std::string & name) { return _moduleEngines.count(name) && _moduleEngines[name].size(); }
 	void	resetListModel()	{ beginResetModel(); endResetModel(); } // lets keep things easy here, it doesnt have to be highperf
 
 	IPCChannel * channel(size_t channelNumber);
@@ -177,7 +181,8 @@ private:
 	RFilterStore					*	_waitingFilter					= nullptr;
 	bool								_stopProcessing					= false,
 										_dataMode						= false,
-										_filterRunning					= false;
+										_filterRunning					= false,
+										_processScheduled				= false;
 	int									_filterCurrentRequestID			= 0;
 	std::string							_memoryName,
 										_engineInfo;
@@ -185,7 +190,7 @@ private:
 	std::queue<RScriptStore*>			_waitingScripts;
 	std::queue<RComputeColumnStore*>	_waitingCompCols;
 	std::map<std::string,
-		EngineRepresentation * >		_moduleEngines;					///< An engine per module active. Engines will be started and closed as needed.
+		std::vector<EngineRepresentation *>>	_moduleEngines;			///< A pool of engines per module active, they share the waiting analyses of that module. Engines will be started and closed as needed.
 	std::set<EngineRepresentation*>		_engines,						///< All analysis/utility/module engines, excepting _rCmder
 										_logCfgRequested;
 	std::vector<IPCChannel*>			_channels;						///< Channels are instantiated separately from the engines to avoid boost messing up
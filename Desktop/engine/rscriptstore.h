@@ -24,9 +24,10 @@ struct RScriptStore
 /// For when you want to run a filter use this override
 struct RFilterStore : public RScriptStore
 {
-	RFilterStore(QString generatedfilter, QString filter, int requestID) : RScriptStore(requestID, filter, "", engineState::filter), generatedfilter(generatedfilter) { }
+	RFilterStore(QString generatedfilter, QString filter, int requestID, QString constructorJson = "") : RScriptStore(requestID, filter, "", engineState::filter), generatedfilter(generatedfilter), constructorJson(constructorJson) { }
 
-	QString generatedfilter;
+	QString generatedfilter,
+			constructorJson; ///< Only set if the filter can be run by FilterEvaluator instead of R
 };
 
 ///
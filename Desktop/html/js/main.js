@@ -34,6 +34,7 @@ $(document).ready(function () {
 	var showInstructions	= false;
 	var wasLastClickNote	= false;
 	var analyses			= new JASPWidgets.Analyses({ className: "jasp-report" });
+	var analysisSnapshots	= {}; // What was last given to window.analysisChanged per id, window.analysisPatched applies the patches from ResultsJsInterface to these
 
 	analysesGlobal 			= analyses
 
@@ -354,6 +355,8 @@ $(document).ready(function () {
 
 	window.removeAnalysisTrigger = function (id) {
 
+		delete analysisSnapshots[id]
+
 		window.unselect()
 
 		analyses.removeAnalysisId(id);
@@ -363,6 +366,7 @@ $(document).ready(function () {
 	}
 
 	window.removeAllAnalyses = function () {
+		analysisSnapshots = {};
 		window.unselect();
 		analyses.close();
 		// Initialize view to defaults and re-render - Clears titles, notebox, etc.
@@ -426,8 +430,125 @@ $(document).ready(function () {
 
 	}
 
+	// Sorts the members of object like jsoncpp does, so a patched analysis looks exactly like a complete one would
+	var sortMembers = function (object) {
+		var keys	= Object.keys(object).sort();
+		var values	= keys.map(function (key) { return object[key] });
+
+		keys.forEach(function (key)		{ delete object[key]		});
+		keys.forEach(function (key, i)	{ object[key] = values[i]	});
+	}
+
+	// Applies the JSON Patch made by JsonUtilities::jsonPatch, returns the patched document or undefined if the patch did not fit
+	var applyJsonPatch = function (document, patch) {
+
+		for (var i = 0; i < patch.length; i++) {
+			var op		= patch[i].op
+			var path	= patch[i].path
+			var value	= patch[i].value
+
+			if (path === "") {
+				if (op !== "replace")
+					return undefined
+
+				document = value
+				continue
+			}
+
+			var tokens	= path.substring(1).split("/").map(function (token) { return token.replace(/~1/g, "/").replace(/~0/g, "~") })
+			var last	= tokens.pop()
+			var parent	= document
+
+			for (var t = 0; t < tokens.length; t++) {
+				if (parent === null || typeof parent !== "object" || !(tokens[t] in parent))
+					return undefined
+
+				parent = parent[tokens[t]]
+			}
+
+			if (parent === null || typeof parent !== "object")
+				return undefined
+
+			if (Array.isArray(parent)) {
+				var index = last === "-" ? parent.length : parseInt(last)
+
+				if		(op === "add"		&& index === parent.length)	parent.push(value)
+				else if	(op === "replace"	&& index <  parent.length)	parent[index] = value
+				else if	(op === "remove"	&& index <  parent.length)	parent.splice(index, 1)
+				else													return undefined
+			}
+			else if (op === "add" || (op === "replace" && last in parent)) {
+				var isNew		= !(last in parent)
+				parent[last]	= value
+
+				if (isNew)
+					sortMembers(parent)
+			}
+			else if (op === "remove" && last in parent)
+				delete parent[last]
+			else
+				return undefined
+		}
+
+		return document
+	}
+
+	// The members of the analysis a patch touches, or undefined if it replaces the analysis as a whole
+	var patchedMembers = function (patch) {
+		var members = {}
+
+		for (var i = 0; i < patch.length; i++) {
+			if (patch[i].path === "")
+				return undefined
+
+			members[patch[i].path.substring(1).split("/")[0].replace(/~1/g, "/").replace(/~0/g, "~")] = true
+		}
+
+		return Object.keys(members)
+	}
+
+	window.analysisPatched = function (id, patch) {
+
+		var jaspWidget	= analyses.getAnalysis(id)
+		var snapshot	= id in analysisSnapshots && jaspWidget !== undefined ? applyJsonPatch(analysisSnapshots[id], patch) : undefined
+
+		if (snapshot === undefined) {
+			// Out of sync, so ResultsJsInterface should send the whole analysis instead
+			delete analysisSnapshots[id]
+			jasp.resendAnalysis(id)
+			return
+		}
+
+		analysisSnapshots[id] = snapshot
+
+		var members = patchedMembers(patch)
+
+		if (members === undefined) {
+			updateAnalysis(JSON.parse(JSON.stringify(snapshot)))
+			return
+		}
+
+		// The views keep (and sometimes change) what they are given, so they get their own copy. But only of what changed, the rest they already have.
+		members.forEach(function (member) {
+			if (member in snapshot)	jaspWidget.model.set(member, JSON.parse(JSON.stringify(snapshot[member])))
+			else					jaspWidget.model.unset(member)
+		})
+
+		if (members.length === 1 && members[0] === "progress")
+			jaspWidget.updateProgressbarInResults()
+		else
+			updateAnalysis(jaspWidget.model.toJSON())
+	}
+
 	window.analysisChanged = function (analysis) {
 
+		analysisSnapshots[analysis.id] = JSON.parse(JSON.stringify(analysis))
+
+		updateAnalysis(analysis)
+	}
+
+	var updateAnalysis = function (analysis) {
+
 		if (showInstructions)
 			$instructions.fadeIn(400, "easeOutCubic")
 
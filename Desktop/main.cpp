@@ -30,6 +30,7 @@
 #include "utilities/plotschemehandler.h"
 #include "utilities/imgschemehandler.h"
 #include <json/json.h>
+#include "messagecodec.h"
 
 #ifdef linux
 #include "utilities/qmlutils.h"
@@ -147,6 +148,7 @@ void parseArguments(int argc, char *argv[], std::string & filePath, bool & newDa
 		else if(args[arg] == "--hide")							hideJASP				= true;
 		else if(args[arg] == "--safeGraphics")					safeGraphics			= true;
 		else if(args[arg] == "--newData")						newData					= true;
+		else if(args[arg] == "--benchmarkIPC")					exit(MessageCodec::benchmark(std::cout) ? 0 : 1);
 #ifdef _WIN32
 		else if(args[arg] == junctionArg)						runJaspEngineJunctionFixer(argc, argv, false); //Run the junctionfixer, it will exit the application btw!
 		else if(args[arg] == removeJunctionsArg)				runJaspEngineJunctionFixer(argc, argv, true);  //Remove the junctions
@@ -308,7 +310,7 @@ void parseArguments(int argc, char *argv[], std::string & filePath, bool & newDa
 
 	if(letsExplainSomeThings)
 	{
-		std::cerr	<< "JASP can be started without arguments, or the following: { --help | -h | filename | --unitTest filename | --unitTestRecursive folder | --save | --timeOut=10 | --logToFile | --hide } \n"
+		std::cerr	<< "JASP can be started without arguments, or the following: { --help | -h | filename | --unitTest filename | --unitTestRecursive folder | --save | --timeOut=10 | --logToFile | --hide | --benchmarkIPC } \n"
 					<< "If a filename is supplied JASP will try to load it. \nIf --unitTest is specified JASP will refresh all analyses in \"filename\" (which must be a JASP file) and see if the output remains the same and will then exit with an errorcode indicating succes or failure.\n"
 					<< "If --unitTestRecursive is specified JASP will go through specified \"folder\" and perform a --unitTest on each JASP file. After it has done this it will exit with an errorcode indication succes or failure.\n"
 					<< "For both testing arguments there is the optional --save argument, which specifies that JASP should save the file after refreshing it.\n"
@@ -316,6 +318,7 @@ void parseArguments(int argc, char *argv[], std::string & filePath, bool & newDa
 					<< "If --logToFile is specified then JASP will try it's utmost to write logging to a file, this might come in handy if you want to figure out why JASP does not start in case of a bug.\n"
 					<< "If --hide is specified then JASP will not be shown during recursive testing or reporting.\n"
 					<< "If --safeGraphics is specified then JASP will be started with software rendering enabled, this will be saved to your settings.\n"
+					<< "If --benchmarkIPC is specified JASP will measure how long it takes to encode, transfer and decode analysis results between engine and JASP, print that and exit.\n"
 					<< "If --report is specified then JASP will be started in reporting mode, which requires a path to where you would like to store the results. This is usually used in conjunction with a service/daemon and in that case it might make sense to also pass --hide. Don't forget to also pass a jasp filename otherwise it won't have anything to run...\n"
 			   #ifdef _WIN32
 					<< "If --junctions is specified JASP will recreate the junctions in Modules/ to renv-cache/, this needs to be done at least once after install, but is usually triggered automatically."
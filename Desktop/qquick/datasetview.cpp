@@ -3,13 +3,20 @@
 #include <QSGFlatColorMaterial>
 #include <QSGGeometry>
 #include <QSGNode>
+#include <QSGClipNode>
+#include <QSGTextNode>
+#include <QQuickWindow>
+#include <QMouseEvent>
 #include <queue>
+#include <algorithm>
 #include "timers.h"
 #include "log.h"
 #include "gui/preferencesmodel.h"
 #include "jasptheme.h"
 #include <QScreen>
 #include "data/datasetpackage.h"
+#include "data/datasettablemodel.h"
+#include "data/datasetprefetcher.h"
 #include <iostream>
 #include <QGuiApplication>
 #include <QClipboard>
@@ -54,6 +61,7 @@ DataSetView::DataSetView(QQuickItem *parent)
 	
 	connect(this,						&DataSetView::selectionChanged,					this, &DataSetView::selectionMinChanged);
 	connect(this,						&DataSetView::selectionChanged,					this, &DataSetView::selectionMaxChanged);
+	connect(this,						&DataSetView::selectionChanged,					this, &DataSetView::nativeCellsSelectionChanged);
 	
 	connect(PreferencesModel::prefs(),	&PreferencesModel::uiScaleChanged,				this, &DataSetView::resetItems,				Qt::QueuedConnection);
 	connect(PreferencesModel::prefs(),	&PreferencesModel::interfaceFontChanged,		this, &DataSetView::resetItems,				Qt::QueuedConnection);
@@ -72,6 +80,12 @@ void DataSetView::setModel(QAbstractItemModel * model)
 {
 	_model->setSourceModel(model);
 
+	DataSetTableModel * tableModel = qobject_cast<DataSetTableModel*>(model);
+	_prefetcher = tableModel ? tableModel->prefetcher() : nullptr; //Before connecting to the model, so it always forgets changed data before we ask for it
+
+	if(_prefetcher)
+		connect(_prefetcher,		&DataSetPrefetcher::cellsReady,					this, &DataSetView::prefetchedCellsReady, Qt::UniqueConnection);
+
 	if (model)
 	{
 		connect(model,				&QAbstractItemModel::modelReset,				this, &DataSetView::modelWasReset				);
@@ -162,6 +176,15 @@ void DataSetView::modelDataChanged(const QModelIndex &topLeft, const QModelIndex
 
 	if (_cacheItems || int(_cellSizes[size_t(colMin)].width() * 10) != int(calcSize.width() * 10)) //If we cache items we are not expecting the user to make regular manual changes to the data, so if something changes we can do a reset. Otherwise we are in TableView and we do it only when the column size changes.
 		calculateCellSizes();
+	else if (_nativeCells)
+	{
+		for (int row = rowMin; row <= rowMax; row++)
+			if(_storedDisplayText.count(row))
+				for (int col = colMin; col <= colMax; col++)
+					_storedDisplayText[row].erase(col);
+
+		viewportChanged();
+	}
 	else if (roles.contains(int(DataSetPackage::specialRoles::selected)) || roles.contains(Qt::DisplayRole))
 	{
 		// This is a special case for the VariablesWindows & TableView: caching mixed up the items, so it can't be used
@@ -247,6 +270,8 @@ void DataSetView::calculateCellSizesAndClear(bool clearStorage)
 	_dataColsMaxWidth.clear();
 	_storedLineFlags.clear();
 	_storedDisplayText.clear();
+	_nativeCellLayouts.clear();
+	_nativeCellsVisible.clear();
 
     storeAllItems();
 	
@@ -257,6 +282,7 @@ void DataSetView::calculateCellSizesAndClear(bool clearStorage)
 
 	_cellSizes.resize(_model->columnCount());
 	_colXPositions.resize(_model->columnCount());
+	_nativeCellLayouts.resize(_model->columnCount());
 	_cellTextItems.clear();
 
 	for(int col=0; col<_model->columnCount(); col++)
@@ -319,6 +345,10 @@ void DataSetView::viewportChanged()
 #endif
 
 	determineCurrentViewPortIndices();
+
+	if(_nativeCells && _prefetcher)
+		_prefetcher->viewportMoved(_currentViewportRowMin, _currentViewportRowMax, _currentViewportColMin, _currentViewportColMax);
+
     storeOutOfViewItems();
 	buildNewLinesAndCreateNewItems();
 
@@ -514,6 +544,9 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 {
 	JASPTIMER_RESUME(DataSetView::buildNewLinesAndCreateNewItems);
 
+	_nativeCellsVisible.clear();
+	_nativeCellsPending = false;
+
 	if(_currentViewportColMax == -1 ||  _currentViewportColMin == -1 || _currentViewportRowMax == -1 || _currentViewportRowMin == -1)
 		return;
 
@@ -541,7 +574,11 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 
 			JASPTIMER_RESUME(DataSetView::buildNewLinesAndCreateNewItems_GRID_DATA);
 			if(_storedLineFlags.count(row) == 0 || _storedLineFlags[row].count(col) == 0)
-				_storedLineFlags[row][col] = static_cast<unsigned char>(_model->data(row, col, _model->getRole("lines")).toInt());
+			{
+				const DataSetPrefetcher::Cell * prefetched = _nativeCells && _prefetcher ? _prefetcher->cell(row, col) : nullptr;
+
+				_storedLineFlags[row][col] = prefetched ? prefetched->lines : static_cast<unsigned char>(_model->data(row, col, _model->getRole("lines")).toInt());
+			}
 			unsigned char lineFlags = _storedLineFlags[row][col];
 			JASPTIMER_STOP(DataSetView::buildNewLinesAndCreateNewItems_GRID_DATA);
 
@@ -556,7 +593,9 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 					down	= (lineFlags & 8) > 0	&& pos1y  > _dataRowsMaxHeight + _viewportY;
 
 #ifdef SHOW_ITEMS_PLEASE
-			if(!(editing() && row == _prevEditRow && col == _prevEditCol))
+			if(_nativeCells)
+				createNativeCell(row, col); //The one being edited is skipped in createNativeCellsNode, so it needn't be rebuilt when editing stops
+			else if(!(editing() && row == _prevEditRow && col == _prevEditCol))
 				createTextItem(row, col);
 #endif
 
@@ -738,6 +777,128 @@ void DataSetView::setTextItemInfo(int row, int col, QQuickItem * textItem)
 	textItem->setVisible(true);
 }
 
+void DataSetView::createNativeCell(int row, int col)
+{
+	JASPTIMER_RESUME(DataSetView::createNativeCell);
+
+	const qreal	hPad		= _itemHorizontalPadding,
+				vPad		= _itemVerticalPadding,
+				x			= _colXPositions[col],
+				y			= (row + 1) * _dataRowsMaxHeight,
+				innerW		= _dataColsMaxWidth[col] - 2 * hPad,
+				innerH		= _dataRowsMaxHeight - 2 * vPad,
+				spacing		= JaspTheme::currentTheme() ? JaspTheme::currentTheme()->itemPadding() : hPad;
+
+	QString		text,
+				shadowText;
+	bool		showShadow	= false,
+				pending		= false;
+
+	if(_prefetcher && _prefetcher->handles(row, col))
+	{
+		const DataSetPrefetcher::Cell * prefetched = _prefetcher->cell(row, col);
+
+		if(!prefetched)
+		{
+			pending				= true;
+			_nativeCellsPending	= true;
+			text				= "…";
+		}
+		else
+		{
+			text		= prefetched->display;
+			shadowText	= prefetched->shadow;
+			showShadow	= shadowText != text;
+		}
+	}
+	else
+	{
+		bool		isEditable	= _model->flags(row, col) & Qt::ItemIsEditable;
+		QVariant	shadowVar	= _model->data(row, col, _model->getRole("shadowDisplay"));
+
+		text		= storedDisplayText(row, col, isEditable);
+		shadowText	= shadowVar.toString();
+		showShadow	= !shadowVar.isNull() && shadowText != text;
+	}
+
+	NativeCell cell;
+	cell.row		= row;
+	cell.col		= col;
+	cell.rect		= QRectF(x, y, _dataColsMaxWidth[col], _dataRowsMaxHeight);
+	cell.active		= !pending && _model->filtered(row, col);
+	cell.selected	= DataSetPackage::pkg()->dataMode() && _selectionModel->hasSelection() && isSelected(row, col);
+
+	//The widths follow the RowLayout in DataTableViewItem.qml, so switching between the two does not move any text around
+	qreal textMaxW = innerW;
+
+	if(showShadow)
+	{
+		qreal shadowW = JaspTheme::fontMetrics().horizontalAdvance(shadowText);
+		textMaxW = shadowW > innerW / 2 ? innerW / 2 : innerW - (shadowW + 2 * spacing);
+	}
+
+	cell.text		= nativeCellLayout(col, text, std::max(qreal(0), textMaxW), Qt::ElideRight);
+
+	const QTextLine textLine = cell.text->lineAt(0);
+	cell.textPos	= QPointF(x + hPad, y + vPad + (innerH - textLine.height()) / 2);
+
+	if(showShadow)
+	{
+		qreal shadowMaxW	= innerW - std::min(textLine.naturalTextWidth(), textMaxW) - spacing;
+		cell.shadow			= nativeCellLayout(col, shadowText, std::max(qreal(0), shadowMaxW), Qt::ElideLeft);
+
+		const QTextLine shadowLine = cell.shadow->lineAt(0);
+		cell.shadowPos	= QPointF(x + hPad + innerW - shadowLine.naturalTextWidth(), y + vPad + (innerH - shadowLine.height()) / 2);
+	}
+
+	//Same as the toolTipText in DataTableViewItem.qml
+	const bool	textTruncated	= cell.text->text() != text,
+				shadowTruncated	= showShadow && cell.shadow->text() != shadowText;
+
+	if(!pending && (textTruncated || shadowTruncated))
+		cell.toolTip = showShadow ? QString("%1 - %2").arg(text).arg(shadowText) : text;
+
+	_nativeCellsVisible.push_back(cell);
+
+	JASPTIMER_STOP(DataSetView::createNativeCell);
+}
+
+std::shared_ptr<QTextLayout> DataSetView::nativeCellLayout(int col, const QString & text, qreal maxWidth, Qt::TextElideMode elide)
+{
+	//Continuous columns have few repeated values, so make sure a long scroll through one doesnt keep every value it ever showed
+	const size_t maxLayoutsPerColumn = 4096;
+
+	auto & layouts	= _nativeCellLayouts[col];
+	auto   key		= std::make_tuple(text, int(maxWidth), int(elide));
+	auto   found	= layouts.find(key);
+
+	if(found != layouts.end())
+		return found->second;
+
+	if(layouts.size() >= maxLayoutsPerColumn)
+		layouts.clear();
+
+	JASPTIMER_SCOPE(DataSetView::nativeCellLayout);
+
+	std::shared_ptr<QTextLayout> layout = std::make_shared<QTextLayout>(JaspTheme::fontMetrics().elidedText(text, elide, maxWidth), JaspTheme::currentTheme() ? JaspTheme::currentTheme()->font() : QFont());
+	layout->setCacheEnabled(true);
+	layout->beginLayout();
+	layout->createLine();
+	layout->endLayout();
+
+	layouts[key] = layout;
+
+	return layout;
+}
+
+const QString & DataSetView::storedDisplayText(size_t row, size_t col, bool isEditable)
+{
+	if(isEditable || _storedDisplayText.count(row) == 0 || _storedDisplayText[row].count(col) == 0)
+		_storedDisplayText[row][col] = _model->data(row, col, Qt::DisplayRole).toString();
+
+	return _storedDisplayText[row][col];
+}
+
 void DataSetView::storeTextItem(int row, int col, bool cleanUp)
 {
 	if((_cellTextItems.count(col) == 0 && _cellTextItems[col].count(row) == 0) || _cellTextItems[col][row] == nullptr) return;
@@ -1032,7 +1193,9 @@ void DataSetView::destroyEditItem(bool createItem)
 	delete _editItemContextual;
 	_editItemContextual				= nullptr;
 
-	if(createItem && !(_prevEditRow == -1 || _prevEditCol == -1))
+	if(_nativeCells)
+		update(); //The cell under it was never taken out of _nativeCellsVisible
+	else if(createItem && !(_prevEditRow == -1 || _prevEditCol == -1))
 	{
 		Log::log() << "Restoring text item for old edit item at " << _prevEditRow << ", " << _prevEditCol << std::endl;
 		QQuickItem * item = createTextItem(_prevEditRow, _prevEditCol);
@@ -1855,6 +2018,8 @@ void DataSetView::onDataModeChanged(bool dataMode)
 		destroyEditItem();
 		setEditing(false);
 	}
+
+	nativeCellsSelectionChanged(); //The highlight is only shown in data mode
 }
 
 void DataSetView::commitLastEdit()
@@ -1871,10 +2036,7 @@ QQmlContext * DataSetView::setStyleDataItem(QQmlContext * previousContext, bool
 
 	bool isEditable(_model->flags(row, col) & Qt::ItemIsEditable);
 
-	if(isEditable || _storedDisplayText.count(row) == 0 || _storedDisplayText[row].count(col) == 0)
-		_storedDisplayText[row][col] = _model->data(row, col, Qt::DisplayRole).toString();
-
-	QString text = _storedDisplayText[row][col];
+	QString text = storedDisplayText(row, col, isEditable);
 
 	if(isEditable && text == tq(EmptyValues::displayString()) && !emptyValLabel)
 		text = "";
@@ -2047,6 +2209,96 @@ void DataSetView::setCacheItems(bool cacheItems)
 	calculateCellSizesAndClear(!_cacheItems);
 }
 
+void DataSetView::setNativeCells(bool nativeCells)
+{
+	if(nativeCells == _nativeCells)
+		return;
+
+	_nativeCells = nativeCells;
+
+	setAcceptedMouseButtons(_nativeCells ? Qt::LeftButton | Qt::RightButton : Qt::NoButton);
+	setAcceptHoverEvents(_nativeCells);
+
+	emit nativeCellsChanged();
+
+	calculateCellSizesAndClear(true);
+}
+
+void DataSetView::nativeCellsSelectionChanged()
+{
+	if(_nativeCells)
+		rebuildNativeCells();
+}
+
+void DataSetView::prefetchedCellsReady()
+{
+	if(_nativeCells && _nativeCellsPending)
+		rebuildNativeCells();
+}
+
+void DataSetView::rebuildNativeCells()
+{
+	//Not through viewportChanged, that would tell the prefetcher the viewport moved and make it drop what it was formatting ahead
+	if(!_model || _dataColsMaxWidth.size() != _model->columnCount())
+		return;
+
+	buildNewLinesAndCreateNewItems();
+	update();
+}
+
+QPoint DataSetView::cellAt(const QPointF & pos) const
+{
+	if(!_model || _colXPositions.empty() || _dataRowsMaxHeight <= 0 || pos.x() < _viewportX + _rowNumberMaxWidth || pos.y() < _viewportY + _dataRowsMaxHeight)
+		return QPoint(-1, -1);
+
+	int col = int(std::upper_bound(_colXPositions.begin(), _colXPositions.end(), pos.x()) - _colXPositions.begin()) - 1,
+		row = int(pos.y() / _dataRowsMaxHeight) - 1;
+
+	if(col < 0 || col >= _model->columnCount() || pos.x() >= _colXPositions[col] + _dataColsMaxWidth[col] || row < 0 || row >= _model->rowCount())
+		return QPoint(-1, -1);
+
+	return QPoint(col, row);
+}
+
+void DataSetView::mousePressEvent(QMouseEvent * event)
+{
+	_nativeCellPressed = cellAt(event->position());
+
+	if(_nativeCellPressed.x() == -1)	event->ignore();
+	else								event->accept();
+}
+
+void DataSetView::mouseReleaseEvent(QMouseEvent * event)
+{
+	QPoint cell = cellAt(event->position());
+
+	if(cell.x() != -1 && cell == _nativeCellPressed)
+		emit cellClicked(cell.y(), cell.x(), int(event->button()), int(event->modifiers()), event->globalPosition());
+
+	_nativeCellPressed = QPoint(-1, -1);
+}
+
+void DataSetView::hoverMoveEvent(QHoverEvent * event)
+{
+	QPoint cell = cellAt(event->position());
+
+	emit cellHovered(cell.y(), cell.x(), int(event->modifiers()), event->position());
+}
+
+void DataSetView::hoverLeaveEvent(QHoverEvent * event)
+{
+	emit cellHovered(-1, -1, int(event->modifiers()), event->position());
+}
+
+QString DataSetView::cellToolTip(int row, int col) const
+{
+	for(const NativeCell & cell : _nativeCellsVisible)
+		if(cell.row == row && cell.col == col)
+			return cell.toolTip;
+
+	return "";
+}
+
 void DataSetView::setExpandDataSet(bool expand)
 {
 	if (!_model || expand == expandDataSet())
@@ -2194,12 +2446,94 @@ QSGNode * DataSetView::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 
 	_linesWasChanged = false;
 
+	if(_nativeCells)
+		oldNode->prependChildNode(createNativeCellsNode()); //Under the lines
+
 	//JASPTIMER_STOP(DataSetView::updatePaintNode);
 
 	return oldNode;
 }
 #endif
 
+QSGNode * DataSetView::createNativeCellsNode()
+{
+	JASPTIMER_SCOPE(DataSetView::createNativeCellsNode);
+
+	//Clip away whatever is scrolled under the row numbers and column headers, the text items used to be hidden by those but our own node is drawn over them
+	QRectF		dataArea(	_viewportX + _rowNumberMaxWidth,
+							_viewportY + _dataRowsMaxHeight,
+							std::max(0.0, _viewportW - _rowNumberMaxWidth),
+							std::max(0.0, _viewportH - _dataRowsMaxHeight));
+
+	QSGClipNode	* clipNode	= new QSGClipNode();
+	QSGGeometry	* clipGeom	= new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 4);
+
+	QSGGeometry::updateRectGeometry(clipGeom, dataArea);
+	clipNode->setGeometry(clipGeom);
+	clipNode->setFlag(QSGNode::OwnsGeometry, true);
+	clipNode->setIsRectangular(true);
+	clipNode->setClipRect(dataArea);
+
+	auto isBeingEdited = [&](const NativeCell & cell) { return _editItemContextual && cell.row == _prevEditRow && cell.col == _prevEditCol; };
+
+	size_t selectedCells = 0;
+	for(const NativeCell & cell : _nativeCellsVisible)
+		if(cell.selected && !isBeingEdited(cell))
+			selectedCells++;
+
+	if(selectedCells > 0)
+	{
+		_highlightMaterial.setColor(JaspTheme::currentTheme() ? JaspTheme::currentTheme()->itemHighlight() : QColor(Qt::lightGray));
+
+		QSGGeometry			* highlightGeom = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), int(selectedCells * 6));
+		QSGGeometry::Point2D* vertex		= highlightGeom->vertexDataAsPoint2D();
+
+		highlightGeom->setDrawingMode(QSGGeometry::DrawTriangles);
+
+		for(const NativeCell & cell : _nativeCellsVisible)
+			if(cell.selected && !isBeingEdited(cell))
+			{
+				const QRectF & r = cell.rect;
+
+				(vertex++)->set(r.left(),	r.top());
+				(vertex++)->set(r.right(),	r.top());
+				(vertex++)->set(r.left(),	r.bottom());
+				(vertex++)->set(r.right(),	r.top());
+				(vertex++)->set(r.right(),	r.bottom());
+				(vertex++)->set(r.left(),	r.bottom());
+			}
+
+		QSGGeometryNode * highlightNode = new QSGGeometryNode();
+		highlightNode->setGeometry(highlightGeom);
+		highlightNode->setFlag(QSGNode::OwnsGeometry, true);
+		highlightNode->setMaterial(&_highlightMaterial);
+		highlightNode->setFlag(QSGNode::OwnsMaterial, false);
+
+		clipNode->appendChildNode(highlightNode);
+	}
+
+	//One node per color, the glyphs themselves come from the glyph cache the window keeps for all text
+	QSGTextNode	* enabledNode	= window()->createTextNode(),
+				* disabledNode	= window()->createTextNode();
+
+	enabledNode	->setColor(JaspTheme::currentTheme() ? JaspTheme::currentTheme()->textEnabled()	: QColor(Qt::black));
+	disabledNode->setColor(JaspTheme::currentTheme() ? JaspTheme::currentTheme()->textDisabled()	: QColor(Qt::gray));
+
+	for(const NativeCell & cell : _nativeCellsVisible)
+		if(!isBeingEdited(cell))
+		{
+			(cell.active ? enabledNode : disabledNode)->addTextLayout(cell.textPos, cell.text.get());
+
+			if(cell.shadow)
+				disabledNode->addTextLayout(cell.shadowPos, cell.shadow.get());
+		}
+
+	clipNode->appendChildNode(enabledNode);
+	clipNode->appendChildNode(disabledNode);
+
+	return clipNode;
+}
+
 void DataSetView::setMainData(bool newMainData)
 {
 	if (_mainData == newMainData)
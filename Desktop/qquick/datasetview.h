@@ -7,12 +7,17 @@
 #include <vector>
 #include <stack>
 #include <QSGFlatColorMaterial>
+#include <QTextLayout>
 
 #include <map>
+#include <memory>
+#include <tuple>
 #include <QtQml>
 #include "utilities/qutils.h"
 #include "data/expanddataproxymodel.h"
 
+class DataSetPrefetcher;
+
 #include <QItemSelectionModel>
 #include <QItemSelection>
 
@@ -41,6 +46,22 @@ struct ItemContextualized
 	QQmlContext * context	= nullptr;
 };
 
+///
+/// A cell as drawn by DataSetView itself when nativeCells is on, the text is laid out once per distinct value per column and shared between cells.
+struct NativeCell
+{
+	int								row,
+									col;
+	QRectF							rect;				///< Including the padding, for the highlight
+	QPointF							textPos,
+									shadowPos;
+	std::shared_ptr<QTextLayout>	text,
+									shadow;				///< Only set when the shadow text differs from the text, see DataTableViewItem.qml
+	QString							toolTip;			///< The full text, only set when some of it had to be elided
+	bool							active,
+									selected;
+};
+
 typedef std::map<int, std::map<int, ItemContextualized *>>  ItemCxsByColRow;
 typedef std::map<int, ItemContextualized *>                 ItemCxsByIndex;
 
@@ -49,6 +70,8 @@ typedef std::map<int, ItemContextualized *>                 ItemCxsByIndex;
 /// Contains custom rendering code for the lines to make sure they are always a single pixel wide.
 /// Caching is a bit flawed at the moment though so when changing data in the model it is best to turn that off.
 /// It also uses pools of header-, rowheader- and general-items when they go out of view to avoid the overhead of recreating them all the time.
+/// With nativeCells the cells are not QML items at all but text nodes in the scenegraph, clicks and hovers on them come out as cellClicked and cellHovered.
+/// If the model is a DataSetTableModel their text then comes from its DataSetPrefetcher, cells it hasn't formatted yet show a placeholder until it has.
 class DataSetView : public QQuickItem
 {
 	Q_OBJECT
@@ -78,6 +101,7 @@ class DataSetView : public QQuickItem
 	Q_PROPERTY(	bool					editing					READ editing				WRITE setEditing				NOTIFY editingChanged				)
 	Q_PROPERTY( bool					mainData				READ mainData				WRITE setMainData				NOTIFY mainDataChanged				)
 	Q_PROPERTY( int						maxColWidth				READ maxColWidth			WRITE setMaxColWidth			NOTIFY maxColWidthChanged			)
+	Q_PROPERTY( bool					nativeCells				READ nativeCells			WRITE setNativeCells			NOTIFY nativeCellsChanged			)
 	
 public:
 	friend ExpandDataProxyModel;
@@ -115,11 +139,13 @@ public:
 	QPoint					selectionMax()						const;
 	bool					editing()							const	{ return _editing;					}
 	bool					mainData()							const	{ return _mainData;					}
+	bool					nativeCells()						const	{ return _nativeCells;				}
 
 	Q_INVOKABLE QQuickItem*	getColumnHeader(int col)					{ return _columnHeaderItems.count(col) 	> 0	? _columnHeaderItems[col]->item : nullptr;	}
 	Q_INVOKABLE QQuickItem*	getRowHeader(	int row)					{ return _rowNumberItems.count(row) 	> 0 ? _rowNumberItems[row]->item	: nullptr;	}
 
 	Q_INVOKABLE	bool		clipBoardPasteIsCells()				const;
+	Q_INVOKABLE	QString		cellToolTip(int row, int col)		const;	///< Only for nativeCells, empty when the whole text of the cell is visible
 	
 	GENERIC_SET_FUNCTION(ViewportX,		_viewportX,		viewportXChanged,	double	)
 	GENERIC_SET_FUNCTION(ViewportY,		_viewportY,		viewportYChanged,	double	)
@@ -137,6 +163,7 @@ public:
 	void setEditDelegate(			QQmlComponent	* editDelegate);
 	void setTableViewItem(			QQuickItem		* tableViewItem) { _tableViewItem = tableViewItem; }
 	void setCacheItems(				bool			  cacheItems);
+	void setNativeCells(			bool			  nativeCells);
 	void setExpandDataSet(			bool			  expandDataSet);
 
 	void resetItems();
@@ -196,6 +223,10 @@ signals:
 	void		editCoordinatesChanged();
 	
 	void		maxColWidthChanged();
+
+	void		nativeCellsChanged();
+	void		cellClicked(int row, int column, int button, int modifiers, QPointF globalPos);
+	void		cellHovered(int row, int column, int modifiers, QPointF pos);	///< row and column are -1 when the mouse left the cells, pos is in the coordinates of this item
 	
 public slots:
 	void		calculateCellSizes()	{ calculateCellSizesAndClear(false); }
@@ -213,6 +244,8 @@ public slots:
 	void		modelAboutToBeReset();
 	void		modelWasReset();
 	void		setExtraColumnX();
+	void		nativeCellsSelectionChanged();
+	void		prefetchedCellsReady();
 	
 	bool		isSelected(			int row, int col);
 	void		pollSelectScroll(	int row, int column);
@@ -288,11 +321,23 @@ protected:
 #ifdef ADD_LINES_PLEASE
 	QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
 #endif
+	QSGNode	*	createNativeCellsNode();
+
+	void		mousePressEvent(	QMouseEvent * event) override;
+	void		mouseReleaseEvent(	QMouseEvent * event) override;
+	void		hoverMoveEvent(		QHoverEvent * event) override;
+	void		hoverLeaveEvent(	QHoverEvent * event) override;
+	QPoint		cellAt(const QPointF & pos) const; ///< Returns (col, row) of the data cell under pos or (-1, -1)
 	float extraColumnWidth() { return !_extraColumnItem || expandDataSet() ? 0 : 2 + _extraColumnItem->width(); }
 
 	QQuickItem *	createTextItem(int row, int col);
 	void			storeTextItem(int row, int col, bool cleanUp = true);
 	void			setTextItemInfo(int row, int col, QQuickItem * textItem);
+	const QString &	storedDisplayText(size_t row, size_t col, bool isEditable);
+
+	void							rebuildNativeCells();	///< When only their contents changed and the viewport did not move
+	void							createNativeCell(	int row, int col);
+	std::shared_ptr<QTextLayout>	nativeCellLayout(	int col, const QString & text, qreal maxWidth, Qt::TextElideMode elide);
 
 	QQuickItem	*	createRowNumber(	int row);
 	void			storeRowNumber(		int row);
@@ -343,13 +388,20 @@ protected:
 	QSGFlatColorMaterial									_material;
 	std::map<size_t, std::map<size_t, unsigned char>>		_storedLineFlags;
 	std::map<size_t, std::map<size_t, QString>>				_storedDisplayText;
+	std::vector<NativeCell>									_nativeCellsVisible;
+	std::vector<std::map<std::tuple<QString, int, int>, std::shared_ptr<QTextLayout>>>	_nativeCellLayouts; //[col][text, maxWidth, elide]
+	QSGFlatColorMaterial									_highlightMaterial;
+	QPoint													_nativeCellPressed		= QPoint(-1, -1);
+	DataSetPrefetcher									*	_prefetcher				= nullptr;
 	static DataSetView									*	_mainDataSetView;
 	bool													_cacheItems				= false,
 															_recalculateCellSizes	= false,
 															_ignoreViewpoint		= true,
 															_linesWasChanged		= false,
 															_editing				= false,
-															_mainData				= false;
+															_mainData				= false,
+															_nativeCells			= false,
+															_nativeCellsPending		= false;
 	double													_dataRowsMaxHeight,
 															_dataWidth				= -1,
 															_rowNumberMaxWidth		= 0,
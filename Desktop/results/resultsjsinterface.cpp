@@ -37,6 +37,9 @@
 #include "gui/preferencesmodel.h"
 #include <QThread>
 #include "log.h"
+#include "timers.h"
+#include "messagecodec.h"
+#include "analysis/analyses.h"
 
 ResultsJsInterface * ResultsJsInterface::_singleton = nullptr;
 
@@ -78,6 +81,9 @@ void ResultsJsInterface::setResultsLoaded(bool resultsLoaded)
 	_resultsLoaded = resultsLoaded;
 	emit resultsLoadedChanged(_resultsLoaded);
 
+	//A (re)loaded page starts without any analyses
+	_analysesInResults.clear();
+
 	if (resultsLoaded)
 	{
 		QString version = AboutModel::version();
@@ -293,7 +299,31 @@ void ResultsJsInterface::exportSelected(const QString &filename)
 
 void ResultsJsInterface::analysisChanged(Analysis *analysis)
 {
-	runJavaScript("window.analysisChanged(JSON.parse('" + escapeJavascriptString(tq(analysis->asJSON().toStyledString())) + "'));");
+	JASPTIMER_SCOPE(ResultsJsInterface::analysisChanged);
+
+	//An analysis sending progress or a table row by row changes only a little every time, so then javascript gets a patch instead of everything again
+	const size_t	maxPatchOperations	= 1000;
+	const int		id					= analysis->id();
+	Json::Value		analysisJson		= analysis->asJSON();
+	auto			inResults			= _analysesInResults.find(id);
+	Json::Value		patch				= inResults == _analysesInResults.end() ? Json::nullValue : JsonUtilities::jsonPatch(inResults->second, analysisJson, maxPatchOperations);
+
+	if(patch.isNull())	runJavaScript("window.analysisChanged(JSON.parse('"										+ escapeJavascriptString(tq(MessageCodec::compactJson()->encode(analysisJson)))	+ "'));");
+	else				runJavaScript("window.analysisPatched(" + QString::number(id) + ", JSON.parse('"		+ escapeJavascriptString(tq(MessageCodec::compactJson()->encode(patch)))		+ "'));");
+
+	_analysesInResults[id] = std::move(analysisJson);
+}
+
+void ResultsJsInterface::resendAnalysis(int id)
+{
+	Log::log() << "Results for analysis " << id << " are out of sync with javascript, sending them completely." << std::endl;
+
+	_analysesInResults.erase(id);
+
+	Analysis * analysis = Analyses::analyses()->get(id);
+
+	if(analysis)
+		analysisChanged(analysis);
 }
 
 void ResultsJsInterface::setResultsMeta(const QString & str)
@@ -318,11 +348,13 @@ void ResultsJsInterface::unselect()
 
 void ResultsJsInterface::removeAnalysis(Analysis *analysis)
 {
+	_analysesInResults.erase(analysis->id());
 	runJavaScript("window.removeAnalysisTrigger(" + QString::number(analysis->id()) + ")");
 }
 
 void ResultsJsInterface::removeAnalyses()
 {
+	_analysesInResults.clear();
 	runJavaScript("window.removeAllAnalyses()");
 }
 
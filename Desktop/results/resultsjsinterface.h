@@ -67,6 +67,7 @@ public:
 	Q_INVOKABLE void purgeClipboard();
 	Q_INVOKABLE void analysisEditImage(int id, QString options);
 	Q_INVOKABLE void runJavaScript(const QString & js);
+	Q_INVOKABLE void resendAnalysis(int id); ///< Called from javascript when a patch from analysisChanged did not fit what it had
 
 	//Callable from javascript through resultsJsInterfaceInterface...
 signals:
@@ -152,6 +153,7 @@ private:
 						_scrollAtAll	= true;
 	
 	std::queue<QString>	_delayedJs;
+	std::map<int, Json::Value>	_analysesInResults; ///< Analysis::asJSON as last sent to javascript, so analysisChanged can send only what changed
 
 	static ResultsJsInterface * _singleton;
 };
@@ -80,6 +80,7 @@ const Settings::Setting Settings::Values[] = {
 	{"dbImportPassword",			""		},
 	{"dbImportQuery",				""		},
 	{"dbImportInterval",			0		},
+	{"dbImportIncrementalColumn",	""		},
 	{"dbShowWarning",				true	},
 	{"dbRememberMe",				false	},
 	{"dataNALabel",					"."		},
@@ -95,7 +96,8 @@ const Settings::Setting Settings::Values[] = {
 	{"checkUpdatesLastTime",		-1		},
 	{"maxScaleLevels",				100		},
 	{"pdfLandscape",				false	},
-	{"pdfPageSize",					int(pdfPageSize::A4)			}
+	{"pdfPageSize",					int(pdfPageSize::A4)			},
+	{"undoMemoryBudgetMB",			512		}
 	
 };	
 
@@ -64,6 +64,7 @@ public:
 		DB_IMPORT_PASSWORD,
 		DB_IMPORT_QUERY,
 		DB_IMPORT_INTERVAL,
+		DB_IMPORT_INCREMENTAL_COLUMN,
 		DB_SHOW_WARNING,
 		DB_REMEMBER_ME,
 		DATA_LABEL_NA,
@@ -79,7 +80,8 @@ public:
 		LAST_CHECK,
 		MAX_SCALE_LEVELS,
 		PDF_LANDSCAPE,
-		PDF_PAGESIZE
+		PDF_PAGESIZE,
+		UNDO_MEMORY_BUDGET_MB
 	};
 
 	static QVariant value(Settings::Type key);
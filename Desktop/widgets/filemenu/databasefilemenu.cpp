@@ -48,6 +48,7 @@ DatabaseFileMenu::DatabaseFileMenu(FileMenu *parent)
 	QObject::connect(this, &DatabaseFileMenu::allChanged, this, &DatabaseFileMenu::queryChanged			);
 	QObject::connect(this, &DatabaseFileMenu::allChanged, this, &DatabaseFileMenu::resultsOKChanged		);
 	QObject::connect(this, &DatabaseFileMenu::allChanged, this, &DatabaseFileMenu::intervalChanged		);
+	QObject::connect(this, &DatabaseFileMenu::allChanged, this, &DatabaseFileMenu::incrementalColumnChanged	);
 	QObject::connect(this, &DatabaseFileMenu::allChanged, this, &DatabaseFileMenu::rememberMeChanged	);
 }
 
@@ -61,6 +62,7 @@ void DatabaseFileMenu::loadFromSettings()
 	_info._password		= decrypt(				Settings::value( Settings::DB_IMPORT_PASSWORD	).toString());
 	_info._query		=						Settings::value( Settings::DB_IMPORT_QUERY		).toString();
 	_info._interval		=						Settings::value( Settings::DB_IMPORT_INTERVAL	).toInt();
+	_info._incrementalColumn =					Settings::value( Settings::DB_IMPORT_INCREMENTAL_COLUMN ).toString();
 	_info._rememberMe	=						Settings::value( Settings::DB_REMEMBER_ME		).toBool();
 	
 	emit allChanged();
@@ -324,6 +326,18 @@ void DatabaseFileMenu::setResultsOK(bool newResultsOK)
 	emit resultsOKChanged();
 }
 
+void DatabaseFileMenu::setIncrementalColumn(const QString &newIncrementalColumn)
+{
+	if (_info._incrementalColumn == newIncrementalColumn)
+		return;
+	
+	_info._incrementalColumn = newIncrementalColumn;
+	if(useDataSetPackage())	DataSetPackage::pkg()->setDatabaseJson(_info.toJson());
+	else					Settings::setValue(Settings::DB_IMPORT_INCREMENTAL_COLUMN, _info._incrementalColumn);
+	
+	emit incrementalColumnChanged();
+}
+
 void DatabaseFileMenu::setInterval(int newInterval)
 {
 	if (_info._interval == newInterval)
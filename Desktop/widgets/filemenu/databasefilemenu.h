@@ -24,6 +24,7 @@ class DatabaseFileMenu : public FileMenuObject
 	Q_PROPERTY(int			port		READ port			WRITE setPort			NOTIFY portChanged			)
 	Q_PROPERTY(bool			resultsOK	READ resultsOK		WRITE setResultsOK		NOTIFY resultsOKChanged		)
 	Q_PROPERTY(int			interval	READ interval		WRITE setInterval		NOTIFY intervalChanged		)
+	Q_PROPERTY(QString		incrementalColumn	READ incrementalColumn	WRITE setIncrementalColumn	NOTIFY incrementalColumnChanged	)
 	Q_PROPERTY(bool			dbMaybeFile	READ dbMaybeFile							NOTIFY dbTypeChanged		)
 	Q_PROPERTY(bool			rememberMe	READ rememberMe		WRITE setRememberMe		NOTIFY rememberMeChanged	)
 
@@ -48,6 +49,7 @@ public:
 	const QString		&		query()				const { return _info._query;						}
 	bool						resultsOK()			const { return _resultsOK;							}
 	int							interval()			const { return _info._interval;						}
+	const QString		&		incrementalColumn()	const { return _info._incrementalColumn;			}
 	bool						dbMaybeFile()		const { return _info._dbType == DbType::QSQLITE;	}
 	const bool					rememberMe()		const { return _info._rememberMe;					}
 
@@ -67,6 +69,7 @@ public:
 	void						setLastError(	const QString &	newLastError	);
 	void						setResultsOK(	bool			newResultsOK	);
 	void						setInterval(	int				newInterval		);
+	void						setIncrementalColumn(const QString & newIncrementalColumn);
 	void						setRememberMe(	bool			rememberMe		);
 	
 private slots:
@@ -87,6 +90,7 @@ signals:
 	void						queryChanged();
 	void						resultsOKChanged();
 	void						intervalChanged();
+	void						incrementalColumnChanged();
 	void						rememberMeChanged();
 	
 private:
@@ -21,7 +21,10 @@
 #include "timers.h"
 #include "rbridge.h"
 #include "tempfiles.h"
+#include "dirs.h"
 #include "columnutils.h"
+#include "jsonutilities.h"
+#include "messagecodec.h"
 #include "processinfo.h"
 #include "databaseinterface.h"
 #include "r_functionwhitelist.h"
@@ -70,7 +73,10 @@ Engine::Engine(int slaveNo, unsigned long parentPID)
 	JASPTIMER_STOP(TempFiles Attach);
 
 	if(parentPID != 0) //Otherwise we are just running to fix R packages
-		_db = new DatabaseInterface();
+	{
+		_db				= new DatabaseInterface();
+		_resultCache	= new ResultCache(Dirs::tempDir() + "/resultCache"); //Not a number so TempFiles::deleteOrphans leaves it alone
+	}
 
 	_extraEncodings = new ColumnEncoder("JaspExtraOptions_");
 }
@@ -101,6 +107,9 @@ Engine::~Engine()
 {
 	delete _channel; //shared memory files will be removed in jaspDesktop
 	_channel = nullptr;
+
+	delete _resultCache;
+	_resultCache = nullptr;
 }
 
 void Engine::run()
@@ -165,18 +174,10 @@ bool Engine::receiveMessages(int timeout)
 			return false;
 		}
 
-		// JSONCPP_STRING          err;
-		// Json::Value		        jsonRequest;
-		// Json::CharReaderBuilder jsonReaderBuilder;
-		// std::unique_ptr<Json::CharReader> const jsonReader(jsonReaderBuilder.newCharReader());
-
-		// if(!jsonReader->parse(data.c_str(), data.c_str() + data.length(), &jsonRequest, &err))
-		
-
 		Json::Value		jsonRequest;
-		Json::Reader	jsonReader;
+		std::string		decodeError;
 
-		if(!jsonReader.parse(data, jsonRequest, false))
+		if(!MessageCodec::decode(data, jsonRequest, &decodeError))
 		{
 			Log::log() << "Engine got request:\nrow 0:\t";
 
@@ -188,20 +189,16 @@ bool Engine::receiveMessages(int timeout)
 				Log::log() << c;
 			}
 
-			Log::log() << "Parsing request failed on:\n" << jsonReader.getFormattedErrorMessages() << std::endl;
-			// Log::log() << "Parsing request failed on:\n" << err << std::endl;
+			Log::log() << "Parsing request failed on:\n" << decodeError << std::endl;
 		}
 
 		//Clear send buffer and anonymized log
-		Json::Value printData;
-		bool parsed = jsonReader.parse(data, printData);
-		if (parsed && printData.isMember("GITHUB_PAT")) {
+		Json::Value printData = jsonRequest;
+		if (printData.isMember("GITHUB_PAT")) {
 			printData["GITHUB_PAT"] = "********";
 		}
 		
-		Log::log() << "Received: '" << printData.toStyledString() << "' so now clearing my send buffer" << std::endl;
-
-		sendString("");
+		Log::log() << "Received: '" << printData.toStyledString() << "'" << std::endl;
 
 		//Check if we got anyting useful
 		std::string typeSend	= jsonRequest.get("typeRequest", Json::nullValue).asString();
@@ -417,7 +414,7 @@ void Engine::sendFilterResult(int filterRequestId)
 	filterResponse["typeRequest"]	= engineStateToString(engineState::filter);
 	filterResponse["requestId"]		= filterRequestId;
 
-	sendString(filterResponse.toStyledString());
+	sendMessage(filterResponse);
 }
 
 void Engine::sendFilterError(int filterRequestId, const std::string & errorMessage)
@@ -430,7 +427,7 @@ void Engine::sendFilterError(int filterRequestId, const std::string & errorMessa
 	filterResponse["requestId"]		= filterRequestId;
 	filterResponse["error"]			= errorMessage;
 
-	sendString(filterResponse.toStyledString());
+	sendMessage(filterResponse);
 }
 
 void Engine::sendFilterByNameDone(const std::string & name, const std::string & errorMessage)
@@ -441,7 +438,7 @@ void Engine::sendFilterByNameDone(const std::string & name, const std::string &
 	filterResponse["name"]			= name;
 	filterResponse["errorMessage"]	= errorMessage;
 
-	sendString(filterResponse.toStyledString());
+	sendMessage(filterResponse);
 }
 
 void Engine::receiveRCodeMessage(const Json::Value & jsonRequest)
@@ -515,7 +512,7 @@ void Engine::sendRCodeResult(int rCodeRequestId, const std::string & rCodeResult
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
 
-	sendString(rCodeResponse.toStyledString());
+	sendMessage(rCodeResponse);
 }
 
 void Engine::sendRCodeError(int rCodeRequestId)
@@ -528,7 +525,7 @@ void Engine::sendRCodeError(int rCodeRequestId)
 	rCodeResponse["rCodeError"]		= RError.size() == 0 ? "R Code failed for unknown reason. Check that R function returns a string." : RError;
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
-	sendString(rCodeResponse.toStyledString());
+	sendMessage(rCodeResponse);
 }
 
 void Engine::receiveComputeColumnMessage(const Json::Value & jsonRequest)
@@ -584,7 +581,7 @@ void Engine::runComputeColumn(const std::string & computeColumnName, const std::
 		computeColumnResponse["error"]			= "No DataSet loaded in engine!";
 	}
 
-	sendString(computeColumnResponse.toStyledString());
+	sendMessage(computeColumnResponse);
 	
 	_engineState = engineState::idle;
 }
@@ -624,7 +621,7 @@ void Engine::receiveModuleRequestMessage(const Json::Value & jsonRequest)
 
 	Log::log() << "Sending it." << std::endl;
 
-	sendString(jsonAnswer.toStyledString());
+	sendMessage(jsonAnswer);
 
 	_engineState = engineState::idle;
 }
@@ -688,6 +685,7 @@ void Engine::receiveAnalysisMessage(const Json::Value & jsonRequest)
 		_imageOptions			= jsonRequest.get("image",				Json::nullValue);
 		_analysisRFile			= jsonRequest.get("rfile",				"").asString();
 		_dynamicModuleCall		= jsonRequest.get("dynamicModuleCall",	"").asString();
+		_analysisModuleVersion	= jsonRequest.get("moduleVersion",		"").asString();
 		_resultFont				= jsonRequest.get("resultFont",			"").asString();
 		_analysisPreloadData	= jsonRequest.get("preloadData",		false).asBool();
 		_engineState			= engineState::analysis;
@@ -717,14 +715,61 @@ void Engine::sendString(std::string message)
 	// if(jsonReader->parse(message.c_str(), message.c_str() + message.length(), &msgJson, &err)) //If everything is converted to jaspResults maybe we can do this there?
 
 	if(Json::Reader().parse(message, msgJson)) //If everything is converted to jaspResults maybe we can do this there?
-	{
-		ColumnEncoder::columnEncoder()->decodeJsonSafeHtml(msgJson); // decode all columnnames as far as you can
-		_channel->send(msgJson.toStyledString());
-	}
+		sendMessage(msgJson);
 	else
 		_channel->send(message);
 }
 
+void Engine::sendMessage(Json::Value msgJson)
+{
+	ColumnEncoder::columnEncoder()->decodeJsonSafeHtml(msgJson); // decode all columnnames as far as you can
+
+	if(	_engineState == engineState::analysis && msgJson.get("id", -1).asInt() == _analysisId &&
+		msgJson.get("status", "").asString() == analysisResultStatusToString(analysisResultStatus::complete))
+		_analysisCompleteResults = msgJson;
+
+	if(_engineState == engineState::analysis && msgJson.isMember("results"))
+		patchAnalysisResults(msgJson);
+
+	if(!_channel->sendMessage(msgJson))
+		_resultsSentId = -1; //Desktop did not get it, so the next results should not be a patch against it
+}
+
+void Engine::patchAnalysisResults(Json::Value & msgJson)
+{
+	JASPTIMER_SCOPE(Engine::patchAnalysisResults);
+
+	//A big table filling up row by row otherwise gets sent (and parsed in Desktop) in full every time.
+	//Only intermediate results are patched, and every so often the full results are sent anyway so that Desktop gets back in sync if it had to skip a patch.
+	const size_t	maxPatchOperations	= 1000;
+	const int		fullResultsEvery	= 25;
+
+	const int		id			= msgJson.get("id",			-1).asInt(),
+					revision	= msgJson.get("revision",	-1).asInt();
+	const bool		running		= msgJson.get("status",		"").asString() == analysisResultStatusToString(analysisResultStatus::running);
+	Json::Value		results		= msgJson["results"];
+
+	msgJson["resultsSequence"] = ++_resultsSentSequence;
+
+	Json::Value patch = !running || id != _resultsSentId || revision != _resultsSentRevision || _resultsPatchesInARow >= fullResultsEvery
+					  ? Json::nullValue
+					  : JsonUtilities::jsonPatch(_resultsSent, results, maxPatchOperations);
+
+	if(patch.isNull())
+		_resultsPatchesInARow = 0;
+	else
+	{
+		msgJson.removeMember("results");
+		msgJson["resultsPatch"]		= patch;
+		msgJson["resultsPatchBase"]	= _resultsSentSequence - 1;
+		_resultsPatchesInARow++;
+	}
+
+	_resultsSent			= std::move(results);
+	_resultsSentId			= id;
+	_resultsSentRevision	= revision;
+}
+
 
 void Engine::runAnalysis()
 {
@@ -753,9 +798,17 @@ void Engine::runAnalysis()
 	
 	updateOptionsAccordingToMeta(encodedAnalysisOptions);
 
+	Json::Value unencodedOptions = encodedAnalysisOptions;
+
 	_analysisColsTypes = ColumnEncoder::encodeColumnNamesinOptions(encodedAnalysisOptions, _analysisPreloadData);
 
-	
+	std::string cacheKey = analysisCacheKey(unencodedOptions);
+
+	if(sendCachedAnalysisResults(cacheKey))
+		return;
+
+	_analysisCompleteResults	= Json::nullValue;
+	_analysisChangedData		= false;
 
 	_analysisResultsString = rbridge_runModuleCall(_analysisName, _analysisTitle, _dynamicModuleCall, _analysisDataKey,
 								encodedAnalysisOptions.toStyledString(), _analysisStateKey, _analysisId, _analysisRevision, 
@@ -790,11 +843,118 @@ void Engine::runAnalysis()
 			_analysisStatus = Status::empty;
 
 			removeNonKeepFiles(_analysisResults.isObject() ? _analysisResults.get("keep", Json::nullValue) : Json::nullValue);
+
+			if(!cacheKey.empty() && !_analysisChangedData && !_analysisCompleteResults.isNull())
+				_resultCache->store(cacheKey, _analysisId, _analysisCompleteResults);
+
 			return;
 		
 	}
 }
 
+std::string Engine::analysisCacheKey(const Json::Value & options)
+{
+	JASPTIMER_SCOPE(Engine::analysisCacheKey);
+
+	//In developer mode the R code of a module changes without its version changing
+	if(!_resultCache || _developerMode)
+		return "";
+
+	ResultCache::Hasher hasher;
+
+	hasher.add(options.toStyledString());
+	hasher.add(_analysisName);
+	hasher.add(_analysisRFile);
+	hasher.add(_dynamicModuleCall);
+	hasher.add(_analysisModuleVersion);
+	hasher.add(_analysisDataKey);
+	hasher.add(_analysisStateKey);
+	hasher.add(_analysisId); //The results refer to files in the resources of this analysis
+
+	//Everything that changes the way results look
+	hasher.add(_ppi);
+	hasher.add(_numDecimals);
+	hasher.add(int(_fixedDecimals) | int(_exactPValues) << 1 | int(_normalizedNotation) << 2);
+	hasher.add(_imageBackground);
+	hasher.add(_resultFont);
+	hasher.add(_langR);
+
+	DataSet * data = provideAndUpdateDataSet();
+
+	if(!data)
+		return hasher.hex();
+
+	try
+	{
+		Filter * filter = data->filter();
+
+		hasher.add(int(data->rowCount()));
+
+		if(!_analysisPreloadData) //Then R might read any column it likes
+			for(Column * column : data->columns())
+				hasher.add(columnFingerprint(column, filter));
+
+		for(const auto & nameType : _analysisColsTypes)
+		{
+			const std::string	&	name	= nameType.first;
+			Column				*	column	= data->column(ColumnEncoder::columnEncoder()->shouldDecode(name) ? ColumnEncoder::columnEncoder()->decode(name) : ColumnEncoder::columnEncoder()->decode(ColumnEncoder::columnEncoder()->encode(name)));
+
+			if(!column)
+				return "";
+
+			hasher.add(int(nameType.second));
+			hasher.add(columnFingerprint(column, filter));
+		}
+	}
+	catch(std::exception & e)
+	{
+		Log::log() << "Engine::analysisCacheKey could not fingerprint the data, so results won't be cached. Because: " << e.what() << std::endl;
+		return "";
+	}
+
+	return hasher.hex();
+}
+
+const std::string & Engine::columnFingerprint(Column * column, Filter * filter)
+{
+	ColumnFingerprint & fingerprint = _columnFingerprints[column->name()];
+
+	if(fingerprint.hash.empty() || fingerprint.columnRevision != column->revision() || fingerprint.filterRevision != filter->revision())
+	{
+		JASPTIMER_SCOPE(Engine::columnFingerprint recompute);
+
+		ResultCache::Hasher hasher;
+		hasher.addColumn(column, filter->filtered());
+
+		fingerprint.columnRevision	= column->revision();
+		fingerprint.filterRevision	= filter->revision();
+		fingerprint.hash			= hasher.hex();
+	}
+
+	return fingerprint.hash;
+}
+
+bool Engine::sendCachedAnalysisResults(const std::string & cacheKey)
+{
+	Json::Value results;
+
+	if(cacheKey.empty() || !_resultCache->restore(cacheKey, _analysisId, results))
+		return false;
+
+	Log::log() << "Results of " << _analysisTitle << " (" << _analysisId << ") were found in the cache, R is not needed." << std::endl;
+
+	results["revision"]	= _analysisRevision;
+	results["progress"]	= Json::nullValue;
+
+	patchAnalysisResults(results);
+	_channel->sendMessage(results);
+
+	_engineState	= engineState::idle;
+	_analysisStatus = Status::empty;
+
+	return true;
+}
+
 void Engine::saveImage()
 {	
 	int			height	= _imageOptions.get("height",	Json::nullValue).asInt(),
@@ -894,6 +1054,8 @@ std::string Engine::createColumn(const std::string &columnName)
 	col->setAnalysisId(_analysisId);
 	col->setCodeType(computedColumnType::analysisNotComputed);
 
+	_analysisChangedData = true;
+
 	reloadColumnNames();
 
 	return rbridge_encodeColumnName(columnName.c_str());
@@ -912,6 +1074,8 @@ bool Engine::deleteColumn(const std::string &columnName)
 	
 	data->removeColumn(columnName);
 	
+	_analysisChangedData = true;
+
 	reloadColumnNames();
 	
 	return true;
@@ -922,9 +1086,21 @@ bool Engine::setColumnDataAndType(const std::string &columnName, const std::vect
 	if(!isColumnNameOk(columnName))
 		return false;
 
+	_analysisChangedData = true;
+
 	return provideAndUpdateDataSet()->column(columnName)->overwriteDataAndType(data, colType);
 }
 
+bool Engine::setColumnDataAndType(const std::string &columnName, const doublevec & dbls, const intvec & levelIndices, const stringvec & levels, columnType colType)
+{
+	if(!isColumnNameOk(columnName))
+		return false;
+
+	_analysisChangedData = true;
+
+	return provideAndUpdateDataSet()->column(columnName)->overwriteDataAndType(dbls, levelIndices, levels, colType);
+}
+
 void Engine::sendAnalysisResults()
 {
 	Json::Value response			= Json::Value(Json::objectValue);
@@ -941,7 +1117,7 @@ void Engine::sendAnalysisResults()
 	response["results"] = _analysisResults.get("results", _analysisResults);
 	response["status"]  = analysisResultStatusToString(resultStatus);
 
-	sendString(response.toStyledString());
+	sendMessage(response);
 }
 
 void Engine::removeNonKeepFiles(const Json::Value & filesToKeepValue)
@@ -977,10 +1153,25 @@ DataSet * Engine::provideAndUpdateDataSet()
 	bool setColumnNames = !_dataSet;
 
 	if(!_dataSet && _db->dataSetGetId() != -1)
+	{
+		rbridge_forgetAllCachedColumns(); //Whatever R got before came from another data set
+		_columnFingerprints.clear();
 		_dataSet = new DataSet(_db->dataSetGetId());
+	}
 
 	if(_dataSet)
-		setColumnNames |= _dataSet->checkForUpdates();
+	{
+		//Values changed through the change log do not increase the revision of the column, so those columns need to be forgotten explicitly
+		stringvec colsChanged, colsRemoved;
+		setColumnNames |= _dataSet->checkForUpdates(&colsChanged, &colsRemoved);
+
+		rbridge_forgetCachedColumns(colsChanged);
+		rbridge_forgetCachedColumns(colsRemoved);
+
+		for(const stringvec & cols : { colsChanged, colsRemoved })
+			for(const std::string & col : cols)
+				_columnFingerprints.erase(col);
+	}
 
 	if(_dataSet && setColumnNames)
 		ColumnEncoder::columnEncoder()->setCurrentNames(_dataSet->getColumnNames(), true);
@@ -1041,7 +1232,7 @@ void Engine::sendEngineStopped()
 {
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(_engineState);
-	sendString(rCodeResponse.toStyledString());
+	sendMessage(rCodeResponse);
 }
 
 void Engine::pauseEngine(const Json::Value & json)
@@ -1062,6 +1253,8 @@ void Engine::pauseEngine(const Json::Value & json)
 	freeRBridgeColumns();
 	if(json.get("unloadData", false).asBool())
 	{
+		rbridge_forgetAllCachedColumns();
+		_columnFingerprints.clear();
 		delete _dataSet;
 		_dataSet = nullptr;
 	}
@@ -1100,7 +1293,7 @@ void Engine::sendEnginePaused()
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(engineState::paused);
 
-	sendString(rCodeResponse.toStyledString());
+	sendMessage(rCodeResponse);
 }
 
 void Engine::reloadColumnNames()
@@ -1127,7 +1320,7 @@ void Engine::sendEngineResumed(bool justReloadedData)
 	response["typeRequest"]			= engineStateToString(engineState::resuming);
 	response["justReloadedData"]	= justReloadedData;
 
-	sendString(response.toStyledString());
+	sendMessage(response);
 }
 
 void Engine::sendEngineLoadingData()
@@ -1137,7 +1330,7 @@ void Engine::sendEngineLoadingData()
 	Json::Value response	= Json::objectValue;
 	response["typeRequest"]	= engineStateToString(engineState::reloadData);
 
-	sendString(response.toStyledString());
+	sendMessage(response);
 }
 
 void Engine::receiveLogCfg(const Json::Value & jsonRequest)
@@ -1152,7 +1345,7 @@ void Engine::receiveLogCfg(const Json::Value & jsonRequest)
 	Json::Value logCfgResponse		= Json::objectValue;
 	logCfgResponse["typeRequest"]	= engineStateToString(engineState::logCfg);
 
-	sendString(logCfgResponse.toStyledString());
+	sendMessage(logCfgResponse);
 
 	_engineState = engineState::idle;
 }
@@ -1191,7 +1384,7 @@ void Engine::receiveSettings(const Json::Value & jsonRequest)
 	Json::Value response	= Json::objectValue;
 	response["typeRequest"]	= engineStateToString(engineState::settings);
 
-	sendString(response.toStyledString());
+	sendMessage(response);
 
 	_engineState = engineState::idle;
 }
@@ -23,6 +23,7 @@
 #include "ipcchannel.h"
 #include <json/json.h>
 #include "columnencoder.h"
+#include "resultcache.h"
 
 /// The Engine handles communication between Desktop and R
 /// It can be in a variety of states _currentEngineState and can run analyses, filters, compute columns and Rcode.
@@ -41,6 +42,7 @@ public:
 	void					setSlaveNo(int no);
 	int						engineNum() const { return _engineNum; }
 	void					sendString(std::string message);
+	void					sendMessage(Json::Value message);	///< Decodes the columnnames in message and sends it with the codec of the channel, intermediate results go as a patch where possible
 
 	
 
@@ -53,6 +55,7 @@ public:
 	std::string				createColumn(			const std::string & columnName); ///< Returns encoded columnname on success or "" on failure (cause it already exists)
 	bool					deleteColumn(			const std::string & columnName);
 	bool					setColumnDataAndType(	const std::string & columnName, const	std::vector<std::string>	& nominalData, columnType colType); ///< return true for any changes
+	bool					setColumnDataAndType(	const std::string & columnName, const	doublevec & dbls, const intvec & levelIndices, const stringvec & levels, columnType colType); ///< Typed version of the above, see Column::overwriteDataAndType
 	bool					isColumnNameOk(			const std::string & columnName);
 	int						dataSetRowCount()		{ return static_cast<int>(provideAndUpdateDataSet()->rowCount()); }
 	bool					paused()				{ return _engineState == engineState::paused; }
@@ -81,6 +84,9 @@ private:
 	void 					updateOptionsAccordingToMeta(					  Json::Value & options);
 
 	void					runAnalysis();
+	std::string				analysisCacheKey(const Json::Value & options);	///< Empty if the results of the current analysis cannot be cached
+	const std::string	&	columnFingerprint(Column * column, Filter * filter);	///< ResultCache::Hasher::addColumn of column in a hash of its own, only recomputed when the column or filter changed
+	bool					sendCachedAnalysisResults(const std::string & cacheKey);
 	void					runComputeColumn(	const std::string & computeColumnName,	const std::string & computeColumnCode,	columnType computeColumnType	);
 	void					runFilter(			const std::string & filter,				const std::string & generatedFilter,	int filterRequestId				);
 	void 					runFilterByName(	const std::string & name);
@@ -101,6 +107,7 @@ private:
 	void					removeNonKeepFiles(const Json::Value & filesToKeepValue);
 
 	void					sendAnalysisResults();
+	void					patchAnalysisResults(Json::Value & msgJson);	///< Numbers the results in msgJson and replaces them by a JsonUtilities::jsonPatch against the previous ones where possible
 	void					sendFilterByNameDone(	const std::string & name, const std::string & errorMessage);
 	void					sendFilterResult(		int filterRequestId);
 	void					sendFilterError(		int filterRequestId,	const std::string & errorMessage);
@@ -108,6 +115,13 @@ private:
 	void					sendRCodeError(			int rCodeRequestId);
 
 private: // Data:
+	struct ColumnFingerprint
+	{
+		int			columnRevision,
+					filterRevision;
+		std::string	hash;
+	};
+
 	static Engine				*	_EngineInstance;
 	const int						_engineNum;
 	const unsigned long				_parentPID;
@@ -115,11 +129,16 @@ private: // Data:
 	DatabaseInterface			*	_db						= nullptr;
 	IPCChannel					*	_channel				= nullptr;
 	ColumnEncoder				*	_extraEncodings			= nullptr;
+	ResultCache					*	_resultCache			= nullptr;
 	engineState						_engineState			= engineState::initializing,
 									_lastRequest			= engineState::initializing;
 	Status							_analysisStatus			= Status::empty;
 	int								_analysisId,
 									_analysisRevision,
+									_resultsSentId			= -1,	///< _resultsSent* are what EngineRepresentation has of the results of the running analysis, so changes can be sent as a patch
+									_resultsSentRevision	= -1,
+									_resultsSentSequence	= 0,
+									_resultsPatchesInARow	= 0,
 									_progress,
 									_ppi					= 96,
 									_numDecimals			= 3;
@@ -127,7 +146,8 @@ private: // Data:
 									_fixedDecimals			= false,
 									_exactPValues			= false,
 									_normalizedNotation		= true,
-									_analysisPreloadData;
+									_analysisPreloadData,
+									_analysisChangedData	= false; ///< Set when R creates or changes a column, such a run should not be taken from the cache
 	std::string						_analysisName,
 									_analysisTitle,
 									_analysisDataKey,
@@ -137,12 +157,16 @@ private: // Data:
 									_resultFont,
 									_imageBackground		= "white",
 									_analysisRFile			= "",
+									_analysisModuleVersion	= "",
 									_dynamicModuleCall		= "",
 									_langR					= "en";
 	Json::Value						_imageOptions,
 									_analysisOptions		= Json::nullValue,
-									_analysisResults;
+									_analysisResults,
+									_analysisCompleteResults,	///< The last "complete" message jaspResults sent for the running analysis
+									_resultsSent;
 	ColumnEncoder::colsPlusTypes	_analysisColsTypes;
+	std::map<std::string, ColumnFingerprint>	_columnFingerprints;	///< Per column name, so analysisCacheKey doesn't have to go through all the data of every column each run
 
 
 };
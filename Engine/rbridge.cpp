@@ -27,6 +27,8 @@
 #include "engine.h"
 #include "r_functionwhitelist.h"
 #include <sstream>
+#include <tuple>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -104,6 +106,8 @@ void rbridge_init(Engine * engine, sendFuncDef sendToDesktopFunction, pollMessag
 		rbridge_deleteColumn,
 		rbridge_getColumnAnalysisId,
 		rbridge_setColumnDataAndType,
+		rbridge_setColumnDoubles,
+		rbridge_setColumnFactor,
 		rbridge_dataSetRowCount,
 		rbridge_encodeColumnName,
 		rbridge_decodeColumnName,
@@ -358,6 +362,148 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSetForFiltering(size_t * colMa
 static RBridgeColumn*	datasetStatic = nullptr;
 static int				datasetColMax = 0;
 
+/// What rbridge_readDataSet made out of a column, kept until the column or filter changes so the next analysis on the same variables gets it as is.
+/// jaspRCPP keeps the R vector it made of it under the same cacheStamp, rbridge_freeCachedColumn tells it to forget that.
+/// Once all of them together take more than columnCacheMaxBytes the least recently read ones are forgotten, see rbridge_evictCachedColumns.
+struct RBridgeCachedColumn
+{
+	RBridgeColumn	column			= {};
+	int				dataSetId		= -1,
+					columnRevision	= -1,
+					filterRevision	= -1;
+	size_t			bytes			= 0,
+					lastUsed		= 0;
+};
+
+typedef std::tuple<std::string, columnType, bool> RBridgeColumnCacheKey; ///< column name, requested type and whether it obeys the filter
+
+static std::map<RBridgeColumnCacheKey, RBridgeCachedColumn>	columnCache;
+static int													columnCacheStamp	= 0;
+static size_t												columnCacheBytes	= 0,
+															columnCacheUses		= 0;
+static const size_t											columnCacheMaxBytes	= 256 * 1024 * 1024; ///< jaspRCPP keeps an R vector of the same size for each of them, so it takes about twice this
+
+void rbridge_freeCachedColumn(RBridgeColumn & column)
+{
+	if(column.cacheStamp != 0)
+		jaspRCPP_forgetCachedColumn(column.cacheStamp);
+
+	free(column.doubles);
+	free(column.ints);
+
+	if (!column.isScale)
+		freeLabels(column.labels, column.nbLabels);
+
+	column = {};
+}
+
+void rbridge_freeCachedColumn(RBridgeCachedColumn & cached)
+{
+	rbridge_freeCachedColumn(cached.column);
+
+	columnCacheBytes	-= cached.bytes;
+	cached.bytes		 = 0;
+}
+
+void rbridge_forgetCachedColumns(const stringvec & columnNames)
+{
+	for(auto cached = columnCache.begin(); cached != columnCache.end(); )
+		if(std::find(columnNames.begin(), columnNames.end(), std::get<0>(cached->first)) == columnNames.end())
+			cached++;
+		else
+		{
+			rbridge_freeCachedColumn(cached->second);
+			cached = columnCache.erase(cached);
+		}
+}
+
+void rbridge_forgetAllCachedColumns()
+{
+	for(auto & cached : columnCache)
+		rbridge_freeCachedColumn(cached.second.column);
+
+	columnCache.clear();
+	columnCacheBytes = 0;
+	jaspRCPP_forgetAllCachedColumns();
+}
+
+///Only call this when none of the cached columns are handed out in datasetStatic
+void rbridge_evictCachedColumns()
+{
+	while(columnCacheBytes > columnCacheMaxBytes && !columnCache.empty())
+	{
+		auto leastRecent = std::min_element(columnCache.begin(), columnCache.end(), [](const auto & l, const auto & r) { return l.second.lastUsed < r.second.lastUsed; });
+
+		rbridge_freeCachedColumn(leastRecent->second);
+		columnCache.erase(leastRecent);
+	}
+}
+
+const RBridgeColumn & rbridge_cachedColumn(const std::string & columnName, Column * column, columnType requestedType, bool obeyFilter)
+{
+	RBridgeCachedColumn	&	cached			= columnCache[{columnName, requestedType, obeyFilter}];
+	RBridgeColumn		&	resultCol		= cached.column;
+	int						filterRevision	= obeyFilter ? rbridge_dataSet->filter()->revision() : -1;
+
+	cached.lastUsed = ++columnCacheUses;
+
+	if(		resultCol.cacheStamp	!= 0
+		&&	cached.dataSetId		== rbridge_dataSet->id()
+		&&	cached.columnRevision	== column->revision()
+		&&	cached.filterRevision	== filterRevision)
+		return resultCol;
+
+	JASPTIMER_SCOPE(rbridge_cachedColumn rebuild);
+
+	rbridge_freeCachedColumn(cached);
+
+	size_t	filteredRowCount	= obeyFilter ? rbridge_dataSet->filter()->filteredRowCount() : rbridge_dataSet->rowCount();
+	boolvec	filterToUse;
+
+	if(obeyFilter)
+		filterToUse = rbridge_dataSet->filter()->filtered();
+
+	resultCol.nbRows = filteredRowCount;
+
+	if (requestedType == columnType::scale)
+	{
+		int rowNo = 0;
+
+		resultCol.isScale	= true;
+		resultCol.doubles	= (double*)calloc(filteredRowCount, sizeof(double));
+
+		for(double value : column->dataAsRDoubles(filterToUse))
+			resultCol.doubles[rowNo++] = value;
+	}
+	else // if (requestedType != ColumnType::scale)
+	{
+		resultCol.isScale	= false;
+		resultCol.ints		= filteredRowCount == 0 ? nullptr : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
+		resultCol.isOrdinal = (requestedType == columnType::ordinal);
+
+		intvec		vals;
+		stringvec	levels = column->dataAsRLevels(vals, filterToUse, true);
+
+		for(size_t i=0; i<vals.size(); i++)
+			resultCol.ints[i] = vals[i] == EmptyValues::missingValueInteger ? vals[i] : vals[i] + 1; //R chokes on 0-based indices
+
+		resultCol.labels = rbridge_getLabels(levels, resultCol.nbLabels);
+
+		for(const std::string & level : levels)
+			cached.bytes += level.size() + 1;
+	}
+
+	cached.bytes		+= filteredRowCount * (resultCol.isScale ? sizeof(double) : sizeof(int));
+	columnCacheBytes	+= cached.bytes;
+
+	resultCol.cacheStamp	= ++columnCacheStamp;
+	cached.dataSetId		= rbridge_dataSet->id();
+	cached.columnRevision	= column->revision();
+	cached.filterRevision	= filterRevision;
+
+	return resultCol;
+}
+
 extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHeaders, size_t colMax, bool obeyFilter)
 {
 	if (colHeaders == nullptr)
@@ -373,6 +519,8 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 	if (datasetStatic != nullptr)
 		freeRBridgeColumns();
 
+	rbridge_evictCachedColumns(); //Nothing of the cache is handed out now
+
 	datasetColMax = colMax;
 	datasetStatic = static_cast<RBridgeColumn*>(calloc(datasetColMax + 1, sizeof(RBridgeColumn)));
 
@@ -398,48 +546,15 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 		RBridgeColumnType	&	columnInfo		= colHeaders[colNo];
 		RBridgeColumn		&	resultCol		= datasetStatic[colNo];
 		std::string				columnName		= ColumnEncoder::columnEncoder()->decode(columnInfo.name);
-								resultCol.name	= strdup(columnInfo.name);
 		Column				*	column			= rbridge_dataSet->column(columnName);
-		columnType				colType			= column->type(),
-								requestedType	= columnType(columnInfo.type);
+		columnType				requestedType	= columnType(columnInfo.type);
 
 		if (requestedType == columnType::unknown)
-			requestedType = colType;
+			requestedType = column->type();
 
-		resultCol.nbRows = filteredRowCount;
-		
-		if (requestedType == columnType::scale)
-		{
-			int rowNo = 0;
-					
-			resultCol.isScale	= true;
-			resultCol.doubles	= (double*)calloc(filteredRowCount, sizeof(double));
-			
-			boolvec filterToUse;
-			if(obeyFilter)
-				filterToUse = rbridge_dataSet->filter()->filtered();
-
-			for(double value : column->dataAsRDoubles(filterToUse))
-				resultCol.doubles[rowNo++] = value;
-		}
-		else // if (requestedType != ColumnType::scale)
-		{
-			resultCol.isScale	= false;
-			resultCol.ints		= filteredRowCount == 0 ? nullptr : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
-			resultCol.isOrdinal = (requestedType == columnType::ordinal);
-			
-			intvec vals;
-			boolvec filterToUse;
-			if(obeyFilter)
-				filterToUse = rbridge_dataSet->filter()->filtered();
-			
-			stringvec levels = column->dataAsRLevels(vals, filterToUse, true);
-			
-			for(size_t i=0; i<vals.size(); i++)
-				resultCol.ints[i] = vals[i] == EmptyValues::missingValueInteger ? vals[i] : vals[i] + 1; //R chokes on 0-based indices
-
-			resultCol.labels = rbridge_getLabels(levels, resultCol.nbLabels);
-		}
+		//The buffers belong to the cache, only the name is ours
+		resultCol		= rbridge_cachedColumn(columnName, column, requestedType, obeyFilter);
+		resultCol.name	= strdup(columnInfo.name);
 	}
 
 	return datasetStatic;
@@ -590,6 +705,28 @@ extern "C" bool STDCALL rbridge_setColumnDataAndType(const char* columnName, con
 	return rbridge_engine->setColumnDataAndType(colName, nominals, columnType(_columnType));
 }
 
+extern "C" bool STDCALL rbridge_setColumnDoubles(const char* columnName, const double * doubles, size_t length, int _columnType)
+{
+	JASP_COLUMN_DECODE_HERE_STORED_colName;
+
+	return rbridge_engine->setColumnDataAndType(colName, doublevec(doubles, doubles + length), {}, {}, columnType(_columnType));
+}
+
+extern "C" bool STDCALL rbridge_setColumnFactor(const char* columnName, const int * levelCodes, size_t length, const char ** levels, size_t numLevels, int _columnType)
+{
+	JASP_COLUMN_DECODE_HERE_STORED_colName;
+
+	//R counts levels from 1 and anything outside of them (like NA_INTEGER) is missing
+	doublevec	dbls(length, EmptyValues::missingValueDouble);
+	intvec		levelIndices(length, -1);
+
+	for(size_t row=0; row<length; row++)
+		if(levelCodes[row] >= 1 && size_t(levelCodes[row]) <= numLevels)
+			levelIndices[row] = levelCodes[row] - 1;
+
+	return rbridge_engine->setColumnDataAndType(colName, dbls, levelIndices, stringvec(levels, levels + numLevels), columnType(_columnType));
+}
+
 extern "C" int	STDCALL rbridge_dataSetRowCount()
 {
 	return rbridge_engine->dataSetRowCount();
@@ -607,15 +744,7 @@ void freeRBridgeColumns()
 		return;
 
 	for (int i = 0; i < datasetColMax; i++)
-	{
-		RBridgeColumn& column = datasetStatic[i];
-		free(column.name);
-		if (column.isScale)	free(column.doubles);
-		else				free(column.ints);
-
-		if (!column.isScale)
-			freeLabels(column.labels, column.nbLabels);
-	}
+		free(datasetStatic[i].name); //The rest is owned by columnCache
 	free(datasetStatic[datasetColMax].ints); //rownames/numbers
 	free(datasetStatic);
 
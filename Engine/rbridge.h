@@ -63,6 +63,8 @@ extern "C" {
 	const char *				STDCALL rbridge_createColumn			(const char * columnName);
 	bool						STDCALL rbridge_deleteColumn			(const char * columnName);
 	bool						STDCALL rbridge_setColumnDataAndType	(const char* columnName, const char **	nominalData,	size_t length,	int columnType);
+	bool						STDCALL rbridge_setColumnDoubles		(const char* columnName, const double *	doubles,		size_t length,	int columnType);
+	bool						STDCALL rbridge_setColumnFactor			(const char* columnName, const int *	levelCodes,		size_t length,	const char ** levels, size_t numLevels, int columnType);
 	int							STDCALL rbridge_dataSetRowCount();
 	const char *				STDCALL rbridge_encodeColumnName(		const char * in);
 	const char *				STDCALL rbridge_decodeColumnName(		const char * in);
@@ -91,6 +93,8 @@ extern "C" {
 	void	rbridge_detachRCodeEnv(				const std::string & dataname = "data");
 
 	void freeRBridgeColumns();
+	void rbridge_forgetCachedColumns(const stringvec & columnNames);	///< Whatever is kept for R of these columns is rebuilt the next time they are read
+	void rbridge_forgetAllCachedColumns();
 	void freeRBridgeColumnDescription(RBridgeColumnDescription* columns, size_t colMax);
 	void freeLabels(char** labels, size_t nbLabels);
 
@@ -0,0 +1,278 @@
+#include "resultcache.h"
+#include "column.h"
+#include "tempfiles.h"
+#include "timers.h"
+#include "log.h"
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+const std::string ResultCache::_resultsFile = "results.json";
+
+static inline uint64_t murmurRotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t murmurFmix(uint64_t k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return k;
+}
+
+static const uint64_t murmurC1 = 0x87c37b91114253d5ULL,
+					  murmurC2 = 0x4cf5ad432745937fULL;
+
+void ResultCache::Hasher::_mixBlock(const unsigned char * block)
+{
+	uint64_t k1, k2;
+	memcpy(&k1, block,		sizeof(uint64_t));
+	memcpy(&k2, block + 8,	sizeof(uint64_t));
+
+	k1 *= murmurC1; k1 = murmurRotl(k1, 31); k1 *= murmurC2; _h1 ^= k1;
+	_h1 = murmurRotl(_h1, 27); _h1 += _h2; _h1 = _h1 * 5 + 0x52dce729;
+
+	k2 *= murmurC2; k2 = murmurRotl(k2, 33); k2 *= murmurC1; _h2 ^= k2;
+	_h2 = murmurRotl(_h2, 31); _h2 += _h1; _h2 = _h2 * 5 + 0x38495ab5;
+}
+
+void ResultCache::Hasher::add(const void * data, size_t bytes)
+{
+	const unsigned char * bytesIn = static_cast<const unsigned char *>(data);
+
+	_length += bytes;
+
+	if(_tailUsed > 0)
+	{
+		size_t fill = std::min(bytes, sizeof(_tail) - _tailUsed);
+		memcpy(_tail + _tailUsed, bytesIn, fill);
+
+		_tailUsed	+= fill;
+		bytesIn		+= fill;
+		bytes		-= fill;
+
+		if(_tailUsed < sizeof(_tail))
+			return;
+
+		_mixBlock(_tail);
+		_tailUsed = 0;
+	}
+
+	for(; bytes >= sizeof(_tail); bytesIn += sizeof(_tail), bytes -= sizeof(_tail))
+		_mixBlock(bytesIn);
+
+	memcpy(_tail, bytesIn, bytes);
+	_tailUsed = bytes;
+}
+
+void ResultCache::Hasher::add(const std::string & text)
+{
+	//Include the length so that "ab" + "c" differs from "a" + "bc"
+	add(int(text.size()));
+	add(text.data(), text.size());
+}
+
+void ResultCache::Hasher::addColumn(Column * column, const boolvec & filter)
+{
+	JASPTIMER_SCOPE(ResultCache::Hasher::addColumn);
+
+	add(column->name());
+	add(int(column->type()));
+
+	for(double value : column->dataAsRDoubles(filter))
+		add(value);
+
+	intvec		levelIndices;
+	stringvec	levels = column->dataAsRLevels(levelIndices, filter, true);
+
+	for(const std::string & level : levels)
+		add(level);
+
+	add(levelIndices.data(), levelIndices.size() * sizeof(int));
+
+	//R can also ask for the values instead of the labels
+	for(const Label * label : column->labels())
+		add(label->originalValueAsString());
+}
+
+std::string ResultCache::Hasher::hex() const
+{
+	//Finalize a copy, so more can still be added afterwards
+	uint64_t		h1 = _h1,
+					h2 = _h2,
+					k1 = 0,
+					k2 = 0;
+	unsigned char	tail[16] = {0};
+
+	memcpy(tail, _tail, _tailUsed);
+	memcpy(&k1, tail,		sizeof(uint64_t));
+	memcpy(&k2, tail + 8,	sizeof(uint64_t));
+
+	if(_tailUsed > 8)	{ k2 *= murmurC2; k2 = murmurRotl(k2, 33); k2 *= murmurC1; h2 ^= k2; }
+	if(_tailUsed > 0)	{ k1 *= murmurC1; k1 = murmurRotl(k1, 31); k1 *= murmurC2; h1 ^= k1; }
+
+	h1 ^= _length;
+	h2 ^= _length;
+
+	h1 += h2;
+	h2 += h1;
+
+	h1 = murmurFmix(h1);
+	h2 = murmurFmix(h2);
+
+	h1 += h2;
+	h2 += h1;
+
+	std::stringstream out;
+	out << std::hex << std::setfill('0') << std::setw(16) << h1 << std::setw(16) << h2;
+	return out.str();
+}
+
+ResultCache::ResultCache(const std::string & cacheDir, size_t maxBytes, size_t maxEntries)
+	: _cacheDir(cacheDir), _maxBytes(maxBytes), _maxEntries(maxEntries)
+{
+	std::error_code error;
+	std::filesystem::create_directories(Utils::osPath(_cacheDir), error);
+
+	if(error)
+		Log::log() << "ResultCache could not create '" << _cacheDir << "': " << error.message() << std::endl;
+}
+
+bool ResultCache::restore(const std::string & key, int analysisId, Json::Value & results)
+{
+	JASPTIMER_SCOPE(ResultCache::restore);
+
+	std::error_code			error;
+	std::filesystem::path	entry		= Utils::osPath(_cacheDir + "/" + key),
+							resultsPath	= entry / _resultsFile;
+
+	if(!std::filesystem::exists(resultsPath, error))
+		return false;
+
+	std::ifstream resultsIn(resultsPath);
+
+	if(!resultsIn || !Json::Reader().parse(resultsIn, results, false))
+		return false;
+
+	std::filesystem::path resources = Utils::osPath(TempFiles::sessionDirName() + "/resources/" + std::to_string(analysisId));
+
+	TempFiles::deleteList(TempFiles::retrieveList(analysisId));
+	std::filesystem::create_directories(resources, error);
+
+	for(const auto & file : std::filesystem::directory_iterator(entry, error))
+		if(file.path().filename() != _resultsFile && !std::filesystem::copy_file(file.path(), resources / file.path().filename(), std::filesystem::copy_options::overwrite_existing, error))
+			break;
+
+	if(error)
+	{
+		Log::log() << "ResultCache could not restore the files of entry " << key << ": " << error.message() << std::endl;
+		return false;
+	}
+
+	//This is what makes it the most recently used
+	std::filesystem::last_write_time(resultsPath, std::filesystem::file_time_type::clock::now(), error);
+
+	return true;
+}
+
+void ResultCache::store(const std::string & key, int analysisId, const Json::Value & results)
+{
+	JASPTIMER_SCOPE(ResultCache::store);
+
+	std::error_code			error;
+	std::filesystem::path	entry		= Utils::osPath(_cacheDir + "/" + key),
+							writing		= Utils::osPath(_cacheDir + "/" + key + ".writing" + std::to_string(TempFiles::sessionId()) + "_" + std::to_string(analysisId));
+
+	if(std::filesystem::exists(entry, error))
+		return;
+
+	std::filesystem::remove_all(writing, error);
+	std::filesystem::create_directories(writing, error);
+
+	for(const std::string & file : TempFiles::retrieveList(analysisId))
+	{
+		std::filesystem::path source = Utils::osPath(TempFiles::sessionDirName() + "/" + file);
+		std::filesystem::copy_file(source, writing / source.filename(), error);
+
+		if(error)
+			break;
+	}
+
+	if(!error)
+	{
+		std::ofstream resultsOut(writing / _resultsFile);
+		resultsOut << results.toStyledString();
+	}
+
+	//Another engine might have stored the same results in the meantime, in that case the rename fails and that's fine
+	if(!error)
+		std::filesystem::rename(writing, entry, error);
+
+	if(error)
+	{
+		std::error_code ignore;
+		std::filesystem::remove_all(writing, ignore);
+		return;
+	}
+
+	_evict();
+}
+
+void ResultCache::_evict()
+{
+	JASPTIMER_SCOPE(ResultCache::_evict);
+
+	struct Entry
+	{
+		std::filesystem::path				path;
+		std::filesystem::file_time_type		lastUsed;
+		size_t								bytes = 0;
+	};
+
+	std::vector<Entry>	entries;
+	size_t				totalBytes = 0;
+	std::error_code		error;
+
+	for(const auto & dir : std::filesystem::directory_iterator(Utils::osPath(_cacheDir), error))
+	{
+		if(!dir.is_directory(error) || !std::filesystem::exists(dir.path() / _resultsFile, error))
+			continue;
+
+		Entry entry;
+		entry.path		= dir.path();
+		entry.lastUsed	= std::filesystem::last_write_time(dir.path() / _resultsFile, error);
+
+		for(const auto & file : std::filesystem::directory_iterator(dir.path(), error))
+			entry.bytes += file.file_size(error);
+
+		totalBytes += entry.bytes;
+		entries.push_back(entry);
+	}
+
+	if(totalBytes <= _maxBytes && entries.size() <= _maxEntries)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const Entry & l, const Entry & r) { return l.lastUsed < r.lastUsed; });
+
+	size_t entriesLeft = entries.size();
+
+	for(const Entry & entry : entries)
+	{
+		if(totalBytes <= _maxBytes && entriesLeft <= _maxEntries)
+			break;
+
+		std::filesystem::remove_all(entry.path, error);
+
+		totalBytes -= entry.bytes;
+		entriesLeft--;
+	}
+
+	Log::log() << "ResultCache evicted " << (entries.size() - entriesLeft) << " entries, " << entriesLeft << " left taking " << totalBytes << " bytes." << std::endl;
+}
@@ -0,0 +1,58 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <json/json.h>
+#include <cstdint>
+#include "utils.h"
+
+class Column;
+
+///
+/// Remembers the final results of analyses on disk, together with the files (plots, state etc) they left in their TempFiles resources folder.
+/// This means an analysis that gets refreshed with the same options on the same data (after undo/redo, reopening a jasp-file or a filter switching back) can skip R entirely.
+///
+/// Entries are stored in a folder per key, the key is built with a Hasher by the Engine from everything that determines the outcome of the analysis.
+/// Several engines share the same folder, so entries are written elsewhere first and then renamed into place.
+/// When the cache grows beyond maxBytes or maxEntries the least recently used entries are removed, restore() counts as a use.
+class ResultCache
+{
+public:
+	///MurmurHash3 x64 128 bits over everything added, streamed in blocks of 16 bytes so nothing needs to be kept around
+	class Hasher
+	{
+	public:
+		void			add(const std::string & text);
+		void			add(const void * data, size_t bytes);
+		void			add(double value)	{ add(&value, sizeof(double));	}
+		void			add(int value)		{ add(&value, sizeof(int));		}
+
+		void			addColumn(Column * column, const boolvec & filter);	///< Adds exactly what R would get from this column after filtering
+
+		std::string		hex() const;
+
+	private:
+		void			_mixBlock(const unsigned char * block);
+
+		uint64_t		_h1			= 0,
+						_h2			= 0,
+						_length		= 0;
+		unsigned char	_tail[16];
+		size_t			_tailUsed	= 0;	///< Bytes added since the last complete block
+	};
+
+					ResultCache(const std::string & cacheDir, size_t maxBytes = 512 * 1024 * 1024, size_t maxEntries = 2000);
+
+	bool			restore(const std::string & key, int analysisId,	Json::Value			& results);	///< Copies the files of the entry back into the resources of analysisId and returns true if there was one
+	void			store(	const std::string & key, int analysisId,	const Json::Value	& results);	///< Stores results together with all files currently in the resources of analysisId
+
+private:
+	void			_evict();
+
+	static const std::string	_resultsFile;
+
+	const std::string			_cacheDir;
+	const size_t				_maxBytes,
+								_maxEntries;
+};
+
+#endif // RESULTCACHE_H
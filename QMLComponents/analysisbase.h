@@ -20,6 +20,7 @@ public:
 
 	virtual				bool				isOwnComputedColumn(const std::string &col)					const	{ return false; }
 	virtual				void				refresh()															{}
+	virtual				void				refreshForColumns(const QStringList & columns)						{ refresh(); }	///< Only refreshes if the analysis depends on one of these columns
 	virtual				void				run()																{}
 	virtual				void				reloadForm()														{}
 	virtual				void				exportResults()														{}
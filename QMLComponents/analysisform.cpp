@@ -83,6 +83,11 @@ void AnalysisForm::refreshAnalysis()
 	_analysis->refresh();
 }
 
+void AnalysisForm::refreshAnalysisForColumns(const QStringList & columns)
+{
+	_analysis->refreshForColumns(columns);
+}
+
 QString AnalysisForm::generateWrapper() const
 {
 	return _rSyntax->generateWrapper();
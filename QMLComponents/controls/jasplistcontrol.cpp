@@ -346,9 +346,11 @@ bool JASPListControl::_checkLevelsConstraintsForVariable(const QString& variable
 	if (type == columnType::unknown)
 		return true;
 
-	int nbLevels			= model()->requestInfo(VariableInfo::TotalLevels, variable).toInt(),
-		nbNumValues			= model()->requestInfo(VariableInfo::TotalNumericValues, variable).toInt(),
-		maxScaleLevels		= PreferencesModelBase::preferences()->maxScaleLevels();
+	//Both counts come from the same statistics of the column, a provider that does not have those can still give them one by one
+	QVariantMap	stats			= model()->requestInfo(VariableInfo::Statistics, variable).toMap();
+	int			nbLevels		= stats.isEmpty() ? model()->requestInfo(VariableInfo::TotalLevels,			variable).toInt() : stats["levels"].toInt(),
+				nbNumValues		= stats.isEmpty() ? model()->requestInfo(VariableInfo::TotalNumericValues,	variable).toInt() : stats["numerics"].toInt(),
+				maxScaleLevels	= PreferencesModelBase::preferences()->maxScaleLevels();
 	bool noScaleAllowed		= !_allowedTypesModel->hasType(columnType::scale);
 
 	if (_minLevels >= 0 && nbLevels < _minLevels)
@@ -706,7 +706,7 @@ void ListModel::sourceColumnsChanged(QStringList columns)
 		emit columnsChanged(changedColumns);
 
 		if (listView()->isBound())
-			listView()->form()->refreshAnalysis();
+			listView()->form()->refreshAnalysisForColumns(changedColumns);
 	}
 }
 
@@ -42,6 +42,8 @@ CreateColumn					dataSetCreateColumn;
 DeleteColumn					dataSetDeleteColumn;
 GetColumnType					dataSetGetColumnType;
 SetColumnDataAndType			dataSetColumnDataAndType;
+SetColumnDoubles				dataSetColumnDoubles;
+SetColumnFactor					dataSetColumnFactor;
 GetColumnAnalysisId				dataSetGetColumnAnalysisId;
 
 EnDecodeDef						encodeColumnName,
@@ -92,6 +94,8 @@ void STDCALL jaspRCPP_init(const char* buildYear, const char* version, RBridgeCa
 	requestJaspResultsFileSourceCB				= callbacks->requestJaspResultsFileSourceCB;
 	dataSetGetColumnAnalysisId					= callbacks->dataSetGetColumnAnalysisId;
 	dataSetColumnDataAndType					= callbacks->dataSetColumnAsDataAndType;
+	dataSetColumnDoubles						= callbacks->dataSetColumnAsDoubles;
+	dataSetColumnFactor							= callbacks->dataSetColumnAsFactor;
 	requestSpecificFileNameCB					= callbacks->requestSpecificFileNameCB;
 	readFullFilteredDataSetCB					= callbacks->readFullFilteredDataSetCB;
 	requestStateFileSourceCB					= callbacks->requestStateFileSourceCB;
@@ -829,7 +833,30 @@ bool _jaspRCPP_setColumnDataAndType(const std::string & columnName, Rcpp::RObjec
 {
 	static Rcpp::Function asNumeric("as.numeric");
 	static Rcpp::Function asCharacter("as.character");
-	
+
+	if(Rf_isNull(data))
+		return dataSetColumnDoubles(columnName.c_str(), nullptr, 0, int(colType));
+
+	//Factors and plain numbers are passed on as they are, only anything else goes through strings:
+	if(Rf_isFactor(data))
+	{
+		Rcpp::IntegerVector		codes(data);
+		Rcpp::CharacterVector	levelsR(Rf_getAttrib(data, R_LevelsSymbol));
+		stringvec				levels(levelsR.begin(), levelsR.end());
+		std::vector<const char*>levelPointers(levels.size());
+
+		for(size_t i=0; i<levels.size(); i++)
+			levelPointers[i] = levels[i] == "TRUE" ? "1" : levels[i] == "FALSE" ? "0" : levels[i].c_str();
+
+		return dataSetColumnFactor(columnName.c_str(), codes.begin(), codes.size(), levelPointers.data(), levelPointers.size(), int(colType));
+	}
+
+	if((Rf_isReal(data) || Rf_isInteger(data) || Rf_isLogical(data)) && !Rf_isObject(data))
+	{
+		Rcpp::NumericVector dbls(asNumeric(Rcpp::_["x"] = data));
+		return dataSetColumnDoubles(columnName.c_str(), dbls.begin(), dbls.size(), int(colType));
+	}
+
 	Rcpp::Vector<STRSXP>	strData = Rf_isNull(data) ? Rcpp::CharacterVector()	: Rcpp::CharacterVector(asCharacter(Rcpp::_["x"] = data));
 	Rcpp::Vector<REALSXP>	dblData = Rf_isNull(data) ? Rcpp::NumericVector()	: Rcpp::NumericVector(	asNumeric(	Rcpp::_["x"] = data));
 	
@@ -847,7 +874,11 @@ bool _jaspRCPP_setColumnDataAndType(const std::string & columnName, Rcpp::RObjec
 					: (!isLgl	? convertedStrings[i].c_str() : convertedStrings[i] == "TRUE" ? "1" : "0"); //Also getting TRUE or FALSE is not ideal
 	}
 
-	return dataSetColumnDataAndType(columnName.c_str(), nominals, static_cast<size_t>(strData.size()), int(colType));
+	bool changed = dataSetColumnDataAndType(columnName.c_str(), nominals, static_cast<size_t>(strData.size()), int(colType));
+
+	delete[] nominals;
+
+	return changed;
 }
 
 
@@ -1018,6 +1049,19 @@ Rcpp::DataFrame jaspRCPP_readDataSetRequested()
 	return jaspRCPP_convertRBridgeColumns_to_DataFrame(colResults, colMax);
 }
 
+///The R vectors made from the columns rbridge keeps around, by RBridgeColumn::cacheStamp. rbridge tells us when to forget them.
+static std::map<int, Rcpp::RObject> cachedColumns;
+
+void STDCALL jaspRCPP_forgetCachedColumn(int cacheStamp)
+{
+	cachedColumns.erase(cacheStamp);
+}
+
+void STDCALL jaspRCPP_forgetAllCachedColumns()
+{
+	cachedColumns.clear();
+}
+
 Rcpp::DataFrame jaspRCPP_convertRBridgeColumns_to_DataFrame(const RBridgeColumn* colResults, size_t colMax)
 {
 	Rcpp::DataFrame dataFrame = Rcpp::DataFrame();
@@ -1033,9 +1077,26 @@ Rcpp::DataFrame jaspRCPP_convertRBridgeColumns_to_DataFrame(const RBridgeColumn*
 
 			columnNames[i] = colResult.name;
 
-			if (colResult.isScale)			list[i] =						Rcpp::NumericVector(colResult.doubles,	colResult.doubles	+ colResult.nbRows);
-			else							list[i] = jaspRCPP_makeFactor(	Rcpp::IntegerVector(colResult.ints,		colResult.ints		+ colResult.nbRows), colResult.labels, colResult.nbLabels, colResult.isOrdinal);
+			auto cached = colResult.cacheStamp == 0 ? cachedColumns.end() : cachedColumns.find(colResult.cacheStamp);
+
+			if(cached != cachedColumns.end())
+			{
+				list[i] = cached->second;
+				continue;
+			}
+
+			Rcpp::RObject column;
+
+			if (colResult.isScale)			column =						Rcpp::NumericVector(colResult.doubles,	colResult.doubles	+ colResult.nbRows);
+			else							column = jaspRCPP_makeFactor(	Rcpp::IntegerVector(colResult.ints,		colResult.ints		+ colResult.nbRows), colResult.labels, colResult.nbLabels, colResult.isOrdinal);
+
+			if(colResult.cacheStamp != 0)
+			{
+				MARK_NOT_MUTABLE(column); //It ends up in the data of several analyses, so whoever wants to change it should get a copy
+				cachedColumns[colResult.cacheStamp] = column;
+			}
 
+			list[i] = column;
 		}
 
 		list.attr("names")			= columnNames;
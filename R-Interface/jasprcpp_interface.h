@@ -51,6 +51,7 @@ struct RBridgeColumn {
   char**  labels;
   size_t  nbRows;
   size_t  nbLabels;
+  int     cacheStamp; ///< Non-zero when rbridge keeps this column around, the R vector made from it can then be reused for as long as the stamp stays the same
 } ;
 
 struct RBridgeColumnDescription {
@@ -82,6 +83,8 @@ typedef int							(STDCALL *GetColumnAnalysisId)			(const char* columnName);
 typedef const char *				(STDCALL *CreateColumn)					(const char* columnName);
 typedef bool						(STDCALL *DeleteColumn)					(const char* columnName);
 typedef bool						(STDCALL *SetColumnDataAndType)			(const char* columnName, const char **	nominalData,	size_t length, int columnTYpe);
+typedef bool						(STDCALL *SetColumnDoubles)				(const char* columnName, const double *	doubles,		size_t length, int columnType);
+typedef bool						(STDCALL *SetColumnFactor)				(const char* columnName, const int *	levelCodes,		size_t length, const char ** levels, size_t numLevels, int columnType);
 typedef int							(STDCALL *DataSetRowCount)              ();
 typedef const char *				(STDCALL *EnDecodeDef)					(const char *);
 typedef int							(STDCALL *DecodeTypeDef)				(const char *);
@@ -109,6 +112,8 @@ struct RBridgeCallBacks {
 	DeleteColumn					dataSetDeleteColumn;
 	GetColumnAnalysisId				dataSetGetColumnAnalysisId;
 	SetColumnDataAndType			dataSetColumnAsDataAndType;
+	SetColumnDoubles				dataSetColumnAsDoubles;
+	SetColumnFactor					dataSetColumnAsFactor;
 	DataSetRowCount					dataSetRowCount;
 	EnDecodeDef						encoder,
 									decoder,
@@ -150,6 +155,8 @@ RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_getLastErrorMsg();
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_resetErrorMsg();
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_setErrorMsg(const char* msg);
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_purgeGlobalEnvironment();
+RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_forgetCachedColumn(int cacheStamp);
+RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_forgetAllCachedColumns();
 
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_junctionHelper(bool collectNotRestore, const char * modulesFolder, const char * linkFolder, const char * junctionsFilePath);
 
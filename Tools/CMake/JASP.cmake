@@ -146,6 +146,9 @@ endif()
 option(PRINT_ENGINE_MESSAGES
        "Indicates whether the log contains JASPEngine messages" ON)
 
+option(JASP_BINARY_IPC
+       "Whether Engine and Desktop send each other binary messages instead of compact json" OFF)
+
 option(JASP_USES_QT_HERE "Indicates whether some projects are using Qt" ON)
 
 # add_definitions(-DJASP_RESULTS_DEBUG_TRACES)